@@ -53,11 +53,14 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <atomic>
 #include <dcs/algorithm/detail/combperm.hpp>
+#include <dcs/algorithm/detail/parallel_combperm.hpp>
 #include <dcs/detail/macro_cx11.hpp>
 #include <iterator>
 #include <limits>
 #include <stdexcept>
+#include <vector>
 
 
 namespace dcs { namespace algorithm {
@@ -124,6 +127,54 @@ inline
 												   ::std::distance(mid, last));
 }
 
+/**
+ * \brief Returns the positions of the combination of size \a r of \a n
+ *  positions with the given rank, followed by the other positions.
+ *
+ * Combinations are ranked in lexicographic order of their (sorted)
+ * positions, i.e., in the order generated by \c next_combination on the
+ * positions 0,1,...,n-1.
+ * Both the first \a r positions and the remaining ones are sorted.
+ */
+template <typename UIntT>
+::std::vector<UIntT> unrank_combination(UIntT rank, UIntT n, UIntT r)
+{
+	if (r > n || rank >= count_each_combination<UIntT>(r, n-r))
+	{
+		throw ::std::out_of_range("rank out of range in unrank_combination");
+	}
+
+	::std::vector<UIntT> positions;
+	::std::vector<bool> chosen(n, false);
+	UIntT pos = 0;
+	for (UIntT k = r; k > 0; --k)
+	{
+		// Skip the positions whose combinations (i.e., the ones having the
+		// current prefix followed by them) all precede the rank
+		for (;; ++pos)
+		{
+			const UIntT num_combs = count_each_combination<UIntT>(k-1, n-pos-k);
+			if (rank < num_combs)
+			{
+				break;
+			}
+			rank -= num_combs;
+		}
+		positions.push_back(pos);
+		chosen[pos] = true;
+		++pos;
+	}
+	for (UIntT i = 0; i < n; ++i)
+	{
+		if (!chosen[i])
+		{
+			positions.push_back(i);
+		}
+	}
+
+	return positions;
+}
+
 /**
  * \brief Takes a sequence defined by the range [\a first,\a last) such that
  *  [\a first,\a middle) stores a combination, i.e., some sorted subsequence of
@@ -208,6 +259,69 @@ bool prev_combination(BidirectionalIterator first,
 	return detail::next_combination(middle, last, first, middle, comp);
 }
 
+/**
+ * \brief Parallel version of \c for_each_combination.
+ *
+ * Calls \a f for each combination of size \a mid-\a first of the elements
+ * in [\a first,\a last), until \a f returns \c true.
+ * The space of combinations is split into balanced ranges of consecutive
+ * ranks (see \c unrank_combination), which are visited on (at most)
+ * \a num_threads threads (use 0 for the number of hardware threads).
+ * Every range is visited by its own copy of \a f, starting at the
+ * combination unranked from its first rank and then moving through
+ * \c next_combination on positions; thus, unlike \c for_each_combination,
+ * the range [\a first,\a last) is never modified, its elements need not be
+ * sorted, and \a f is called with iterators to a copy of the elements of the
+ * combination (in the order they have in [\a first,\a last)) of type
+ * \c std::vector<value_type>::iterator.
+ * Once all the ranges have been visited, their copies of \a f are folded
+ * into \a f by \c reduce(f,g) (in the order of the ranges or as soon as each
+ * range has been visited, according to \a reduction), and \a f is returned.
+ * Thus the state of a copy of \a f is private to the thread visiting it, and
+ * \a f should start from the identity state of the reduction.
+ * If \a f returns \c true, all the visits stop as soon as possible.
+ */
+template <typename BidirIter, typename Function, typename Reduce>
+Function parallel_for_each_combination(BidirIter first,
+									   BidirIter mid,
+									   BidirIter last,
+									   Function f,
+									   Reduce reduce,
+									   parallel_reduction_category reduction = ordered_parallel_reduction,
+									   ::std::size_t num_threads = 0)
+{
+	typedef typename ::std::iterator_traits<BidirIter>::value_type value_type;
+
+	const ::std::vector<value_type> elems(first, last);
+	const ::std::size_t r = ::std::distance(first, mid);
+	const ::std::size_t n = elems.size();
+
+	return detail::parallel_for_each_rank(count_each_combination< ::std::size_t >(r, n-r),
+										  f,
+										  reduce,
+										  reduction,
+										  num_threads,
+										  [&](::std::size_t lo, ::std::size_t hi, Function& g, const ::std::atomic<bool>& stop)
+										  {
+											::std::vector< ::std::size_t > positions = unrank_combination(lo, n, r);
+											::std::vector<value_type> comb;
+											for (::std::size_t rank = lo; rank < hi && !stop; ++rank)
+											{
+												comb.clear();
+												for (::std::size_t i = 0; i < r; ++i)
+												{
+													comb.push_back(elems[positions[i]]);
+												}
+												if (g(comb.begin(), comb.end()))
+												{
+													return true;
+												}
+												next_combination(positions.begin(), positions.begin()+r, positions.end());
+											}
+											return false;
+										  });
+}
+
 template <typename BidirectionalIterator>
 bool next_repeat_combination_counts(BidirectionalIterator first,
 									BidirectionalIterator last)
@@ -27,7 +27,10 @@
 
 
 #include <dcs/algorithm/combination.hpp>
+#include <dcs/algorithm/connected_subset.hpp>
+#include <dcs/algorithm/integer_partition.hpp>
 #include <dcs/algorithm/mapping.hpp>
+#include <dcs/algorithm/multiset_partition.hpp>
 #include <dcs/algorithm/partition.hpp>
 #include <dcs/algorithm/permutation.hpp>
 #include <dcs/algorithm/subset.hpp>
@@ -0,0 +1,269 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file dcs/algorithm/connected_subset.hpp
+ *
+ * \brief Generate the connected induced subgraphs of a graph.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_ALGORITHM_CONNECTED_SUBSET_HPP
+#define DCS_ALGORITHM_CONNECTED_SUBSET_HPP
+
+
+#include <boost/dynamic_bitset.hpp>
+#include <cstddef>
+#include <dcs/algorithm/subset.hpp>
+#include <dcs/assert.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/exception.hpp>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+
+namespace dcs { namespace algorithm {
+
+/**
+ * \brief Class to generate all the non-empty subsets of the vertices of a
+ *  graph that induce a connected subgraph
+ *
+ * Given an undirected graph on the vertex set N={0,1,...,n-1} (described by
+ * its adjacency matrix), this class iteratively generates every subset S of
+ * N such that the subgraph induced by S is connected, exactly once.
+ * On sparse graphs the number of such subsets is far smaller than 2^n (e.g.,
+ * it is n(n+1)/2 for a path).
+ * On the complete graph all the 2^n-1 non-empty subsets are generated.
+ *
+ * Subsets are grouped by their smallest vertex v: each subset containing v is
+ * grown from {v} by adding, one at a time, vertices greater than v taken
+ * from an extension set which only receives the exclusive neighbors of the
+ * last added vertex (i.e., the neighbors not adjacent to any vertex already
+ * in the subset), as in the ESU algorithm by S. Wernicke,
+ * "Efficient Detection of Network Motifs", IEEE/ACM TCBB 3(4), 2006.
+ * The recursion of ESU is replaced by an explicit stack.
+ *
+ * The interface mimics the one of \c lexicographic_subset, so that
+ * \c next_subset can be used to iterate over the generated subsets.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class connected_subset
+{
+	private: typedef connected_subset self_type;
+	private: typedef ::boost::dynamic_bitset<> impl_type;
+	private: typedef impl_type::size_type size_type;
+
+	private: struct frame_type
+	{
+		impl_type subset; ///< The vertices in the subset
+		impl_type closed_neighbors; ///< The vertices in the subset or adjacent to it
+		::std::vector<size_type> extension; ///< The vertices that can still be added to the subset
+	};
+
+
+	public: template <typename MatrixT>
+			explicit connected_subset(MatrixT const& adjacency)
+	: n_(adjacency.size()),
+	  nbrs_(n_, impl_type(n_)),
+	  root_(0),
+	  has_next_(n_ > 0 ? true : false)
+	{
+		DCS_ASSERT(n_ > 0,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Number of elements must be positive"));
+
+		for (size_type u = 0; u < n_; ++u)
+		{
+			DCS_ASSERT(adjacency[u].size() == n_,
+					   DCS_EXCEPTION_THROW(::std::invalid_argument,
+										   "Adjacency matrix must be square"));
+
+			for (size_type v = 0; v < n_; ++v)
+			{
+				if (u != v && (adjacency[u][v] || adjacency[v][u]))
+				{
+					nbrs_[u].set(v);
+				}
+			}
+		}
+
+		this->start(root_);
+	}
+
+	public: ::std::size_t max_size() const
+	{
+		return n_;
+	}
+
+	public: ::std::size_t size() const
+	{
+		return stack_.empty() ? 0 : stack_.back().subset.count();
+	}
+
+	public: self_type& operator++()
+	{
+		DCS_ASSERT(has_next_,
+				   DCS_EXCEPTION_THROW(::std::overflow_error,
+									   "No following subsets"));
+
+		while (!stack_.empty())
+		{
+			frame_type& top = stack_.back();
+
+			if (top.extension.empty())
+			{
+				stack_.pop_back();
+				continue;
+			}
+
+			const size_type w = top.extension.back();
+			top.extension.pop_back();
+
+			frame_type next;
+			next.subset = top.subset;
+			next.subset.set(w);
+			next.closed_neighbors = top.closed_neighbors | nbrs_[w];
+			next.closed_neighbors.set(w);
+			next.extension = top.extension;
+			for (size_type u = nbrs_[w].find_next(root_); u != impl_type::npos; u = nbrs_[w].find_next(u))
+			{
+				if (!top.closed_neighbors.test(u))
+				{
+					next.extension.push_back(u);
+				}
+			}
+
+			stack_.push_back(next);
+
+			return *this;
+		}
+
+		// All the subsets whose smallest vertex is the current root have been
+		// generated: move to the next root
+		++root_;
+		if (root_ < n_)
+		{
+			this->start(root_);
+		}
+		else
+		{
+			has_next_ = false;
+		}
+
+		return *this;
+	}
+
+	public: bool has_next() const
+	{
+		return has_next_;
+	}
+
+	public: ::std::vector<size_type> operator()() const
+	{
+		::std::vector<size_type> subset;
+
+		if (!stack_.empty())
+		{
+			impl_type const& bits = stack_.back().subset;
+
+			for (size_type pos = bits.find_first();
+				 pos != impl_type::npos;
+				 pos = bits.find_next(pos))
+			{
+				subset.push_back(pos);
+			}
+		}
+
+		return subset;
+	}
+
+	public: template <typename ElemT>
+			typename subset_traits<ElemT>::element_container operator()(::std::vector<ElemT> const& v) const
+	{
+		DCS_ASSERT(v.size() == n_,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Size does not match"));
+
+		typename subset_traits<ElemT>::element_container subset;
+
+		for (auto pos : this->operator()())
+		{
+			subset.push_back(v[pos]);
+		}
+
+		return subset;
+	}
+
+	public: template <typename IterT>
+			typename subset_traits< typename ::std::iterator_traits<IterT>::value_type >::element_container operator()(IterT first, IterT last) const
+	{
+		return this->operator()(::std::vector<typename ::std::iterator_traits<IterT>::value_type>(first, last));
+	}
+
+	public: template <typename CharT, typename CharTraitsT>
+			friend ::std::basic_ostream<CharT,CharTraitsT>& operator<<(::std::basic_ostream<CharT,CharTraitsT>& os, connected_subset const& subset)
+	{
+		os << "(";
+		bool first = true;
+		for (auto pos : subset())
+		{
+			if (!first)
+			{
+				os << " ";
+			}
+			os << pos;
+			first = false;
+		}
+		os << ")";
+
+		return os;
+	}
+
+	/// Makes {v} the current subset
+	private: void start(size_type v)
+	{
+		frame_type root;
+		root.subset = impl_type(n_);
+		root.subset.set(v);
+		root.closed_neighbors = nbrs_[v];
+		root.closed_neighbors.set(v);
+		for (size_type u = nbrs_[v].find_next(v); u != impl_type::npos; u = nbrs_[v].find_next(u))
+		{
+			root.extension.push_back(u);
+		}
+
+		stack_.clear();
+		stack_.push_back(root);
+	}
+
+
+	private: ::std::size_t n_;
+	private: ::std::vector<impl_type> nbrs_; ///< The neighbors of each vertex
+	private: size_type root_; ///< The smallest vertex of the subsets currently generated
+	private: ::std::vector<frame_type> stack_; ///< The stack of ESU frames, whose top holds the current subset
+	private: bool has_next_;
+}; // connected_subset
+
+}} // Namespace dcs::algorithm
+
+
+#endif // DCS_ALGORITHM_CONNECTED_SUBSET_HPP
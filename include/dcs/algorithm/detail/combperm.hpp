@@ -117,11 +117,11 @@ rotate_discontinuous3(BidirIter first1, BidirIter last1,
     rotate_discontinuous(first1, last1, d1, first2, last2, d2);
     if (d1 <= d2)
 	{
-        rotate_discontinuous(DCS_ALGORITHM_DETAIL_MACRO_STD_NEXT_(first2, d2 - d1), last2, d1, first3, last3, d3);
+        rotate_discontinuous(DCS_DETAIL_MACRO_CX11_STD_NEXT_(first2, d2 - d1), last2, d1, first3, last3, d3);
 	}
     else
     {
-        rotate_discontinuous(DCS_ALGORITHM_DETAIL_MACRO_STD_NEXT_(first1, d2), last1, d1 - d2, first3, last3, d3);
+        rotate_discontinuous(DCS_DETAIL_MACRO_CX11_STD_NEXT_(first1, d2), last1, d1 - d2, first3, last3, d3);
         rotate_discontinuous(first2, last2, d2, first3, last3, d3);
     }
 }
@@ -166,7 +166,7 @@ combine_discontinuous(BidirIter first1, BidirIter last1,
     }
     else
     {
-        BidirIter f1p = DCS_ALGORITHM_DETAIL_MACRO_STD_NEXT_(first1);
+        BidirIter f1p = DCS_DETAIL_MACRO_CX11_STD_NEXT_(first1);
         BidirIter i2 = first2;
         for (D d22 = d2; i2 != last2; ++i2, --d22)
         {
@@ -184,7 +184,7 @@ combine_discontinuous(BidirIter first1, BidirIter last1,
 	}
     if (d != 0)
 	{
-        rotate_discontinuous(first1, last1, d1, DCS_ALGORITHM_DETAIL_MACRO_STD_NEXT_(first2), last2, d2-1);
+        rotate_discontinuous(first1, last1, d1, DCS_DETAIL_MACRO_CX11_STD_NEXT_(first2), last2, d2-1);
 	}
     else
 	{
@@ -260,9 +260,9 @@ bool combine_discontinuous3_(BidirIter first1, BidirIter last1,
 		{
             return true;
 		}
-        ::std::swap(*first1, *DCS_ALGORITHM_DETAIL_MACRO_STD_PREV_(last2));
+        ::std::swap(*first1, *DCS_DETAIL_MACRO_CX11_STD_PREV_(last2));
         ::std::swap(*first1, *first3);
-        for (BidirIter i2 = DCS_ALGORITHM_DETAIL_MACRO_STD_NEXT_(first3); i2 != last3; ++i2)
+        for (BidirIter i2 = DCS_DETAIL_MACRO_CX11_STD_NEXT_(first3); i2 != last3; ++i2)
         {
             if (f())
 			{
@@ -273,7 +273,7 @@ bool combine_discontinuous3_(BidirIter first1, BidirIter last1,
     }
     else
     {
-        BidirIter f1p = DCS_ALGORITHM_DETAIL_MACRO_STD_NEXT_(first1);
+        BidirIter f1p = DCS_DETAIL_MACRO_CX11_STD_NEXT_(first1);
         BidirIter i2 = first2;
         for (D d22 = d2; i2 != last2; ++i2, --d22)
         {
@@ -299,13 +299,13 @@ bool combine_discontinuous3_(BidirIter first1, BidirIter last1,
 	}
     if (d1 == 1)
 	{
-        ::std::swap(*DCS_ALGORITHM_DETAIL_MACRO_STD_PREV_(last2), *first3);
+        ::std::swap(*DCS_DETAIL_MACRO_CX11_STD_PREV_(last2), *first3);
 	}
     if (d != 0)
     {
         if (d2 > 1)
 		{
-            rotate_discontinuous3(first1, last1, d1, DCS_ALGORITHM_DETAIL_MACRO_STD_NEXT_(first2), last2, d2-1, first3, last3, d3);
+            rotate_discontinuous3(first1, last1, d1, DCS_DETAIL_MACRO_CX11_STD_NEXT_(first2), last2, d2-1, first3, last3, d3);
 		}
         else
 		{
@@ -359,7 +359,7 @@ bool permute_(BidirIter first1,
 		{
             return true;
 		}
-        ::std::swap(*first1, *DCS_ALGORITHM_DETAIL_MACRO_STD_NEXT_(first1));
+        ::std::swap(*first1, *DCS_DETAIL_MACRO_CX11_STD_NEXT_(first1));
         return f();
     case 3:
         {
@@ -367,8 +367,8 @@ bool permute_(BidirIter first1,
 		{
             return true;
 		}
-        BidirIter f2 = DCS_ALGORITHM_DETAIL_MACRO_STD_NEXT_(first1);
-        BidirIter f3 = DCS_ALGORITHM_DETAIL_MACRO_STD_NEXT_(f2);
+        BidirIter f2 = DCS_DETAIL_MACRO_CX11_STD_NEXT_(first1);
+        BidirIter f3 = DCS_DETAIL_MACRO_CX11_STD_NEXT_(f2);
         ::std::swap(*f2, *f3);
         if (f())
 		{
@@ -395,7 +395,7 @@ bool permute_(BidirIter first1,
         return f();
         }
     }
-    BidirIter fp1 = DCS_ALGORITHM_DETAIL_MACRO_STD_NEXT_(first1);
+    BidirIter fp1 = DCS_DETAIL_MACRO_CX11_STD_NEXT_(first1);
     for (BidirIter p = fp1; p != last1; ++p)
     {
         if (permute_(fp1, last1, d1-1, f))
@@ -431,7 +431,7 @@ bool permute(BidirIter first1,
 			{
 				return true;
 			}
-			BidirIter i = DCS_ALGORITHM_DETAIL_MACRO_STD_NEXT_(first1);
+			BidirIter i = DCS_DETAIL_MACRO_CX11_STD_NEXT_(first1);
 			::std::swap(*first1, *i);
 			if (f())
 			{
@@ -446,8 +446,8 @@ bool permute(BidirIter first1,
 			{
 				return true;
 			}
-			BidirIter f2 = DCS_ALGORITHM_DETAIL_MACRO_STD_NEXT_(first1);
-			BidirIter f3 = DCS_ALGORITHM_DETAIL_MACRO_STD_NEXT_(f2);
+			BidirIter f2 = DCS_DETAIL_MACRO_CX11_STD_NEXT_(first1);
+			BidirIter f3 = DCS_DETAIL_MACRO_CX11_STD_NEXT_(f2);
 			::std::swap(*f2, *f3);
 			if (f())
 			{
@@ -479,7 +479,7 @@ bool permute(BidirIter first1,
         }
         break;
     default:
-        BidirIter fp1 = DCS_ALGORITHM_DETAIL_MACRO_STD_NEXT_(first1);
+        BidirIter fp1 = DCS_DETAIL_MACRO_CX11_STD_NEXT_(first1);
         for (BidirIter p = fp1; p != last1; ++p)
         {
             if (permute_(fp1, last1, d1-1, f))
@@ -581,7 +581,7 @@ class circular_permutation
 			return f_(first, last);
 		}
 		bound_range<Function, BidirIter> f(f_, first, last);
-		return permute(DCS_ALGORITHM_DETAIL_MACRO_STD_NEXT_(first), last, s_ - 1, f);
+		return permute(DCS_DETAIL_MACRO_CX11_STD_NEXT_(first), last, s_ - 1, f);
 	}
 
 	private: Function f_;
@@ -742,7 +742,7 @@ bool reversible_permutation<Function, Size>::operator()(BidirIter first,
 	}
     // Hold the first element steady and call f_(first, last) for each
     //    permutation in [first+1, last).
-    BidirIter a = DCS_ALGORITHM_DETAIL_MACRO_STD_NEXT_(first);
+    BidirIter a = DCS_DETAIL_MACRO_CX11_STD_NEXT_(first);
     bound_range<Function&, BidirIter> f(f_, first, last);
     if (permute(a, last, s_-1, f))
 	{
@@ -754,7 +754,7 @@ bool reversible_permutation<Function, Size>::operator()(BidirIter first,
     //    [prior to the orignal element] + [after the original element].
     Size s2 = s_ / 2;
     BidirIter am1 = first;
-    BidirIter ap1 = DCS_ALGORITHM_DETAIL_MACRO_STD_NEXT_(a);
+    BidirIter ap1 = DCS_DETAIL_MACRO_CX11_STD_NEXT_(a);
     for (Size i = 1; i < s2; ++i, ++am1, ++a, ++ap1)
     {
         ::std::swap(*am1, *a);
@@ -791,7 +791,7 @@ bool reversible_permutation<Function, Size>::operator()(BidirIter first,
         //     of that discontinuous range.
         ::std::swap(*am1, *a);
         BidirIter b = first;
-        BidirIter bp1 = DCS_ALGORITHM_DETAIL_MACRO_STD_NEXT_(b);
+        BidirIter bp1 = DCS_DETAIL_MACRO_CX11_STD_NEXT_(b);
         F2 f2(f, bp1, a, s2-1, ap1, last, s_ - s2 - 1);
         if (combine_discontinuous(bp1, a, s2-1, ap1, last, s_ - s2 - 1, f2))
 		{
@@ -856,7 +856,7 @@ class reverse_circular_permutation
         typedef typename ::std::iterator_traits<BidirIter>::difference_type D;
         typedef bound_range<Function, BidirIter> BoundFunc;
         BoundFunc f(f_, first, last);
-        BidirIter n = DCS_ALGORITHM_DETAIL_MACRO_STD_NEXT_(first);
+        BidirIter n = DCS_DETAIL_MACRO_CX11_STD_NEXT_(first);
         return reversible_permutation<BoundFunc, D>(f, ::std::distance(n, last))(n, last);
     }
 
@@ -0,0 +1,186 @@
+/**
+ * \file dcs/algorithm/detail/parallel_combperm.hpp
+ *
+ * \brief Parallel execution of visitors over ranked combinatorial spaces.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_ALGORITHM_DETAIL_PARALLEL_COMBPERM_HPP
+#define DCS_ALGORITHM_DETAIL_PARALLEL_COMBPERM_HPP
+
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace dcs { namespace algorithm {
+
+/// The order according which the visitor copies of the chunks of a parallel
+/// enumeration are reduced
+enum parallel_reduction_category
+{
+	ordered_parallel_reduction, ///< Chunks are reduced in rank order, once all of them have been visited
+	unordered_parallel_reduction ///< Chunks are reduced as soon as they have been visited
+};
+
+namespace detail {
+
+/**
+ * \brief Visits the ranks [0,\a count) in parallel, split into balanced
+ *  ranges of consecutive ranks (chunks).
+ *
+ * Each chunk is visited by \c visit_chunk(lo,hi,g,stop) on its own copy \c g
+ * of \a f, which thus holds the per-thread state; \c visit_chunk returns
+ * \c true if \c g asked to stop the enumeration, and should return as soon
+ * as \c stop becomes \c true.
+ * Chunks are assigned to (at most) \a num_threads threads (where 0 stands for
+ * the number of hardware threads) dynamically.
+ * The copies of \a f are folded into \a f by \c reduce(f,g), either in rank
+ * order or in completion order, according to \a reduction; hence \a f should
+ * start from the identity state of the reduction.
+ * The chunks that have not been started because the enumeration has been
+ * stopped are not reduced.
+ * If some chunk throws, the remaining chunks are not started and the first
+ * exception is re-thrown once all threads have finished.
+ */
+template <typename Function, typename Reduce, typename VisitChunk>
+Function parallel_for_each_rank(::std::size_t count,
+								Function f,
+								Reduce reduce,
+								parallel_reduction_category reduction,
+								::std::size_t num_threads,
+								VisitChunk visit_chunk)
+{
+	if (num_threads == 0)
+	{
+		num_threads = ::std::max(::std::thread::hardware_concurrency(), 1u);
+	}
+
+	// Use some chunks per thread, so that threads slowed down by unbalanced
+	// visits still share the work
+	const ::std::size_t num_chunks = ::std::min(count, 4*num_threads);
+
+	if (num_chunks == 0)
+	{
+		return f;
+	}
+
+	num_threads = ::std::min(num_threads, num_chunks);
+
+	::std::vector<Function> chunk_fs;
+	::std::vector<char> chunk_visited;
+	if (reduction == ordered_parallel_reduction)
+	{
+		chunk_fs.assign(num_chunks, f);
+		chunk_visited.assign(num_chunks, false);
+	}
+	Function proto(f);
+
+	::std::atomic< ::std::size_t > next_chunk(0);
+	::std::atomic<bool> stop(false);
+	::std::exception_ptr p_exc;
+	::std::mutex mutex;
+
+	auto worker = [&]()
+	{
+		::std::size_t c = 0;
+		while (!stop && (c = next_chunk++) < num_chunks)
+		{
+			const ::std::size_t lo = c*(count/num_chunks) + ::std::min(c, count%num_chunks);
+			const ::std::size_t hi = lo + count/num_chunks + (c < count%num_chunks ? 1 : 0);
+
+			try
+			{
+				if (reduction == ordered_parallel_reduction)
+				{
+					chunk_visited[c] = true;
+					if (visit_chunk(lo, hi, chunk_fs[c], stop))
+					{
+						stop = true;
+					}
+				}
+				else
+				{
+					Function g(proto);
+
+					if (visit_chunk(lo, hi, g, stop))
+					{
+						stop = true;
+					}
+
+					::std::lock_guard< ::std::mutex > lock(mutex);
+
+					reduce(f, g);
+				}
+			}
+			catch (...)
+			{
+				::std::lock_guard< ::std::mutex > lock(mutex);
+
+				if (!p_exc)
+				{
+					p_exc = ::std::current_exception();
+				}
+				stop = true;
+			}
+		}
+	};
+
+	::std::vector< ::std::thread > threads;
+	for (::std::size_t t = 1; t < num_threads; ++t)
+	{
+		threads.push_back(::std::thread(worker));
+	}
+	worker();
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	if (p_exc)
+	{
+		::std::rethrow_exception(p_exc);
+	}
+
+	if (reduction == ordered_parallel_reduction)
+	{
+		for (::std::size_t c = 0; c < num_chunks; ++c)
+		{
+			if (chunk_visited[c])
+			{
+				reduce(f, chunk_fs[c]);
+			}
+		}
+	}
+
+	return f;
+}
+
+} // Namespace detail
+
+}} // Namespace dcs::algorithm
+
+
+#endif // DCS_ALGORITHM_DETAIL_PARALLEL_COMBPERM_HPP
@@ -25,25 +25,162 @@
 #ifndef DCS_ALGORITHM_INTEGER_PARTITION_HPP
 #define DCS_ALGORITHM_INTEGER_PARTITION_HPP
 
+#include <algorithm>
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/exception.hpp>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+
 namespace dcs { namespace algorithm {
 
+/**
+ * \brief Class to generate all the partitions of a positive integer
+ *
+ * Given a positive integer n, this class iteratively generates all the ways
+ * of writing n as a sum of positive integers (the parts), without regard to
+ * order, in reverse lexicographic order.
+ * Parts are kept in non-increasing order.
+ * For instance, for n=4 the following sequence is generated:
+ * <pre>
+ *  (4), (3 1), (2 2), (2 1 1), (1 1 1 1)
+ * </pre>
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
 template <typename UIntT=unsigned int>
 class integer_partition
 {
 	public: typedef UIntT uint_type;
+	protected: typedef ::std::vector<uint_type> part_container;
+	public: typedef integer_partition<UIntT> self_type;
+	public: typedef typename part_container::const_iterator const_iterator;
+
+
+	public: explicit integer_partition(uint_type n)
+	: n_(n),
+	  k_(1, n),
+	  has_next_(true)
+	{
+		DCS_ASSERT(n_ > 0,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Integer to partition must be positive"));
+	}
+
+	public: uint_type value() const
+	{
+		return n_;
+	}
+
+	public: ::std::size_t num_parts() const
+	{
+		return k_.size();
+	}
+
+	public: uint_type operator[](::std::size_t i) const
+	{
+		DCS_ASSERT(i < k_.size(),
+				   DCS_EXCEPTION_THROW(::std::out_of_range,
+									   "Part index is out of range"));
+
+		return k_[i];
+	}
+
+	/// Returns the multiplicity of each part value, that is the number of
+	/// parts equal to v is stored at position v-1.
+	public: ::std::vector<uint_type> multiplicities() const
+	{
+		::std::vector<uint_type> m(n_, 0);
 
+		for (::std::size_t i = 0; i < k_.size(); ++i)
+		{
+			++m[k_[i]-1];
+		}
 
-	public: integer_partition(uint_type n)
-	: n_(n)
+		return m;
+	}
+
+	public: self_type& operator++()
+	{
+		DCS_ASSERT(has_next_,
+				   DCS_EXCEPTION_THROW(::std::overflow_error,
+									   "No following partitions"));
+
+		// The last partition is made of n parts equal to 1
+		has_next_ = k_.size() < n_;
+
+		if (has_next_)
+		{
+			// Find the rightmost part greater than 1 and decrease it by 1, then
+			// spread the remainder (i.e., the trailing 1s plus the unit just
+			// removed) in parts not greater than the decreased one
+			::std::size_t i = k_.size()-1;
+			while (k_[i] == 1)
+			{
+				--i;
+			}
+
+			uint_type rem = static_cast<uint_type>(k_.size()-i);
+			const uint_type v = --k_[i];
+
+			k_.resize(i+1);
+			while (rem > v)
+			{
+				k_.push_back(v);
+				rem -= v;
+			}
+			if (rem > 0)
+			{
+				k_.push_back(rem);
+			}
+		}
+
+		return *this;
+	}
+
+	public: bool has_next() const
 	{
+		return has_next_;
+	}
+
+	public: const_iterator begin() const
+	{
+		return k_.begin();
+	}
+
+	public: const_iterator end() const
+	{
+		return k_.end();
 	}
 
 
 	private: uint_type n_;
-	private: ::std::vector<uint_type> k_;
-	private: ::std::vector<uint_type> m_;
+	private: part_container k_;
+	private: bool has_next_;
 }; // integer_partition
 
+template <typename CharT, typename CharTraitsT, typename UIntT>
+::std::basic_ostream<CharT,CharTraitsT>& operator<<(::std::basic_ostream<CharT,CharTraitsT>& os,
+													integer_partition<UIntT> const& part)
+{
+	os << '(';
+
+	if (part.num_parts() > 1)
+	{
+		::std::copy(part.begin(),
+					part.end()-1,
+					::std::ostream_iterator<UIntT>(os, " "));
+	}
+
+	os << *(part.end()-1) << ')';
+
+	return os;
+}
+
 }} // Namespace dcs::algorithm
 
 #endif // DCS_ALGORITHM_INTEGER_PARTITION_HPP
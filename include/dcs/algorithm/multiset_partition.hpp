@@ -0,0 +1,271 @@
+/**
+ * \file dcs/algorithm/multiset_partition.hpp
+ *
+ * \brief Multiset partitions
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_ALGORITHM_MULTISET_PARTITION_HPP
+#define DCS_ALGORITHM_MULTISET_PARTITION_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/exception.hpp>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+
+namespace dcs { namespace algorithm {
+
+/**
+ * \brief Class to generate all the partitions of a multiset
+ *
+ * Given a multiset made of m distinct element types, where type j occurs
+ * n_j > 0 times, this class iteratively generates all the partitions of the
+ * multiset into non-empty sub-multisets (the parts), in decreasing
+ * lexicographic order.
+ * Each part is represented by the vector of the multiplicities of the m
+ * element types it contains.
+ * For instance, for the multiset {a,a,b} (i.e., n=(2 1)) the following
+ * sequence is generated:
+ * <pre>
+ *  ((2 1)), ((2 0) (0 1)), ((1 1) (1 0)), ((1 0) (1 0) (0 1))
+ * </pre>
+ * When m=1, the generated partitions are the integer partitions of n_1.
+ *
+ * The implementation follows Algorithm M (multipartitions in decreasing
+ * lexicographic order) in D.E. Knuth,
+ * "The Art of Computer Programming, Vol. 4A", Section 7.2.1.5.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class multiset_partition
+{
+	public: typedef ::std::vector< ::std::size_t > part_type;
+	public: typedef ::std::vector<part_type> part_container;
+	public: typedef multiset_partition self_type;
+
+
+	public: template <typename IterT>
+			multiset_partition(IterT first, IterT last)
+	: m_(::std::distance(first, last)),
+	  has_next_(true)
+	{
+		DCS_ASSERT(m_ > 0,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument,
+									   "Number of element types must be positive"));
+
+		::std::size_t n = 0;
+		for (IterT it = first; it != last; ++it)
+		{
+			DCS_ASSERT(*it > 0,
+					   DCS_EXCEPTION_THROW(::std::invalid_argument,
+										   "Multiplicities must be positive"));
+
+			n += *it;
+		}
+
+		// M1 [Initialize]
+		c_.resize(m_*n+1);
+		u_.resize(m_*n+1);
+		v_.resize(m_*n+1);
+		f_.resize(n+1);
+		for (::std::size_t j = 0; j < m_; ++j, ++first)
+		{
+			c_[j] = j;
+			u_[j] = v_[j] = *first;
+		}
+		f_[0] = a_ = l_ = 0;
+		f_[1] = b_ = m_;
+
+		this->subtract();
+	}
+
+	public: explicit multiset_partition(::std::vector< ::std::size_t > const& multiplicities)
+	: multiset_partition(multiplicities.begin(), multiplicities.end())
+	{
+	}
+
+	public: ::std::size_t num_types() const
+	{
+		return m_;
+	}
+
+	public: ::std::size_t num_parts() const
+	{
+		return l_+1;
+	}
+
+	public: self_type& operator++()
+	{
+		DCS_ASSERT(has_next_,
+				   DCS_EXCEPTION_THROW(::std::overflow_error,
+									   "No following partitions"));
+
+		// M5 [Decrease v]
+		while (true)
+		{
+			::std::size_t j = b_-1;
+			while (v_[j] == 0)
+			{
+				--j;
+			}
+			if (j == a_ && v_[j] == 1)
+			{
+				// M6 [Backtrack]
+				if (l_ == 0)
+				{
+					// This was the last partition
+					has_next_ = false;
+					return *this;
+				}
+				--l_;
+				b_ = a_;
+				a_ = f_[l_];
+			}
+			else
+			{
+				--v_[j];
+				for (::std::size_t k = j+1; k < b_; ++k)
+				{
+					v_[k] = u_[k];
+				}
+				break;
+			}
+		}
+
+		this->subtract();
+
+		return *this;
+	}
+
+	public: bool has_next() const
+	{
+		return has_next_;
+	}
+
+	/// Returns the parts of the current partition
+	public: part_container operator()() const
+	{
+		part_container parts(l_+1, part_type(m_, 0));
+
+		for (::std::size_t k = 0; k <= l_; ++k)
+		{
+			for (::std::size_t j = f_[k]; j < f_[k+1]; ++j)
+			{
+				parts[k][c_[j]] = v_[j];
+			}
+		}
+
+		return parts;
+	}
+
+	/// M2 [Subtract v from u] and M3 [Push if nonzero], up to the next partition to visit (M4)
+	private: void subtract()
+	{
+		while (true)
+		{
+			::std::size_t j = a_;
+			::std::size_t k = b_;
+			bool x = false;
+			for (; j < b_; ++j)
+			{
+				u_[k] = u_[j]-v_[j];
+				if (u_[k] == 0)
+				{
+					x = true;
+				}
+				else if (!x)
+				{
+					c_[k] = c_[j];
+					v_[k] = ::std::min(v_[j], u_[k]);
+					x = u_[k] < v_[j];
+					++k;
+				}
+				else
+				{
+					c_[k] = c_[j];
+					v_[k] = u_[k];
+					++k;
+				}
+			}
+
+			if (k > b_)
+			{
+				a_ = b_;
+				b_ = k;
+				++l_;
+				f_[l_+1] = b_;
+			}
+			else
+			{
+				break;
+			}
+		}
+	}
+
+
+	private: ::std::size_t m_; ///< Number of distinct element types
+	private: ::std::vector< ::std::size_t > c_; ///< Component (element type) of each stack entry
+	private: ::std::vector< ::std::size_t > u_; ///< Yet unpartitioned multiplicity of each stack entry
+	private: ::std::vector< ::std::size_t > v_; ///< Multiplicity in the current part of each stack entry
+	private: ::std::vector< ::std::size_t > f_; ///< Stack frames, that is f_[k] is the first stack entry of part k
+	private: ::std::size_t a_; ///< First stack entry of the current (topmost) part
+	private: ::std::size_t b_; ///< One past the last stack entry of the current part
+	private: ::std::size_t l_; ///< Index of the current (topmost) part
+	private: bool has_next_;
+}; // multiset_partition
+
+template <typename CharT, typename CharTraitsT>
+::std::basic_ostream<CharT,CharTraitsT>& operator<<(::std::basic_ostream<CharT,CharTraitsT>& os,
+													multiset_partition const& part)
+{
+	multiset_partition::part_container const parts = part();
+
+	os << '(';
+	for (::std::size_t k = 0; k < parts.size(); ++k)
+	{
+		if (k > 0)
+		{
+			os << ' ';
+		}
+		os << '(';
+		for (::std::size_t j = 0; j < parts[k].size(); ++j)
+		{
+			if (j > 0)
+			{
+				os << ' ';
+			}
+			os << parts[k][j];
+		}
+		os << ')';
+	}
+	os << ')';
+
+	return os;
+}
+
+}} // Namespace dcs::algorithm
+
+#endif // DCS_ALGORITHM_MULTISET_PARTITION_HPP
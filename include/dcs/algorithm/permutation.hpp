@@ -51,12 +51,15 @@
 
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <dcs/algorithm/detail/combperm.hpp>
+#include <dcs/algorithm/detail/parallel_combperm.hpp>
 #include <dcs/detail/macro_cx11.hpp>
 #include <stdexcept>
 #include <iterator>
 #include <limits>
+#include <vector>
 
 
 namespace dcs { namespace algorithm {
@@ -341,6 +344,100 @@ bool prev_partial_permutation(BidiIteratorT first,
 	return result;
 }
 
+/**
+ * \brief Returns the positions of the permutation of size \a r of \a n
+ *  positions with the given rank, followed by the other positions.
+ *
+ * Permutations are ranked in lexicographic order of their positions, i.e., in
+ * the order generated by \c next_partial_permutation on the positions
+ * 0,1,...,n-1.
+ * The positions that follow the first \a r ones are sorted.
+ */
+template <typename UIntT>
+::std::vector<UIntT> unrank_permutation(UIntT rank, UIntT n, UIntT r)
+{
+	if (r > n || rank >= count_each_permutation<UIntT>(r, n-r))
+	{
+		throw ::std::out_of_range("rank out of range in unrank_permutation");
+	}
+
+	::std::vector<UIntT> left;
+	for (UIntT i = 0; i < n; ++i)
+	{
+		left.push_back(i);
+	}
+
+	// The rank is a mixed-radix number whose k-th digit selects among the
+	// n-k positions left
+	::std::vector<UIntT> positions;
+	for (UIntT k = 0; k < r; ++k)
+	{
+		const UIntT num_perms = count_each_permutation<UIntT>(r-k-1, n-r);
+		const UIntT digit = rank/num_perms;
+
+		rank %= num_perms;
+		positions.push_back(left[digit]);
+		left.erase(left.begin()+digit);
+	}
+	positions.insert(positions.end(), left.begin(), left.end());
+
+	return positions;
+}
+
+/**
+ * \brief Parallel version of \c for_each_permutation.
+ *
+ * Calls \a f for each permutation of size \a mid-\a first of the elements
+ * in [\a first,\a last), until \a f returns \c true.
+ * The space of permutations is split into balanced ranges of consecutive
+ * ranks (see \c unrank_permutation), each visited by its own copy of \a f
+ * through \c next_partial_permutation on positions.
+ * As for \c parallel_for_each_combination, [\a first,\a last) is never
+ * modified, \a f is called with iterators to a copy of the elements of the
+ * permutation, and the copies of \a f are folded into \a f by
+ * \c reduce(f,g) according to \a reduction.
+ */
+template <typename BidirIter, typename Function, typename Reduce>
+Function parallel_for_each_permutation(BidirIter first,
+									   BidirIter mid,
+									   BidirIter last,
+									   Function f,
+									   Reduce reduce,
+									   parallel_reduction_category reduction = ordered_parallel_reduction,
+									   ::std::size_t num_threads = 0)
+{
+	typedef typename ::std::iterator_traits<BidirIter>::value_type value_type;
+
+	const ::std::vector<value_type> elems(first, last);
+	const ::std::size_t r = ::std::distance(first, mid);
+	const ::std::size_t n = elems.size();
+
+	return detail::parallel_for_each_rank(count_each_permutation< ::std::size_t >(r, n-r),
+										  f,
+										  reduce,
+										  reduction,
+										  num_threads,
+										  [&](::std::size_t lo, ::std::size_t hi, Function& g, const ::std::atomic<bool>& stop)
+										  {
+											::std::vector< ::std::size_t > positions = unrank_permutation(lo, n, r);
+											::std::vector<value_type> perm;
+											for (::std::size_t rank = lo; rank < hi && !stop; ++rank)
+											{
+												perm.clear();
+												for (::std::size_t i = 0; i < r; ++i)
+												{
+													perm.push_back(elems[positions[i]]);
+												}
+												if (g(perm.begin(), perm.end()))
+												{
+													return true;
+												}
+												next_partial_permutation(positions.begin(), positions.begin()+r, positions.end());
+											}
+											return false;
+										  });
+}
+
 }} // Namespace dcs::algorithm
 
 
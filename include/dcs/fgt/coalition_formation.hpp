@@ -31,8 +31,10 @@
 
 //#include <dcs/fgt/coalition_formation/analyzer.hpp>
 #include <dcs/fgt/coalition_formation/commons.hpp>
-//#include <dcs/fgt/coalition_formation/social_optimum.hpp>
+#include <dcs/fgt/coalition_formation/multi_stable.hpp>
+#include <dcs/fgt/coalition_formation/social_optimum.hpp>
 #include <dcs/fgt/coalition_formation/nash_stable.hpp>
+#include <dcs/fgt/coalition_formation/symmetric_nash_stable.hpp>
 //#include <dcs/fgt/coalition_formation/pareto_optimal.hpp>
 
 
@@ -32,6 +32,7 @@
 #include <gtpack/cooperative.hpp>
 #include <limits>
 #include <map>
+#include <ostream>
 #include <set>
 #include <vector>
 
@@ -40,7 +41,54 @@ namespace dcs { namespace fgt {
 
 enum coalition_formation_category
 {
-	nash_stable_coalition_formation
+	nash_stable_coalition_formation,
+	individually_stable_coalition_formation,
+	contractually_individually_stable_coalition_formation,
+	core_stable_coalition_formation ///< Core stability of the partition (no coalition is strictly preferred by all its members)
+};
+
+template <typename CharT, typename CharTraitsT>
+std::basic_ostream<CharT,CharTraitsT>& operator<<(std::basic_ostream<CharT,CharTraitsT>& os, coalition_formation_category category)
+{
+	switch (category)
+	{
+		case nash_stable_coalition_formation:
+			return os << "nash";
+		case individually_stable_coalition_formation:
+			return os << "individual";
+		case contractually_individually_stable_coalition_formation:
+			return os << "contractual-individual";
+		case core_stable_coalition_formation:
+			return os << "core";
+	}
+
+	return os;
+}
+
+enum core_check_category
+{
+	exhaustive_core_check, ///< Compute the core (by linear programming) and check the payoffs against the constraints of all the coalitions
+	separation_core_check ///< Search a coalition whose core constraint is violated by the payoffs (by branch and bound), without computing the core
+};
+
+template <typename CharT, typename CharTraitsT>
+std::basic_ostream<CharT,CharTraitsT>& operator<<(std::basic_ostream<CharT,CharTraitsT>& os, core_check_category category)
+{
+	switch (category)
+	{
+		case exhaustive_core_check:
+			return os << "exhaustive";
+		case separation_core_check:
+			return os << "separation";
+	}
+
+	return os;
+}
+
+enum coalition_formation_trigger_category
+{
+	periodic_coalition_formation_trigger, ///< Form coalitions at every activation
+	demand_change_coalition_formation_trigger ///< Form coalitions only when the workload demand has changed since the last formation
 };
 
 enum coalition_value_division_category
@@ -55,6 +103,7 @@ struct coalition_info_t
 	: //fnid_to_idx(),
 	  value(std::numeric_limits<RealT>::quiet_NaN()),
 	  core_empty(true),
+	  core_empty_known(false),
 	  payoffs(),
 	  payoffs_in_core(false),
 	  cid(gtpack::empty_cid)
@@ -67,6 +116,7 @@ struct coalition_info_t
 	vm_allocation_t<RealT> vm_allocation;
 	RealT value;
 	bool core_empty;
+	bool core_empty_known; ///< Tells if \c core_empty has been established (a separation check only establishes it when the payoffs belong to the core)
 	std::map<gtpack::pid_type, RealT> payoffs;
 	bool payoffs_in_core;
 	gtpack::cid_type cid;
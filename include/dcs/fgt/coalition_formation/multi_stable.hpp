@@ -0,0 +1,411 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file dcs/fgt/coalition_formation/multi_stable.hpp
+ *
+ * \brief Selection of the partitions that are stable under several stability
+ *  notions at once.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_FGT_COALITION_FORMATION_MULTI_STABLE_HPP
+#define DCS_FGT_COALITION_FORMATION_MULTI_STABLE_HPP
+
+
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/fgt/coalition_formation/commons.hpp>
+#include <dcs/math/traits/float.hpp>
+#include <gtpack/cooperative.hpp>
+#include <limits>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+
+namespace dcs { namespace fgt {
+
+/**
+ * Selects the partitions that are stable according to each of several
+ * stability notions, by enumerating the partitions once.
+ *
+ * Supported notions (where \f$S_{\Pi}(i)\f$ is the coalition of player
+ * \f$i\f$ in partition \f$\Pi\f$, and players compare coalitions by their
+ * payoffs):
+ * - Nash stability: no player prefers \f$S_k \cup \{i\}\f$ to
+ *   \f$S_{\Pi}(i)\f$, for any \f$S_k \in \Pi \cup \{\emptyset\}\f$;
+ * - individual stability: as Nash stability, but a deviation only counts if
+ *   no member of \f$S_k\f$ gets a lower payoff in \f$S_k \cup \{i\}\f$;
+ * - contractual individual stability: as individual stability, but a
+ *   deviation only counts if also no member of \f$S_{\Pi}(i)\f$ gets a lower
+ *   payoff in \f$S_{\Pi}(i) \setminus \{i\}\f$;
+ * - core stability: no coalition \f$T\f$ is strictly preferred by all its
+ *   members to their coalitions in \f$\Pi\f$.
+ *
+ * Hence a Nash-stable partition is individually stable, and an individually
+ * stable partition is contractually individually stable.
+ *
+ * Payoffs are read once into a dense table indexed by player bitmask, and
+ * every partition is checked against all the requested notions, so that a
+ * comparison among notions costs a single enumeration.
+ * Deviations are evaluated as in nash_stable_partition_selector_t (a player
+ * prefers a coalition where its payoff is missing, and coalitions that have
+ * not been visited cannot be joined), so that the Nash-stable partitions are
+ * the same; a coalition with missing payoffs cannot block a partition,
+ * instead.
+ * Only partitions into visited coalitions are enumerated (e.g., with a
+ * topology among players).
+ */
+template <typename RealT>
+class multi_stable_partition_selector_t
+{
+public:
+    typedef std::map<coalition_formation_category, std::vector<partition_info_t<RealT>>> result_type;
+
+    /// Maximum number of players, since payoffs are tabulated for all
+    /// coalitions at every selection, in \f$O(2^n n)\f$ space (about 10MB for
+    /// 16 players), and the partitions, whose number grows as Bell(n), are
+    /// enumerated
+    static const std::size_t max_num_players = 16;
+
+
+    template <typename IterT>
+    multi_stable_partition_selector_t(IterT first_category, IterT last_category)
+    : categories_(first_category, last_category)
+    {
+    }
+
+    result_type operator()(const gtpack::cooperative_game<RealT>& game, const std::map<gtpack::cid_type,coalition_info_t<RealT>>& visited_coalitions) const
+    {
+        result_type result;
+        for (auto const category : categories_)
+        {
+            result[category];
+        }
+
+        auto const players = game.players();
+        auto const np = players.size();
+
+        DCS_ASSERT(np <= max_num_players,
+                   DCS_EXCEPTION_THROW(std::invalid_argument, "Too many players"));
+
+        if (np == 0 || categories_.empty())
+        {
+            return result;
+        }
+
+        payoff_table_t table;
+
+        make_payoff_table(visited_coalitions, players, table);
+
+        // Group the visited coalitions by their lowest player, so that every
+        // partition is generated once by assigning the lowest unassigned
+        // player to one of the coalitions it can join
+
+        std::vector<std::vector<std::size_t>> lowest_player_masks(np);
+        for (std::size_t mask = 1; mask < table.num_masks; ++mask)
+        {
+            if (table.visited[mask])
+            {
+                lowest_player_masks[lowest_player(mask)].push_back(mask);
+            }
+        }
+
+        std::vector<std::size_t> blocks;
+        std::vector<std::size_t> player_blocks(np, 0);
+
+        this->enumerate_partitions(game, visited_coalitions, table, lowest_player_masks, table.num_masks-1, blocks, player_blocks, result);
+
+        return result;
+    }
+
+
+private:
+    /// Payoffs of all coalitions, indexed by (player-index bitmask, player index)
+    struct payoff_table_t
+    {
+        std::size_t np = 0;
+        std::size_t num_masks = 0;
+        std::vector<gtpack::cid_type> mask_cids;
+        std::vector<char> visited;
+        std::vector<RealT> payoffs;
+        std::vector<char> has_payoffs;
+    }; // payoff_table_t
+
+
+    static std::size_t lowest_player(std::size_t mask)
+    {
+        std::size_t k = 0;
+        while (!(mask & (std::size_t(1) << k)))
+        {
+            ++k;
+        }
+
+        return k;
+    }
+
+    static void make_payoff_table(const std::map<gtpack::cid_type,coalition_info_t<RealT>>& visited_coalitions,
+                                  const std::vector<gtpack::pid_type>& players,
+                                  payoff_table_t& table)
+    {
+        namespace gt = gtpack;
+
+        table.np = players.size();
+        table.num_masks = std::size_t(1) << table.np;
+        table.mask_cids.assign(table.num_masks, gt::empty_cid);
+        table.visited.assign(table.num_masks, false);
+        table.payoffs.assign(table.num_masks*table.np, std::numeric_limits<RealT>::quiet_NaN());
+        table.has_payoffs.assign(table.num_masks*table.np, false);
+        for (std::size_t mask = 1; mask < table.num_masks; ++mask)
+        {
+            auto const low = lowest_player(mask);
+
+            table.mask_cids[mask] = table.mask_cids[mask & (mask-1)] | gt::make_coalition_id(players[low]);
+
+            auto const coal_it = visited_coalitions.find(table.mask_cids[mask]);
+            if (coal_it == visited_coalitions.end())
+            {
+                continue;
+            }
+
+            table.visited[mask] = true;
+            for (std::size_t k = low; k < table.np; ++k)
+            {
+                if (mask & (std::size_t(1) << k))
+                {
+                    auto const payoff_it = coal_it->second.payoffs.find(players[k]);
+                    if (payoff_it != coal_it->second.payoffs.end())
+                    {
+                        table.payoffs[mask*table.np+k] = payoff_it->second;
+                        table.has_payoffs[mask*table.np+k] = true;
+                    }
+                }
+            }
+        }
+    }
+
+    void enumerate_partitions(const gtpack::cooperative_game<RealT>& game,
+                              const std::map<gtpack::cid_type,coalition_info_t<RealT>>& visited_coalitions,
+                              const payoff_table_t& table,
+                              const std::vector<std::vector<std::size_t>>& lowest_player_masks,
+                              std::size_t unassigned_mask,
+                              std::vector<std::size_t>& blocks,
+                              std::vector<std::size_t>& player_blocks,
+                              result_type& result) const
+    {
+        if (unassigned_mask == 0)
+        {
+            this->check_partition(game, visited_coalitions, table, blocks, player_blocks, result);
+
+            return;
+        }
+
+        auto const low = lowest_player(unassigned_mask);
+
+        for (auto const mask : lowest_player_masks[low])
+        {
+            if ((mask & unassigned_mask) == mask)
+            {
+                for (std::size_t k = low; k < table.np; ++k)
+                {
+                    if (mask & (std::size_t(1) << k))
+                    {
+                        player_blocks[k] = mask;
+                    }
+                }
+
+                blocks.push_back(mask);
+                this->enumerate_partitions(game, visited_coalitions, table, lowest_player_masks, unassigned_mask & ~mask, blocks, player_blocks, result);
+                blocks.pop_back();
+            }
+        }
+    }
+
+    /// Checks the given partition against all the requested stability notions
+    void check_partition(const gtpack::cooperative_game<RealT>& game,
+                         const std::map<gtpack::cid_type,coalition_info_t<RealT>>& visited_coalitions,
+                         const payoff_table_t& table,
+                         const std::vector<std::size_t>& blocks,
+                         const std::vector<std::size_t>& player_blocks,
+                         result_type& result) const
+    {
+        typedef dcs::math::float_traits<RealT> float_traits;
+
+        auto const np = table.np;
+
+        bool nash_stable = result.count(nash_stable_coalition_formation) > 0;
+        bool ind_stable = result.count(individually_stable_coalition_formation) > 0;
+        bool contr_ind_stable = result.count(contractually_individually_stable_coalition_formation) > 0;
+        bool core_stable = result.count(core_stable_coalition_formation) > 0;
+
+        // Player k wants to move from coalition c to coalition d
+        auto const prefers = [&](std::size_t k, std::size_t d, std::size_t c)
+                             {
+                                return !table.has_payoffs[d*np+k]
+                                       || float_traits::definitely_greater(table.payoffs[d*np+k], table.payoffs[c*np+k]);
+                             };
+        // No member of both coalitions c and d gets a lower payoff in d than in c
+        auto const accepts = [&](std::size_t d, std::size_t c)
+                             {
+                                const std::size_t members = c & d;
+
+                                for (std::size_t j = 0; j < np; ++j)
+                                {
+                                    if ((members & (std::size_t(1) << j))
+                                        && (!table.has_payoffs[d*np+j]
+                                            || float_traits::definitely_less(table.payoffs[d*np+j], table.payoffs[c*np+j])))
+                                    {
+                                        return false;
+                                    }
+                                }
+                                return true;
+                             };
+
+        // Individual deviations: for all players k and all S_k \in \Pi \cup \{\emptyset\}
+
+        for (std::size_t k = 0; k < np && (nash_stable || ind_stable || contr_ind_stable); ++k)
+        {
+            const std::size_t pbit = std::size_t(1) << k;
+            const std::size_t c = player_blocks[k];
+            const std::size_t c_left = c & ~pbit;
+            const bool left_accepts = c_left == 0 || (table.visited[c_left] && accepts(c_left, c));
+
+            for (std::size_t b = 0; b <= blocks.size(); ++b)
+            {
+                // The last alternative is the empty coalition (i.e., going alone)
+                const std::size_t s = b < blocks.size() ? blocks[b] : 0;
+
+                if (s == c)
+                {
+                    continue;
+                }
+
+                const std::size_t d = s | pbit;
+
+                if (!table.visited[d] || !prefers(k, d, c))
+                {
+                    continue;
+                }
+
+                nash_stable = false;
+
+                if (s == 0 || accepts(d, s))
+                {
+                    ind_stable = false;
+
+                    if (left_accepts)
+                    {
+                        contr_ind_stable = false;
+                    }
+                }
+
+                if (!ind_stable && !contr_ind_stable)
+                {
+                    break;
+                }
+            }
+        }
+
+        // Group deviations: for all coalitions T not in \Pi
+
+        if (core_stable)
+        {
+            for (std::size_t t = 1; t < table.num_masks && core_stable; ++t)
+            {
+                if (!table.visited[t] || player_blocks[lowest_player(t)] == t)
+                {
+                    continue;
+                }
+
+                bool blocking = true;
+                for (std::size_t k = 0; k < np && blocking; ++k)
+                {
+                    if (t & (std::size_t(1) << k))
+                    {
+                        blocking = table.has_payoffs[t*np+k]
+                                   && float_traits::definitely_greater(table.payoffs[t*np+k], table.payoffs[player_blocks[k]*np+k]);
+                    }
+                }
+
+                core_stable = !blocking;
+            }
+        }
+
+        if (nash_stable || ind_stable || contr_ind_stable || core_stable)
+        {
+            auto const partition = make_partition(game, visited_coalitions, table, blocks);
+
+            if (nash_stable)
+            {
+                result[nash_stable_coalition_formation].push_back(partition);
+            }
+            if (ind_stable)
+            {
+                result[individually_stable_coalition_formation].push_back(partition);
+            }
+            if (contr_ind_stable)
+            {
+                result[contractually_individually_stable_coalition_formation].push_back(partition);
+            }
+            if (core_stable)
+            {
+                result[core_stable_coalition_formation].push_back(partition);
+            }
+        }
+    }
+
+    static partition_info_t<RealT> make_partition(const gtpack::cooperative_game<RealT>& game,
+                                                  const std::map<gtpack::cid_type,coalition_info_t<RealT>>& visited_coalitions,
+                                                  const payoff_table_t& table,
+                                                  const std::vector<std::size_t>& blocks)
+    {
+        partition_info_t<RealT> partition;
+
+        partition.value = 0;
+        for (auto const mask : blocks)
+        {
+            auto const cid = table.mask_cids[mask];
+            auto const& coal_info = visited_coalitions.at(cid);
+
+            partition.value += game.value(cid);
+            partition.coalitions.insert(cid);
+
+            for (auto const pid : game.coalition(cid).players())
+            {
+                partition.payoffs[pid] = coal_info.payoffs.count(pid) > 0
+                                         ? coal_info.payoffs.at(pid)
+                                         : std::numeric_limits<RealT>::quiet_NaN();
+            }
+        }
+
+        return partition;
+    }
+
+
+    std::set<coalition_formation_category> categories_; ///< The stability notions to check
+}; // multi_stable_partition_selector_t
+
+}} // Namespace dcs::fgt
+
+
+#endif // DCS_FGT_COALITION_FORMATION_MULTI_STABLE_HPP
@@ -28,18 +28,24 @@
 #define DCS_FGT_COALITION_FORMATION_NASH_STABLE_HPP
 
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <dcs/algorithm/combinatorics.hpp>
 #include <dcs/assert.hpp>
 #include <dcs/fgt/coalition_formation/commons.hpp>
+#include <dcs/fgt/coalition_formation/social_optimum.hpp>
 #include <dcs/debug.hpp>
 #include <dcs/exception.hpp>
 #include <gtpack/cooperative.hpp>
 #include <dcs/math/traits/float.hpp>
+#include <deque>
 #include <limits>
 #include <map>
+#include <mutex>
 #include <set>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 
@@ -48,6 +54,67 @@ namespace dcs { namespace fgt {
 template <typename RealT>
 struct nash_stable_partition_selector_t
 {
+	typedef std::vector<std::uint64_t> fingerprint_type;
+	typedef std::vector<std::vector<gtpack::cid_type>> cached_partitions_type;
+	typedef std::map<fingerprint_type, cached_partitions_type> cache_type;
+
+	/// Maximum number of players for which preference profiles are
+	/// fingerprinted (a fingerprint has \f$n 3^{n-1}\f$ bits, i.e., about
+	/// 260KB for 12 players)
+	static const std::size_t max_fingerprint_num_players = 12;
+
+	/// Maximum number of players for which the best Nash-stable partition is
+	/// searched by branch and bound (the bounds take \f$O(3^n)\f$ time and
+	/// \f$O(2^n)\f$ space, i.e., about \f$4 \cdot 10^7\f$ steps for 16
+	/// players); with more players, all the partitions are enumerated
+	static const std::size_t max_search_num_players = 16;
+
+
+	/// With \a best_partition_only, a Nash-stable partition with the maximum
+	/// value is searched in place of all the Nash-stable partitions (see
+	/// \c search_best_partition), unless the preference profile is cached.
+	/// With a positive \a max_num_blocks, only the partitions into at most
+	/// \a max_num_blocks coalitions are considered.
+	explicit nash_stable_partition_selector_t(std::size_t cache_max_size = 0, bool best_partition_only = false, std::size_t max_num_blocks = 0)
+	: cache_max_size_(cache_max_size),
+	  best_partition_only_(best_partition_only),
+	  max_num_blocks_(max_num_blocks),
+	  num_cache_hits_(0),
+	  num_cache_misses_(0)
+	{
+	}
+
+	nash_stable_partition_selector_t(const nash_stable_partition_selector_t& that)
+	{
+		std::lock_guard<std::mutex> lock(that.mutex_);
+
+		cache_max_size_ = that.cache_max_size_;
+		best_partition_only_ = that.best_partition_only_;
+		max_num_blocks_ = that.max_num_blocks_;
+		this->copy_cache(that);
+		num_cache_hits_ = that.num_cache_hits_;
+		num_cache_misses_ = that.num_cache_misses_;
+	}
+
+	nash_stable_partition_selector_t& operator=(const nash_stable_partition_selector_t& rhs)
+	{
+		if (this != &rhs)
+		{
+			std::lock(mutex_, rhs.mutex_);
+			std::lock_guard<std::mutex> lock(mutex_, std::adopt_lock);
+			std::lock_guard<std::mutex> rhs_lock(rhs.mutex_, std::adopt_lock);
+
+			cache_max_size_ = rhs.cache_max_size_;
+			best_partition_only_ = rhs.best_partition_only_;
+			max_num_blocks_ = rhs.max_num_blocks_;
+			this->copy_cache(rhs);
+			num_cache_hits_ = rhs.num_cache_hits_;
+			num_cache_misses_ = rhs.num_cache_misses_;
+		}
+
+		return *this;
+	}
+
 #if 0
 	std::vector<partition_info_t<RealT>> operator()(const gtpack::cooperative_game<RealT>& game, const std::map<gtpack::cid_type,coalition_info_t<RealT>>& visited_coalitions)
 	{
@@ -177,6 +244,96 @@ struct nash_stable_partition_selector_t
 #endif
 
 	std::vector<partition_info_t<RealT>> operator()(const gtpack::cooperative_game<RealT>& game, const std::map<gtpack::cid_type,coalition_info_t<RealT>>& visited_coalitions)
+	{
+		// The set of Nash-stable partitions only depends on the outcome of the
+		// preference tests performed by check_nash_stability, so if the same
+		// outcomes have already been seen, the cached partitions are re-valued
+		// with the current payoffs instead of enumerating all the partitions.
+
+		fingerprint_type fingerprint;
+
+		if (cache_max_size_ == 0 || !make_preference_fingerprint(game, visited_coalitions, fingerprint))
+		{
+			return best_partition_only_
+				   ? this->search_best_partition(game, visited_coalitions)
+				   : this->enumerate_partitions(game, visited_coalitions);
+		}
+
+		// The cache is shared by concurrent callers, but partitions are
+		// enumerated and re-valued outside the lock
+		bool cache_hit = false;
+		cached_partitions_type cached_partitions;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			auto const cache_it = cache_.find(fingerprint);
+			if (cache_it != cache_.end())
+			{
+				cache_hit = true;
+				cached_partitions = cache_it->second;
+				++num_cache_hits_;
+			}
+			else
+			{
+				++num_cache_misses_;
+			}
+		}
+
+		if (cache_hit)
+		{
+			DCS_DEBUG_TRACE("Preference profile found in cache: reusing " << cached_partitions.size() << " Nash-stable partitions");
+
+			return make_partitions(game, visited_coalitions, cached_partitions);
+		}
+
+		if (best_partition_only_)
+		{
+			// The best partition is not enough to re-value other games with
+			// the same preference profile, so it is not cached
+			return this->search_best_partition(game, visited_coalitions);
+		}
+
+		std::vector<partition_info_t<RealT>> best_partitions = this->enumerate_partitions(game, visited_coalitions);
+
+		for (auto const& best_partition : best_partitions)
+		{
+			cached_partitions.push_back(std::vector<gtpack::cid_type>(best_partition.coalitions.begin(), best_partition.coalitions.end()));
+		}
+
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		// Another caller may have enumerated the same preference profile meanwhile
+		if (cache_.count(fingerprint) > 0)
+		{
+			return best_partitions;
+		}
+
+		// Evict the oldest preference profile when the cache is full
+		if (cache_.size() >= cache_max_size_)
+		{
+			cache_.erase(cache_order_.front());
+			cache_order_.pop_front();
+		}
+		cache_order_.push_back(cache_.insert(std::make_pair(std::move(fingerprint), std::move(cached_partitions))).first);
+
+		return best_partitions;
+	}
+
+	std::size_t num_cache_hits() const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		return num_cache_hits_;
+	}
+
+	std::size_t num_cache_misses() const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		return num_cache_misses_;
+	}
+
+	std::vector<partition_info_t<RealT>> enumerate_partitions(const gtpack::cooperative_game<RealT>& game, const std::map<gtpack::cid_type,coalition_info_t<RealT>>& visited_coalitions)
 	{
 		namespace alg = dcs::algorithm;
 		namespace gt = gtpack;
@@ -188,61 +345,124 @@ struct nash_stable_partition_selector_t
 		auto const players = game.players();
 		auto const np = players.size();
 
-		alg::lexicographic_partition partition(np);
-
-		while (partition.has_next())
+		// The number of coalitions is only computed for fewer players than
+		// bits in a CID (with more players, some coalitions have no CID and
+		// thus cannot be visited)
+		if (np >= static_cast<std::size_t>(std::numeric_limits<gt::cid_type>::digits)
+			|| visited_coalitions.size()+1 < (static_cast<gt::cid_type>(1) << np))
 		{
-			// Each subset is a collection of coalitions
-			auto subsets = alg::next_partition(players.begin(), players.end(), partition);
+			// Only some coalitions can form (e.g., because of the topology
+			// among players), so only partitions into such coalitions are
+			// generated
+			return this->enumerate_restricted_partitions(game, visited_coalitions);
+		}
 
-			DCS_DEBUG_TRACE("--- PARTITION: " << partition);//XXX
+		if (max_num_blocks_ == 0 || max_num_blocks_ >= np)
+		{
+			alg::lexicographic_partition partition(np);
 
-			partition_info_t<RealT> candidate_partition;
+			while (partition.has_next())
+			{
+				DCS_DEBUG_TRACE("--- PARTITION: " << partition);//XXX
 
-            candidate_partition.value = 0;
-			for (auto const& subset : subsets)
+				// Each subset is a collection of coalitions
+				this->select_nash_stable_partition(game, visited_coalitions, alg::next_partition(players.begin(), players.end(), partition), best_partitions);
+			}
+		}
+		else
+		{
+			// Only the partitions into at most max_num_blocks_ coalitions
+			for (std::size_t k = 1; k <= max_num_blocks_; ++k)
 			{
-				const gt::cid_type cid = gt::make_coalition_id(subset.begin(), subset.end());
+				alg::lexicographic_k_partition partition(np, k);
 
-				if (visited_coalitions.count(cid) == 0)
+				while (partition.has_next())
 				{
-					continue;
+					DCS_DEBUG_TRACE("--- PARTITION: " << partition);//XXX
+
+					this->select_nash_stable_partition(game, visited_coalitions, alg::next_partition(players.begin(), players.end(), partition), best_partitions);
 				}
+			}
+		}
 
-				DCS_DEBUG_TRACE("--- COALITION: " << game.coalition(cid) << ", VALUE: " << game.value(cid) << " (CID=" << cid << ")");//XXX
+		return best_partitions;
+	}
 
-                candidate_partition.value += game.value(cid);
-				candidate_partition.coalitions.insert(cid);
+	/// Generates the partitions whose blocks are all visited coalitions, and
+	/// selects the ones that are Nash-stable
+	std::vector<partition_info_t<RealT>> enumerate_restricted_partitions(const gtpack::cooperative_game<RealT>& game, const std::map<gtpack::cid_type,coalition_info_t<RealT>>& visited_coalitions)
+	{
+		namespace gt = gtpack;
 
-				for (auto pid : subset)
-				{
-					if (visited_coalitions.at(cid).payoffs.count(pid) > 0)
-					{
-						candidate_partition.payoffs[pid] = visited_coalitions.at(cid).payoffs.at(pid);
-					}
-					else
-					{
-						candidate_partition.payoffs[pid] = std::numeric_limits<RealT>::quiet_NaN();
-					}
-				}
-			}
+		// Group the visited coalitions by their lowest player, so that every
+		// partition is generated once by assigning the lowest unassigned
+		// player to one of the coalitions it can join
 
-            bool nash_stable = check_nash_stability(game, visited_coalitions, candidate_partition.coalitions.begin(), candidate_partition.coalitions.end());
-    DCS_DEBUG_TRACE("OUTSIDE NASH STABLE: " << nash_stable);
+		auto const players = game.players();
 
-			if (nash_stable)
-			{
-				best_partitions.push_back(candidate_partition);
-for (auto const& best_partition : best_partitions)
-{
-    DCS_DEBUG_TRACE("Best partition: " << best_partition.value);
-}
-			}
+		gt::cid_type grand_cid = gt::empty_cid;
+		std::map<gt::pid_type, std::vector<gt::cid_type>> lowest_player_cids;
+		for (auto const& coal_info : visited_coalitions)
+		{
+			auto const cid = coal_info.first;
+			auto const coal_players = game.coalition(cid).players();
+
+			lowest_player_cids[*std::min_element(coal_players.begin(), coal_players.end())].push_back(cid);
 		}
+		for (auto pid : players)
+		{
+			grand_cid |= gt::make_coalition_id(pid);
+		}
+
+		std::vector<partition_info_t<RealT>> best_partitions;
+		std::vector<gt::cid_type> blocks;
+
+		this->enumerate_restricted_partitions(game, visited_coalitions, lowest_player_cids, grand_cid, blocks, best_partitions);
 
 		return best_partitions;
 	}
 
+	/**
+	 * Searches a Nash-stable partition with the maximum value, and returns it
+	 * (or nothing, if there is no Nash-stable partition).
+	 *
+	 * Partitions are generated by assigning the lowest unassigned player to
+	 * one of the visited coalitions it can join, trying first the coalitions
+	 * that lead to the partitions with the highest value.
+	 * The value of the best partition of the unassigned players (see
+	 * \c make_coalition_structure_table) bounds the value that can still be
+	 * added, so the search stops as soon as no remaining partition can beat
+	 * the best Nash-stable partition found so far, and Nash-stability is only
+	 * checked for the partitions that can.
+	 * Among partitions with the same value, the one returned may differ from
+	 * the first one found by \c enumerate_partitions.
+	 * With more than \c max_search_num_players players, the Nash-stable
+	 * partitions are enumerated instead.
+	 */
+	std::vector<partition_info_t<RealT>> search_best_partition(const gtpack::cooperative_game<RealT>& game, const std::map<gtpack::cid_type,coalition_info_t<RealT>>& visited_coalitions)
+	{
+		coalition_structure_table_t<RealT> table;
+
+		if (!make_coalition_structure_table(game, visited_coalitions, max_search_num_players, table))
+		{
+			return this->enumerate_partitions(game, visited_coalitions);
+		}
+
+		std::vector<gtpack::cid_type> blocks;
+		std::vector<gtpack::cid_type> best_blocks;
+		RealT best_value = -std::numeric_limits<RealT>::infinity();
+		bool found = false;
+
+		this->search_best_partition(game, visited_coalitions, table, table.best_values.size()-1, 0, blocks, found, best_value, best_blocks);
+
+		if (!found)
+		{
+			return std::vector<partition_info_t<RealT>>();
+		}
+
+		return make_partitions(game, visited_coalitions, cached_partitions_type(1, best_blocks));
+	}
+
     template <typename CidIterT>
     bool check_nash_stability(const gtpack::cooperative_game<RealT>& game,
                               const std::map<gtpack::cid_type,coalition_info_t<RealT>>& visited_coalitions,
@@ -273,8 +493,10 @@ for (auto const& best_partition : best_partitions)
             for (std::size_t i = 0; i < np && nash_stable; ++i)
             {
                 const gtpack::pid_type pid = players[i];
+                // A missing payoff is read as NaN, as done for candidate partitions
+                const RealT payoff = visited_coalitions.at(cid1).payoffs.count(pid) ? visited_coalitions.at(cid1).payoffs.at(pid) : std::numeric_limits<RealT>::quiet_NaN();
 
-                DCS_DEBUG_TRACE("Evaluating PID: " << pid << " - PAYOFF: " << (visited_coalitions.at(cid1).payoffs.count(pid) ? visited_coalitions.at(cid1).payoffs.at(pid) : std::numeric_limits<RealT>::quiet_NaN())); //XXX
+                DCS_DEBUG_TRACE("Evaluating PID: " << pid << " - PAYOFF: " << payoff); //XXX
 
                 // Check Nash-stability for current player over all coalitions' partition (\f$S_k in \Pi\f$)
                 for (partition_iterator part_it = partition.begin();
@@ -294,11 +516,17 @@ for (auto const& best_partition : best_partitions)
                     cid2_players.push_back(pid);
                     cid2 = gtpack::make_coalition_id(cid2_players.begin(), cid2_players.end());
 
+                    // Skip deviations to coalitions that cannot form
+                    if (visited_coalitions.count(cid2) == 0)
+                    {
+                        continue;
+                    }
+
                     DCS_DEBUG_TRACE("--- PID: " << pid << " - AUGMENTED COALITION: " << game.coalition(cid2) << " (CID=" << cid2 << ") - AUGMENTED PAYOFF: " << (visited_coalitions.at(cid2).payoffs.count(pid) ? visited_coalitions.at(cid2).payoffs.at(pid) : std::numeric_limits<RealT>::quiet_NaN()) << " - CANDIDATE PAYOFF: " << (visited_coalitions.at(cid1).payoffs.count(pid) ? visited_coalitions.at(cid1).payoffs.at(pid) : std::numeric_limits<RealT>::quiet_NaN()));///XXX
 
                     // Check preference
                     if (visited_coalitions.at(cid2).payoffs.count(pid) == 0
-                        || dcs::math::float_traits<RealT>::definitely_greater(visited_coalitions.at(cid2).payoffs.at(pid), visited_coalitions.at(cid1).payoffs.at(pid)))
+                        || dcs::math::float_traits<RealT>::definitely_greater(visited_coalitions.at(cid2).payoffs.at(pid), payoff))
                     {
 						DCS_DEBUG_TRACE("--- PID: " << pid << " - AUGMENTED COALITION: " << game.coalition(cid2) << " (CID=" << cid2 << "): NOT NASH STABLE");//XXX
                         nash_stable = false;
@@ -316,7 +544,7 @@ for (auto const& best_partition : best_partitions)
 
                     // This partition doesn't contain this singleton coalition
                     if (visited_coalitions.at(cid2).payoffs.count(pid) == 0
-                        || dcs::math::float_traits<RealT>::definitely_greater(visited_coalitions.at(cid2).payoffs.at(pid), visited_coalitions.at(cid1).payoffs.at(pid)))
+                        || dcs::math::float_traits<RealT>::definitely_greater(visited_coalitions.at(cid2).payoffs.at(pid), payoff))
                     {
                         DCS_DEBUG_TRACE("--- PID: " << pid << " - AUGMENTED COALITION: " << game.coalition(cid2) << " (CID=" << cid2 << "): NOT NASH STABLE");//XXX
                         nash_stable = false;
@@ -330,6 +558,340 @@ DCS_DEBUG_TRACE("INSIDE NASH STABLE: " << nash_stable);
         return nash_stable;
     }
 
+
+private:
+	/// Adds the partition into the given subsets of players to the given
+	/// partitions, if it is Nash-stable
+	template <typename SubsetsT>
+	void select_nash_stable_partition(const gtpack::cooperative_game<RealT>& game,
+									  const std::map<gtpack::cid_type,coalition_info_t<RealT>>& visited_coalitions,
+									  const SubsetsT& subsets,
+									  std::vector<partition_info_t<RealT>>& best_partitions)
+	{
+		namespace gt = gtpack;
+
+		partition_info_t<RealT> candidate_partition;
+
+		candidate_partition.value = 0;
+		for (auto const& subset : subsets)
+		{
+			const gt::cid_type cid = gt::make_coalition_id(subset.begin(), subset.end());
+
+			if (visited_coalitions.count(cid) == 0)
+			{
+				continue;
+			}
+
+			DCS_DEBUG_TRACE("--- COALITION: " << game.coalition(cid) << ", VALUE: " << game.value(cid) << " (CID=" << cid << ")");//XXX
+
+			candidate_partition.value += game.value(cid);
+			candidate_partition.coalitions.insert(cid);
+
+			for (auto pid : subset)
+			{
+				if (visited_coalitions.at(cid).payoffs.count(pid) > 0)
+				{
+					candidate_partition.payoffs[pid] = visited_coalitions.at(cid).payoffs.at(pid);
+				}
+				else
+				{
+					candidate_partition.payoffs[pid] = std::numeric_limits<RealT>::quiet_NaN();
+				}
+			}
+		}
+
+		bool nash_stable = check_nash_stability(game, visited_coalitions, candidate_partition.coalitions.begin(), candidate_partition.coalitions.end());
+		DCS_DEBUG_TRACE("OUTSIDE NASH STABLE: " << nash_stable);
+
+		if (nash_stable)
+		{
+			DCS_DEBUG_TRACE("Best partition: " << candidate_partition.value);
+
+			best_partitions.push_back(candidate_partition);
+		}
+	}
+
+	void enumerate_restricted_partitions(const gtpack::cooperative_game<RealT>& game,
+										 const std::map<gtpack::cid_type,coalition_info_t<RealT>>& visited_coalitions,
+										 const std::map<gtpack::pid_type, std::vector<gtpack::cid_type>>& lowest_player_cids,
+										 gtpack::cid_type unassigned_cid,
+										 std::vector<gtpack::cid_type>& blocks,
+										 std::vector<partition_info_t<RealT>>& best_partitions)
+	{
+		namespace gt = gtpack;
+
+		if (unassigned_cid == gt::empty_cid)
+		{
+			if (check_nash_stability(game, visited_coalitions, blocks.begin(), blocks.end()))
+			{
+				best_partitions.push_back(make_partitions(game, visited_coalitions, cached_partitions_type(1, blocks)).front());
+			}
+
+			return;
+		}
+
+		// Find the lowest unassigned player
+		gt::pid_type pid = 0;
+		while (!(unassigned_cid & gt::make_coalition_id(pid)))
+		{
+			++pid;
+		}
+
+		auto const it = lowest_player_cids.find(pid);
+		if (it == lowest_player_cids.end() || (max_num_blocks_ > 0 && blocks.size() >= max_num_blocks_))
+		{
+			return;
+		}
+
+		for (auto const cid : it->second)
+		{
+			if ((cid & unassigned_cid) == cid)
+			{
+				blocks.push_back(cid);
+				this->enumerate_restricted_partitions(game, visited_coalitions, lowest_player_cids, unassigned_cid & ~cid, blocks, best_partitions);
+				blocks.pop_back();
+			}
+		}
+	}
+
+	void search_best_partition(const gtpack::cooperative_game<RealT>& game,
+							   const std::map<gtpack::cid_type,coalition_info_t<RealT>>& visited_coalitions,
+							   const coalition_structure_table_t<RealT>& table,
+							   std::size_t unassigned_mask,
+							   RealT value,
+							   std::vector<gtpack::cid_type>& blocks,
+							   bool& found,
+							   RealT& best_value,
+							   std::vector<gtpack::cid_type>& best_blocks)
+	{
+		if (unassigned_mask == 0)
+		{
+			if (check_nash_stability(game, visited_coalitions, blocks.begin(), blocks.end()))
+			{
+				found = true;
+				best_value = value;
+				best_blocks = blocks;
+			}
+
+			return;
+		}
+
+		if (max_num_blocks_ > 0 && blocks.size() >= max_num_blocks_)
+		{
+			// The block limit is not part of the bounds, which thus still hold
+			return;
+		}
+
+		// Candidate blocks with the lowest unassigned player, by decreasing
+		// bound of the value of the partitions they lead to
+		const std::size_t low_bit = unassigned_mask & (~unassigned_mask+1);
+		const std::size_t rest = unassigned_mask & ~low_bit;
+
+		std::vector<std::pair<RealT,std::size_t>> candidates;
+		for (std::size_t s = rest; ; s = (s-1) & rest)
+		{
+			const std::size_t block = s | low_bit;
+			const RealT bound = value + table.values[block] + table.best_values[unassigned_mask & ~block];
+
+			if (bound > -std::numeric_limits<RealT>::infinity())
+			{
+				candidates.push_back(std::make_pair(bound, block));
+			}
+
+			if (s == 0)
+			{
+				break;
+			}
+		}
+		std::sort(candidates.begin(), candidates.end(),
+				  [](const std::pair<RealT,std::size_t>& a, const std::pair<RealT,std::size_t>& b)
+				  {
+					  return a.first > b.first;
+				  });
+
+		for (auto const& candidate : candidates)
+		{
+			if (found && candidate.first <= best_value)
+			{
+				// Neither this nor the next candidates can beat the best partition
+				break;
+			}
+
+			auto const block = candidate.second;
+
+			blocks.push_back(table.mask_cids[block]);
+			this->search_best_partition(game, visited_coalitions, table, unassigned_mask & ~block, value + table.values[block], blocks, found, best_value, best_blocks);
+			blocks.pop_back();
+		}
+	}
+
+    /**
+     * Packs into a bit string the outcome of the preference test used by
+     * check_nash_stability for every player \f$i\f$ and every pair of
+     * coalitions \f$C\f$ and \f$D\f$ such that \f$C \cap D = \{i\}\f$.
+     * These are all the comparisons that Nash-stability can ever depend on.
+     *
+     * Returns \c false (and leaves the fingerprint empty) if some coalition
+     * has not been visited or if there are too many players.
+     */
+    static bool make_preference_fingerprint(const gtpack::cooperative_game<RealT>& game,
+                                            const std::map<gtpack::cid_type,coalition_info_t<RealT>>& visited_coalitions,
+                                            fingerprint_type& fingerprint)
+    {
+        namespace gt = gtpack;
+
+        fingerprint.clear();
+
+        auto const players = game.players();
+        auto const np = players.size();
+
+        if (np == 0 || np > max_fingerprint_num_players)
+        {
+            return false;
+        }
+
+        // Dense payoff table indexed by (player-index bitmask, player index)
+
+        const std::size_t num_masks = std::size_t(1) << np;
+        std::vector<gt::cid_type> mask_cids(num_masks, gt::empty_cid);
+        std::vector<RealT> payoffs(num_masks*np, std::numeric_limits<RealT>::quiet_NaN());
+        std::vector<bool> has_payoffs(num_masks*np, false);
+        for (std::size_t mask = 1; mask < num_masks; ++mask)
+        {
+            std::size_t low = 0;
+            while (!(mask & (std::size_t(1) << low)))
+            {
+                ++low;
+            }
+            mask_cids[mask] = mask_cids[mask & (mask-1)] | gt::make_coalition_id(players[low]);
+
+            auto const coal_it = visited_coalitions.find(mask_cids[mask]);
+            if (coal_it == visited_coalitions.end())
+            {
+                return false;
+            }
+            for (std::size_t k = low; k < np; ++k)
+            {
+                if (mask & (std::size_t(1) << k))
+                {
+                    auto const payoff_it = coal_it->second.payoffs.find(players[k]);
+                    if (payoff_it != coal_it->second.payoffs.end())
+                    {
+                        payoffs[mask*np+k] = payoff_it->second;
+                        has_payoffs[mask*np+k] = true;
+                    }
+                }
+            }
+        }
+
+        fingerprint.push_back(np);
+
+        std::uint64_t word = 0;
+        std::size_t num_bits = 0;
+        for (std::size_t k = 0; k < np; ++k)
+        {
+            const std::size_t pbit = std::size_t(1) << k;
+            const std::size_t others = (num_masks-1) & ~pbit;
+
+            // For all C = {i} \cup S, with S \subseteq N \setminus \{i\}
+            for (std::size_t s = others; ; s = (s-1) & others)
+            {
+                const std::size_t c = s | pbit;
+                const RealT payoff = payoffs[c*np+k];
+                const std::size_t rest = others & ~s;
+
+                // For all D = {i} \cup T, with T \subseteq N \setminus C
+                for (std::size_t t = rest; ; t = (t-1) & rest)
+                {
+                    const std::size_t d = t | pbit;
+                    const bool prefers = !has_payoffs[d*np+k]
+                                         || dcs::math::float_traits<RealT>::definitely_greater(payoffs[d*np+k], payoff);
+
+                    if (prefers)
+                    {
+                        word |= std::uint64_t(1) << num_bits;
+                    }
+                    if (++num_bits == 64)
+                    {
+                        fingerprint.push_back(word);
+                        word = 0;
+                        num_bits = 0;
+                    }
+
+                    if (t == 0)
+                    {
+                        break;
+                    }
+                }
+
+                if (s == 0)
+                {
+                    break;
+                }
+            }
+        }
+        if (num_bits > 0)
+        {
+            fingerprint.push_back(word);
+        }
+
+        return true;
+    }
+
+    /// Copies the cached preference profiles of the given selector, pointing
+    /// the eviction order to the copies (the caller must hold both locks)
+    void copy_cache(const nash_stable_partition_selector_t& that)
+    {
+        cache_ = that.cache_;
+        cache_order_.clear();
+        for (auto const& that_it : that.cache_order_)
+        {
+            cache_order_.push_back(cache_.find(that_it->first));
+        }
+    }
+
+    /// Rebuilds the given partitions with the current coalition values and payoffs
+    static std::vector<partition_info_t<RealT>> make_partitions(const gtpack::cooperative_game<RealT>& game,
+                                                                const std::map<gtpack::cid_type,coalition_info_t<RealT>>& visited_coalitions,
+                                                                const cached_partitions_type& partitions)
+    {
+        std::vector<partition_info_t<RealT>> best_partitions;
+
+        for (auto const& partition : partitions)
+        {
+            partition_info_t<RealT> best_partition;
+
+            best_partition.value = 0;
+            for (auto const cid : partition)
+            {
+                auto const& coal_info = visited_coalitions.at(cid);
+
+                best_partition.value += game.value(cid);
+                best_partition.coalitions.insert(cid);
+
+                for (auto const pid : game.coalition(cid).players())
+                {
+                    best_partition.payoffs[pid] = coal_info.payoffs.count(pid) > 0
+                                                  ? coal_info.payoffs.at(pid)
+                                                  : std::numeric_limits<RealT>::quiet_NaN();
+                }
+            }
+
+            best_partitions.push_back(best_partition);
+        }
+
+        return best_partitions;
+    }
+
+
+    std::size_t cache_max_size_; ///< Maximum number of cached preference profiles (0 disables the cache)
+    bool best_partition_only_; ///< Tells if only a Nash-stable partition with the maximum value is searched
+    std::size_t max_num_blocks_; ///< Maximum number of coalitions in a partition (0 means no limit)
+    cache_type cache_; ///< Nash-stable partitions, by preference profile
+    std::deque<typename cache_type::iterator> cache_order_; ///< Cached preference profiles, from the oldest to the newest
+    std::size_t num_cache_hits_;
+    std::size_t num_cache_misses_;
+    mutable std::mutex mutex_; ///< Protects the cache from concurrent callers
 }; // nash_stable_partition_selector_t
 
 }} // Namespace dcs::fgt
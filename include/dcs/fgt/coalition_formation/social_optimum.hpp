@@ -0,0 +1,192 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file dcs/fgt/coalition_formation/social_optimum.hpp
+ *
+ * \brief Welfare-maximizing partitions (coalition structures) of a game.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_FGT_COALITION_FORMATION_SOCIAL_OPTIMUM_HPP
+#define DCS_FGT_COALITION_FORMATION_SOCIAL_OPTIMUM_HPP
+
+
+#include <cstddef>
+#include <dcs/fgt/coalition_formation/commons.hpp>
+#include <gtpack/cooperative.hpp>
+#include <limits>
+#include <map>
+#include <vector>
+
+
+namespace dcs { namespace fgt {
+
+/**
+ * \brief Dense table of the best partitions of every subset of the players
+ *  of a game.
+ *
+ * Subsets of players are indexed by bitmasks over the positions of players
+ * in \c players.
+ * The value of a subset is the value of its coalition, or minus infinity if
+ * the coalition cannot form (i.e., it has not been visited).
+ * The best value of a subset is the maximum total value of the partitions of
+ * that subset into coalitions that can form (minus infinity if there is
+ * none), and thus an upper bound of the value of any such partition.
+ */
+template <typename RealT>
+struct coalition_structure_table_t
+{
+	std::vector<gtpack::pid_type> players; ///< The players of the game
+	std::vector<gtpack::cid_type> mask_cids; ///< The CID, by subset
+	std::vector<RealT> values; ///< The coalition value, by subset
+	std::vector<RealT> best_values; ///< The value of the best partition, by subset
+	std::vector<std::size_t> best_blocks; ///< The block with the first player in the best partition, by subset
+}; // coalition_structure_table_t
+
+
+/**
+ * Fills the given table of best partitions by dynamic programming over the
+ * subsets of players (in \f$O(3^n)\f$ time and \f$O(2^n)\f$ space, for
+ * \f$n\f$ players).
+ *
+ * The best partition of a subset is found by trying every block with the
+ * first player of the subset, together with the best partition of the rest of
+ * the subset.
+ *
+ * Returns \c false (and leaves the table empty) if there are more than
+ * \a max_num_players players.
+ */
+template <typename RealT>
+bool make_coalition_structure_table(const gtpack::cooperative_game<RealT>& game,
+									const std::map<gtpack::cid_type,coalition_info_t<RealT>>& visited_coalitions,
+									std::size_t max_num_players,
+									coalition_structure_table_t<RealT>& table)
+{
+	namespace gt = gtpack;
+
+	table = coalition_structure_table_t<RealT>();
+
+	auto const players = game.players();
+	auto const np = players.size();
+
+	if (np > max_num_players || np >= std::numeric_limits<std::size_t>::digits)
+	{
+		return false;
+	}
+
+	const std::size_t num_masks = std::size_t(1) << np;
+
+	table.players = players;
+	table.mask_cids.assign(num_masks, gt::empty_cid);
+	table.values.assign(num_masks, -std::numeric_limits<RealT>::infinity());
+	table.best_values.assign(num_masks, -std::numeric_limits<RealT>::infinity());
+	table.best_blocks.assign(num_masks, 0);
+
+	table.best_values[0] = 0;
+	for (std::size_t mask = 1; mask < num_masks; ++mask)
+	{
+		std::size_t low = 0;
+		while (!(mask & (std::size_t(1) << low)))
+		{
+			++low;
+		}
+		const std::size_t low_bit = std::size_t(1) << low;
+
+		table.mask_cids[mask] = table.mask_cids[mask & ~low_bit] | gt::make_coalition_id(players[low]);
+		if (visited_coalitions.count(table.mask_cids[mask]) > 0)
+		{
+			table.values[mask] = game.value(table.mask_cids[mask]);
+		}
+
+		// Every block with the lowest player, plus the best partition of the rest
+		const std::size_t rest = mask & ~low_bit;
+		for (std::size_t s = rest; ; s = (s-1) & rest)
+		{
+			const std::size_t block = s | low_bit;
+			const RealT value = table.values[block] + table.best_values[mask & ~block];
+
+			if (value > table.best_values[mask])
+			{
+				table.best_values[mask] = value;
+				table.best_blocks[mask] = block;
+			}
+
+			if (s == 0)
+			{
+				break;
+			}
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Finds a partition of the players of the given game into visited coalitions
+ * with the maximum total value (i.e., the social optimum), by dynamic
+ * programming (see \c make_coalition_structure_table).
+ *
+ * Returns a partition with no coalition and a value of minus infinity if no
+ * such partition exists or if there are more than \a max_num_players players.
+ */
+template <typename RealT>
+partition_info_t<RealT> find_social_optimum(const gtpack::cooperative_game<RealT>& game,
+											const std::map<gtpack::cid_type,coalition_info_t<RealT>>& visited_coalitions,
+											std::size_t max_num_players = 20)
+{
+	partition_info_t<RealT> partition;
+
+	coalition_structure_table_t<RealT> table;
+	if (!make_coalition_structure_table(game, visited_coalitions, max_num_players, table))
+	{
+		return partition;
+	}
+
+	std::size_t mask = table.best_values.size()-1;
+	if (table.best_values[mask] == -std::numeric_limits<RealT>::infinity())
+	{
+		return partition;
+	}
+
+	partition.value = table.best_values[mask];
+	while (mask != 0)
+	{
+		auto const block = table.best_blocks[mask];
+		auto const cid = table.mask_cids[block];
+		auto const& coal_info = visited_coalitions.at(cid);
+
+		partition.coalitions.insert(cid);
+		for (auto const pid : game.coalition(cid).players())
+		{
+			partition.payoffs[pid] = coal_info.payoffs.count(pid) > 0
+									 ? coal_info.payoffs.at(pid)
+									 : std::numeric_limits<RealT>::quiet_NaN();
+		}
+
+		mask &= ~block;
+	}
+
+	return partition;
+}
+
+}} // Namespace dcs::fgt
+
+
+#endif // DCS_FGT_COALITION_FORMATION_SOCIAL_OPTIMUM_HPP
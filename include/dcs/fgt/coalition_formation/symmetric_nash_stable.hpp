@@ -0,0 +1,314 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file dcs/fgt/coalition_formation/symmetric_nash_stable.hpp
+ *
+ * \brief Formation of Nash-stable coalitions among interchangeable players.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_FGT_COALITION_FORMATION_SYMMETRIC_NASH_STABLE_HPP
+#define DCS_FGT_COALITION_FORMATION_SYMMETRIC_NASH_STABLE_HPP
+
+
+#include <algorithm>
+#include <cstddef>
+#include <dcs/algorithm/combinatorics.hpp>
+#include <dcs/assert.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/fgt/coalition_formation/commons.hpp>
+#include <dcs/fgt/coalition_formation/nash_stable.hpp>
+#include <gtpack/cooperative.hpp>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+
+namespace dcs { namespace fgt {
+
+/**
+ * Selects Nash-stable partitions by exploiting the symmetry among
+ * interchangeable players.
+ *
+ * Players are grouped into equivalence classes, such that swapping two players
+ * of the same class maps the game onto itself.
+ * Two partitions that only differ by such swaps (i.e., that belong to the same
+ * orbit) have the same stability verdict, so only one representative partition
+ * per orbit is checked.
+ * Orbits are in one-to-one correspondence with the partitions of the multiset
+ * of player classes, and thus, for a game of n identical players, only p(n)
+ * (i.e., the number of integer partitions of n) partitions are checked instead
+ * of Bell(n).
+ * The orbits of the stable representatives are then expanded, so that the
+ * same partitions returned by nash_stable_partition_selector_t are returned.
+ */
+template <typename RealT>
+struct symmetric_nash_stable_partition_selector_t
+{
+    /// Builds the selector from the equivalence class of each player, in the
+    /// order given by gtpack::cooperative_game::players()
+    template <typename IterT>
+    symmetric_nash_stable_partition_selector_t(IterT first_class, IterT last_class)
+    : player_classes_(first_class, last_class)
+    {
+    }
+
+    std::vector<partition_info_t<RealT>> operator()(const gtpack::cooperative_game<RealT>& game, const std::map<gtpack::cid_type,coalition_info_t<RealT>>& visited_coalitions)
+    {
+        namespace alg = dcs::algorithm;
+        namespace gt = gtpack;
+
+        auto const players = game.players();
+        auto const np = players.size();
+
+        DCS_ASSERT(player_classes_.size() == np,
+                   DCS_EXCEPTION_THROW(std::invalid_argument, "Number of player classes does not match the number of players"));
+
+        // Group players by class
+
+        std::map<std::size_t,std::vector<gt::pid_type>> class_players;
+        for (std::size_t p = 0; p < np; ++p)
+        {
+            class_players[player_classes_[p]].push_back(players[p]);
+        }
+
+        std::vector<std::vector<gt::pid_type>> members;
+        std::vector<std::size_t> multiplicities;
+        for (auto const& class_info : class_players)
+        {
+            members.push_back(class_info.second);
+            multiplicities.push_back(class_info.second.size());
+        }
+
+        // Generate a representative partition for each orbit and select the
+        // ones that are Nash-stable
+
+        std::vector<partition_info_t<RealT>> best_partitions;
+        nash_stable_partition_selector_t<RealT> nash_selector;
+
+        alg::multiset_partition partition(multiplicities);
+
+        while (partition.has_next())
+        {
+            auto const blocks = partition();
+
+            ++partition;
+
+            DCS_DEBUG_TRACE("--- ORBIT: " << blocks.size() << " coalitions");
+
+            // The representative partition takes, for each coalition, the
+            // first players of each class not yet assigned to previous
+            // coalitions
+            std::vector<std::size_t> next_members(members.size(), 0);
+            std::vector<gt::cid_type> cids;
+            bool visited_all = true;
+            for (auto const& block : blocks)
+            {
+                gt::cid_type cid = gt::empty_cid;
+                for (std::size_t c = 0; c < block.size(); ++c)
+                {
+                    for (std::size_t q = 0; q < block[c]; ++q)
+                    {
+                        cid |= gt::make_coalition_id(members[c][next_members[c]++]);
+                    }
+                }
+
+                if (visited_coalitions.count(cid) == 0)
+                {
+                    visited_all = false;
+                }
+                cids.push_back(cid);
+            }
+
+            if (!visited_all)
+            {
+                continue;
+            }
+
+            if (!nash_selector.check_nash_stability(game, visited_coalitions, cids.begin(), cids.end()))
+            {
+                continue;
+            }
+
+            // Expand the orbit of the stable representative
+
+            std::vector<std::vector<gt::cid_type>> orbit;
+            orbit_expansion_t expansion(blocks, members, orbit);
+
+            expansion.expand(0, 0, members[0]);
+
+            DCS_DEBUG_TRACE("--- STABLE ORBIT: " << orbit.size() << " partitions");
+
+            for (auto const& orbit_cids : orbit)
+            {
+                partition_info_t<RealT> best_partition;
+
+                best_partition.value = 0;
+                for (auto const cid : orbit_cids)
+                {
+                    auto const& coal_info = visited_coalitions.at(cid);
+
+                    best_partition.value += game.value(cid);
+                    best_partition.coalitions.insert(cid);
+
+                    for (auto const pid : game.coalition(cid).players())
+                    {
+                        best_partition.payoffs[pid] = coal_info.payoffs.count(pid) > 0
+                                                      ? coal_info.payoffs.at(pid)
+                                                      : std::numeric_limits<RealT>::quiet_NaN();
+                    }
+                }
+
+                best_partitions.push_back(best_partition);
+            }
+        }
+
+        return best_partitions;
+    }
+
+private:
+    /**
+     * Generates all the partitions of an orbit by assigning, class by class
+     * and coalition by coalition, the required number of players of each
+     * class.
+     *
+     * Coalitions with the same class composition are interchangeable, so
+     * each partition is generated exactly once by only generating the
+     * assignments where such coalitions are ordered by their smallest
+     * player of the first class they contain.
+     */
+    struct orbit_expansion_t
+    {
+        orbit_expansion_t(const dcs::algorithm::multiset_partition::part_container& blocks_,
+                          const std::vector<std::vector<gtpack::pid_type>>& members_,
+                          std::vector<std::vector<gtpack::cid_type>>& orbit_)
+        : blocks(blocks_),
+          members(members_),
+          orbit(orbit_),
+          first_classes(blocks_.size(), 0),
+          prev_twins(blocks_.size(), std::numeric_limits<std::size_t>::max()),
+          block_cids(blocks_.size(), gtpack::empty_cid),
+          block_mins(blocks_.size(), 0)
+        {
+            for (std::size_t b = 0; b < blocks.size(); ++b)
+            {
+                while (blocks[b][first_classes[b]] == 0)
+                {
+                    ++first_classes[b];
+                }
+                for (std::size_t b2 = b; b2 > 0; --b2)
+                {
+                    if (blocks[b2-1] == blocks[b])
+                    {
+                        prev_twins[b] = b2-1;
+                        break;
+                    }
+                }
+            }
+        }
+
+        /// Assigns the players of class c to coalitions b, b+1, ..., and
+        /// then the players of the next classes
+        void expand(std::size_t c, std::size_t b, const std::vector<gtpack::pid_type>& available)
+        {
+            if (b == blocks.size())
+            {
+                if (c+1 == members.size())
+                {
+                    orbit.push_back(block_cids);
+                }
+                else
+                {
+                    this->expand(c+1, 0, members[c+1]);
+                }
+                return;
+            }
+
+            this->assign(c, b, available, 0, blocks[b][c], gtpack::empty_cid);
+        }
+
+        /// Chooses (in all possible ways) the given number of players among
+        /// the available ones (from the given position onward), and assigns
+        /// them to coalition b
+        void assign(std::size_t c,
+                    std::size_t b,
+                    const std::vector<gtpack::pid_type>& available,
+                    std::size_t first,
+                    std::size_t count,
+                    gtpack::cid_type chosen)
+        {
+            if (count == 0)
+            {
+                std::vector<gtpack::pid_type> remaining;
+                for (auto const pid : available)
+                {
+                    if (!(chosen & gtpack::make_coalition_id(pid)))
+                    {
+                        remaining.push_back(pid);
+                    }
+                }
+
+                const gtpack::cid_type old_cid = block_cids[b];
+                block_cids[b] |= chosen;
+                this->expand(c, b+1, remaining);
+                block_cids[b] = old_cid;
+                return;
+            }
+
+            // The smallest player of the first class of a coalition must
+            // follow the one of the previous coalition with the same class
+            // composition
+            bool const first_pick = c == first_classes[b] && count == blocks[b][c];
+
+            for (std::size_t i = first; i+count <= available.size(); ++i)
+            {
+                if (first_pick)
+                {
+                    if (prev_twins[b] != std::numeric_limits<std::size_t>::max() && available[i] <= block_mins[prev_twins[b]])
+                    {
+                        continue;
+                    }
+                    block_mins[b] = available[i];
+                }
+
+                this->assign(c, b, available, i+1, count-1, chosen | gtpack::make_coalition_id(available[i]));
+            }
+        }
+
+
+        const dcs::algorithm::multiset_partition::part_container& blocks;
+        const std::vector<std::vector<gtpack::pid_type>>& members;
+        std::vector<std::vector<gtpack::cid_type>>& orbit;
+        std::vector<std::size_t> first_classes; ///< The first class with some player, by coalition
+        std::vector<std::size_t> prev_twins; ///< The previous coalition with the same class composition (if any), by coalition
+        std::vector<gtpack::cid_type> block_cids; ///< The players assigned so far, by coalition
+        std::vector<gtpack::pid_type> block_mins; ///< The smallest player of the first class, by coalition
+    }; // orbit_expansion_t
+
+
+    std::vector<std::size_t> player_classes_; ///< Equivalence class of each player
+}; // symmetric_nash_stable_partition_selector_t
+
+}} // Namespace dcs::fgt
+
+
+#endif // DCS_FGT_COALITION_FORMATION_SYMMETRIC_NASH_STABLE_HPP
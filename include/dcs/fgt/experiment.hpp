@@ -29,9 +29,12 @@
 
 
 #include <algorithm>
+#include <atomic>
 #include <boost/algorithm/string.hpp>
 #include <boost/smart_ptr.hpp>
 #include <cctype>
+#include <chrono>
+#include <cmath>
 #include <cstddef>
 #include <ctime>
 #include <dcs/algorithm/combinatorics.hpp>
@@ -39,23 +42,33 @@
 #include <dcs/debug.hpp>
 #include <dcs/exception.hpp>
 #include <dcs/fgt/coalition_formation.hpp>
+#include <dcs/fgt/game_log.hpp>
+#include <dcs/fgt/metrics.hpp>
 #include <dcs/fgt/MMc.hpp>
+#include <dcs/fgt/parallel.hpp>
 #include <dcs/fgt/random.hpp>
 #include <dcs/fgt/simulator.hpp>
 #include <dcs/fgt/statistics.hpp>
+#include <dcs/fgt/strategy_planner.hpp>
 #include <dcs/fgt/util.hpp>
 #include <dcs/fgt/vm_allocation.hpp>
+#include <dcs/fgt/vm_allocation_frontier.hpp>
 #include <dcs/fgt/vm_allocation_solvers.hpp>
+#include <dcs/fgt/vm_allocation_store.hpp>
 #include <dcs/fgt/workload.hpp>
 #include <dcs/logging.hpp>
+#include <deque>
 #include <fstream>
 #include <functional>
 #include <gtpack/cooperative.hpp>
 #include <initializer_list>
 #include <iostream>
 #include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <random>
+#include <set>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -83,6 +96,7 @@ struct scenario_t
     //std::vector<std::tuple<RealT,RealT,RealT>> provider_electricity_costs; ///< FP electricity cost plans: <start-hour, stop-hour, $/kWh>
     std::vector<RealT> fp_electricity_costs; ///< FP electricity cost plans (in $/kWh)
     std::vector<RealT> fp_coalition_costs; ///< Cost due to form a coalition structure, by FP
+    std::vector<std::vector<bool>> fp_adjacency; ///< Adjacency matrix of the FP topology: only FPs inducing a connected subgraph can form a coalition (an empty matrix means that any coalition can form)
     std::vector<std::vector<RealT>> fp_svc_revenues; ///< FP revenues (in $/service) for running services, by FP and service category
     std::vector<std::vector<RealT>> fp_svc_penalties; ///< FP penalties (in $/service) for violating service QoS (i.e., the max delay), by FP and service category
     std::vector<std::vector<RealT>> fp_fn_asleep_costs; ///< FP costs for powering off a powered-on FN, by FP and FN category
@@ -100,35 +114,82 @@ template <typename RealT>
 struct options_t
 {
     options_t()
-    : coalition_formation(fgt::nash_stable_coalition_formation),
+    : aggregate_models(false),
+      collapse_deterministic_replications(true),
+      coalition_formation(fgt::nash_stable_coalition_formation),
       coalition_formation_interval(0),
+      coalition_formation_max_staleness(0),
+      coalition_formation_trigger(fgt::periodic_coalition_formation_trigger),
+      coalition_formation_trigger_vms_threshold(1),
       coalition_value_division(fgt::shapley_coalition_value_division),
+      compare_stability(false),
+      core_check(fgt::exhaustive_core_check),
       find_all_best_partitions(false),
+      frontier_cache(false),
+      incremental_models(false),
+      incremental_payoffs(false),
+      interval_budget(0),
+      interval_memo(false),
+      max_partition_blocks(0),
+      metrics_interval(metrics_exporter_t::default_interval),
+      num_threads(1),
       optim_relative_tolerance(0),
       optim_time_limit(-1),
+      precompute_values(false),
+      preference_cache_size(16),
+      search_best_partition(false),
       sim_ci_level(0.95),
       sim_ci_rel_precision(0.04),
       sim_max_num_replications(0),
       sim_max_replication_duration(0),
+      sim_num_logical_processes(0),
       service_delay_tolerance(0),
+      solution_store_capacity(vm_allocation_store_t<RealT>::default_capacity),
+      symmetry_reduction(false),
       verbosity(0)
     {
     }
 
 
+    bool aggregate_models; ///< A \c true value means that the VM allocation problem of every coalition is modeled by classes of interchangeable FNs (same FP, category and power state) and by number of VMs per service, instead of by single FNs and VMs, with the symmetry among the FNs of a class broken (the allocation of single VMs is only expanded when solutions are stored); the incremental models are then not used
+    bool collapse_deterministic_replications; ///< A \c true value means that a single replication is run (and exact values are reported) when no stochastic component is configured
     fgt::coalition_formation_category coalition_formation; ///< The strategy according which form coalitions
     RealT coalition_formation_interval; ///< The activating time of the coalition formation algorithm
+    RealT coalition_formation_max_staleness; ///< The maximum time the outcome of a coalition formation can be reused by the demand-change trigger (use 0 for no limit)
+    fgt::coalition_formation_trigger_category coalition_formation_trigger; ///< The policy according which the coalition formation is performed at each activation
+    std::size_t coalition_formation_trigger_vms_threshold; ///< The minimum change in the number of VMs of a service that makes the demand-change trigger to perform the coalition formation
     fgt::coalition_value_division_category coalition_value_division;
+    bool compare_stability; ///< A \c true value means that, at every coalition formation, the stable partitions are also selected according to all the other stability notions, in the same enumeration of partitions, and compared
+    fgt::core_check_category core_check; ///< The way payoffs are checked to belong to the core (with a separation check, the emptiness of the core is not determined, and coalitions whose payoffs are outside the core are reported with an empty core)
     bool find_all_best_partitions; ///< A \c true value means that all possible best partitions are computed
+    bool frontier_cache; ///< A \c true value means that, for every coalition, the demands (arrival rates of its services) whose VM allocation problem has been proven infeasible or solved are recorded, so that the problems with a higher demand than an infeasible one are not solved, and the others are solved with the objective bounds implied by the recorded ones
+    std::string game_log_file; ///< The path to the game log where the coalition values of every interval are recorded (use an empty path to disable the log)
+    std::string game_replay_file; ///< The path to a game log whose intervals are replayed instead of simulating the workload (use an empty path to simulate)
+    bool incremental_models; ///< A \c true value means that, within a coalition formation, the VM allocation model of every coalition is composed from the cached model of the coalition without its last FP, instead of being built from scratch
+    bool incremental_payoffs; ///< A \c true value means that, within a replication, each coalition formation only re-analyzes the coalitions of the FPs whose demand changed since the previous one (ignored when intervals are evaluated in parallel)
+    RealT interval_budget; ///< The time budget (in seconds) of every coalition formation, according to which the formation and valuation strategies are chosen (use 0 to always use the configured strategies)
+    bool interval_memo; ///< A \c true value means that the outcome of the coalition formation is memoized by service arrival rates and reused across intervals and replications
+    std::size_t max_partition_blocks; ///< The maximum number of coalitions in the partitions considered by the Nash stable formation (use 0 for no limit; ignored when stability notions are compared or with the symmetry reduction)
+    std::string metrics_file; ///< The path to the file where live metrics are periodically written in the Prometheus text format (use an empty path to disable metrics)
+    RealT metrics_interval; ///< The time (in seconds) between two consecutive writes of the metrics file
+    std::size_t num_threads; ///< Number of threads used to evaluate the coalition formation intervals of a replication (use 1 to evaluate each interval as soon as it ends, and 0 for the number of hardware threads)
     RealT optim_relative_tolerance; ///< The relative tolerance option to set in the optimizer
     RealT optim_time_limit; ///< The time limit option to set in the optimizer
+    std::string output_quantile_data_file; ///< The path to the output file of the quantiles of interval profits
     std::string output_stats_data_file; ///< The path to the output stats data file
     std::string output_trace_data_file; ///< The path to the output trace data file
+    bool precompute_values; ///< A \c true value means that, with deterministic workloads, the VM allocation of every coalition is solved before the simulation for every combination of the arrival rates its services can take according to the workload step tables, so that coalition formations only look coalition values up
+    std::size_t preference_cache_size; ///< Maximum number of preference profiles whose stable partitions are cached (use 0 to disable caching)
+    bool search_best_partition; ///< A \c true value means that, with the Nash stable formation, only the best stable partition is searched, by branch and bound over the best partitions of subsets of FPs, instead of enumerating every partition (ignored when all the best partitions are computed, when stability notions are compared, with the symmetry reduction or with more than \c nash_stable_partition_selector_t::max_search_num_players FPs; the number of stable partitions is then not known, and ties among best partitions may be broken differently)
     RealT sim_ci_level; ///< Level for confidence intervals
     RealT sim_ci_rel_precision; ///< Relative precision for the half-width of the confidence intervals
     std::size_t sim_max_num_replications; ///< Maximum number of replications (use 0 for an unlimited number of replications)
     RealT sim_max_replication_duration; ///< Maximum length of each replication
+    std::size_t sim_num_logical_processes; ///< Number of logical processes the services are partitioned into, each advanced on its own thread (among \c num_threads) between two coalition formation triggers, with its own random number stream and workload generators (use 0 to simulate all services sequentially)
     RealT service_delay_tolerance; ///< The relative tolerance to set in the service performance model
+    std::string solution_store_file; ///< The path to the persistent store of solved VM allocation problems (use an empty path to disable the store)
+    std::size_t solution_store_capacity; ///< Maximum number of solutions held by a newly created solution store
+    bool symmetry_reduction; ///< A \c true value means that stable partitions are searched up to the symmetry among interchangeable FPs
     int verbosity; ///< The verbosity level: 0 for 'minimum' and 9 for 'maximum' verbosity level
 }; // options_t
 
@@ -287,6 +348,25 @@ std::basic_ostream<CharT,CharTraitsT>& operator<<(std::basic_ostream<CharT,CharT
         os << s.fp_coalition_costs[i];
     }
     os << "]";
+    os << ", " << "fp.adjacency=[";
+    for (std::size_t i = 0; i < s.fp_adjacency.size(); ++i)
+    {
+        if (i > 0)
+        {
+            os << ", ";
+        }
+        os << "[";
+        for (std::size_t j = 0; j < s.fp_adjacency[i].size(); ++j)
+        {
+            if (j > 0)
+            {
+                os << ", ";
+            }
+            os << s.fp_adjacency[i][j];
+        }
+        os << "]";
+    }
+    os << "]";
     os << ", " << "fp.svc_revenues=[";
     for (std::size_t i = 0; i < s.fp_svc_revenues.size(); ++i)
     {
@@ -750,6 +830,42 @@ scenario_t<RealT> make_scenario(const std::string& fname)
                 iss >> s.fp_coalition_costs[i];
             }
         }
+        else if (boost::istarts_with(line, "fp.adjacency"))
+        {
+            std::istringstream iss(line);
+
+            // Move to '='
+            iss.ignore(std::numeric_limits<std::streamsize>::max(), '=');
+            DCS_ASSERT(iss.good(),
+                       DCS_EXCEPTION_THROW(std::runtime_error, "Malformed scenario file ('=' is missing at line " + stringify(lineno) + " and column " + stringify(iss.tellg()) + ")"));
+
+            // Move to '['
+            iss.ignore(std::numeric_limits<std::streamsize>::max(), '[');
+            DCS_ASSERT(iss.good(),
+                       DCS_EXCEPTION_THROW(std::runtime_error, "Malformed scenario file ('[' is missing at line " + stringify(lineno) + " and column " + stringify(iss.tellg()) + ")"));
+
+            s.fp_adjacency.resize(s.num_fps);
+            for (std::size_t i = 0; i < s.num_fps; ++i)
+            {
+                // Move to '['
+                iss.ignore(std::numeric_limits<std::streamsize>::max(), '[');
+                DCS_ASSERT(iss.good(),
+                           DCS_EXCEPTION_THROW(std::runtime_error, "Malformed scenario file ('[' is missing at line " + stringify(lineno) + " and column " + stringify(iss.tellg()) + ")"));
+
+                s.fp_adjacency[i].resize(s.num_fps);
+                for (std::size_t j = 0; j < s.num_fps; ++j)
+                {
+                    int adjacent = 0;
+                    iss >> adjacent;
+                    s.fp_adjacency[i][j] = (adjacent != 0);
+                }
+
+                // Move to ']'
+                iss.ignore(std::numeric_limits<std::streamsize>::max(), ']');
+                DCS_ASSERT(iss.good(),
+                           DCS_EXCEPTION_THROW(std::runtime_error, "Malformed scenario file (']' is missing at line " + stringify(lineno) + " and column " + stringify(iss.tellg()) + ")"));
+            }
+        }
         else if (boost::istarts_with(line, "fp.svc_revenues"))
         {
             std::istringstream iss(line);
@@ -1044,6 +1160,18 @@ scenario_t<RealT> make_scenario(const std::string& fname)
     }
     DCS_ASSERT(s.fp_coalition_costs.size() == s.num_fps,
                DCS_EXCEPTION_THROW(std::runtime_error, "Unexpected number of FPs in coalition costs by FP"));
+    DCS_ASSERT(s.fp_adjacency.size() == 0 || s.fp_adjacency.size() == s.num_fps,
+               DCS_EXCEPTION_THROW(std::runtime_error, "Unexpected number of FPs in FP adjacency matrix"));
+    for (std::size_t i = 0; i < s.fp_adjacency.size(); ++i)
+    {
+        DCS_ASSERT(s.fp_adjacency[i].size() == s.num_fps,
+                   DCS_EXCEPTION_THROW(std::runtime_error, "Unexpected number of FPs for FP " + stringify(i) + " in FP adjacency matrix"));
+        for (std::size_t j = 0; j < i; ++j)
+        {
+            DCS_ASSERT(s.fp_adjacency[i][j] == s.fp_adjacency[j][i],
+                       DCS_EXCEPTION_THROW(std::runtime_error, "FP adjacency matrix is not symmetric at FPs " + stringify(i) + " and " + stringify(j)));
+        }
+    }
     DCS_ASSERT(s.fp_svc_revenues.size() == s.num_fps,
                DCS_EXCEPTION_THROW(std::runtime_error, "Unexpected number of FPs in service revenues by FP"));
     for (std::size_t i = 0; i < s.num_fps; ++i)
@@ -1069,17 +1197,43 @@ scenario_t<RealT> make_scenario(const std::string& fname)
 template <typename CharT, typename CharTraitsT, typename RealT>
 std::basic_ostream<CharT,CharTraitsT>& operator<<(std::basic_ostream<CharT,CharTraitsT>& os, const options_t<RealT>& opts)
 {
-    os  << "optim-relative-tolerance: " << opts.optim_relative_tolerance
+    os  << "aggregate-models: " << opts.aggregate_models
+        << ", collapse-deterministic-replications: " << opts.collapse_deterministic_replications
+        << ", incremental-models: " << opts.incremental_models
+        << ", incremental-payoffs: " << opts.incremental_payoffs
+        << ", interval-budget: " << opts.interval_budget
+        << ", interval-memo: " << opts.interval_memo
+        << ", max-partition-blocks: " << opts.max_partition_blocks
+        << ", metrics-file: " << opts.metrics_file
+        << ", metrics-interval: " << opts.metrics_interval
+        << ", num-threads: " << opts.num_threads
+        << ", optim-relative-tolerance: " << opts.optim_relative_tolerance
         << ", optim-time-limit: " << opts.optim_time_limit
         << ", coalition-formation: " << opts.coalition_formation
+        << ", coalition-formation-trigger: " << opts.coalition_formation_trigger
+        << ", coalition-formation-trigger-vms-threshold: " << opts.coalition_formation_trigger_vms_threshold
+        << ", coalition-formation-max-staleness: " << opts.coalition_formation_max_staleness
         << ", coalition-value-division: " << opts.coalition_value_division
+        << ", compare-stability: " << opts.compare_stability
+        << ", core-check: " << opts.core_check
+        << ", frontier-cache: " << opts.frontier_cache
+        << ", game-log-file: " << opts.game_log_file
+        << ", game-replay-file: " << opts.game_replay_file
+        << ", output-quantile-data-file: " << opts.output_quantile_data_file
         << ", output-stats-data-file: " << opts.output_stats_data_file
         << ", output-trace-data-file: " << opts.output_trace_data_file
+        << ", precompute-values: " << opts.precompute_values
+        << ", preference-cache-size: " << opts.preference_cache_size
+        << ", search-best-partition: " << opts.search_best_partition
         << ", sim-ci-level: " << opts.sim_ci_level
         << ", sim-ci-relative-precision: " << opts.sim_ci_rel_precision
         << ", sim-max-num-replications: " << opts.sim_max_num_replications
         << ", sim-max-replication-duration: " << opts.sim_max_replication_duration
+        << ", sim-num-logical-processes: " << opts.sim_num_logical_processes
         << ", service-delay-tolerance: " << opts.service_delay_tolerance
+        << ", solution-store-file: " << opts.solution_store_file
+        << ", solution-store-capacity: " << opts.solution_store_capacity
+        << ", symmetry-reduction: " << opts.symmetry_reduction
         << ", verbosity: " << opts.verbosity;
         //<< ", simulation-mode: " << opts.simulation_mode;
 
@@ -1087,12 +1241,17 @@ std::basic_ostream<CharT,CharTraitsT>& operator<<(std::basic_ostream<CharT,CharT
 }
 
 
+template <typename RealT>
+class what_if_evaluator_t;
+
 template <typename RealT>
 class experiment_t: public simulator_t<RealT>
 {
 private:
     typedef simulator_t<RealT> base_type;
 
+    friend class what_if_evaluator_t<RealT>;
+
     enum verbosity_level_t
     {
         none = 0,
@@ -1122,29 +1281,133 @@ private:
         RealT stop_time = -1;
     }; // coalition_formation_trigger_event_state_t
 
+    /// Workload demand observed in a coalition formation interval
+    struct interval_demand_t
+    {
+        std::vector<RealT> svc_arrival_rates; ///< Max arrival rate, by service
+        std::vector<std::size_t> svc_num_vms; ///< Min number of VMs needed to meet the max delay, by service
+        std::vector<std::vector<RealT>> svc_predicted_delays; ///< Predicted delay of each VM, by service
+        std::vector<std::size_t> vm_svcs; ///< Map a VM to the service it runs
+    }; // interval_demand_t
+
+    /// Outcome of the coalition formation in a coalition formation interval
+    struct interval_formation_t
+    {
+        coalition_formation_info_t<RealT> formed_coalitions;
+        std::vector<RealT> fp_alone_profits; ///< Profit that each FP gets by running alone, by FP
+        std::vector<RealT> svc_arrival_rates; ///< Max arrival rate the coalition formation has been performed for, by service
+        bool planned = false; ///< Tells if the coalition formation has been performed according to a strategy plan
+        strategy_plan_t<RealT> plan; ///< The strategy plan of the coalition formation (if planned)
+        RealT elapsed_time = 0; ///< The time (in seconds) actually taken by the coalition formation (if planned)
+        std::map<coalition_formation_category, std::size_t> num_stable_partitions; ///< Number of stable partitions, by stability notion (if stability notions are compared)
+    }; // interval_formation_t
+
+    /// Outcome of the last coalition formation of a replication, from which
+    /// the next one is incrementally updated
+    struct incremental_formation_state_t
+    {
+        bool valid = false; ///< Tells if a coalition formation has been performed in the current replication
+        std::vector<RealT> svc_arrival_rates; ///< Max arrival rate, by service
+        RealT duration = 0; ///< Length of the interval
+        std::map<gtpack::cid_type, coalition_info_t<RealT>> coalitions; ///< Analysis of every coalition, by CID
+        std::map<gtpack::cid_type, RealT> values; ///< Value of every coalition (including the disconnected ones, if any), by CID
+    }; // incremental_formation_state_t
+
+    /// Coalition formation whose evaluation is deferred to the end of the replication
+    struct pending_formation_t
+    {
+        interval_demand_t demand;
+        RealT duration;
+    }; // pending_formation_t
+
+    /// Coalition formation interval whose report is deferred to the end of the replication
+    struct pending_interval_t
+    {
+        coalition_formation_trigger_event_state_t state;
+        std::time_t timestamp;
+        std::size_t formation; ///< Index of the (pending) coalition formation whose outcome applies to this interval
+        bool formed; ///< Tells if the coalition formation has been performed in this interval
+    }; // pending_interval_t
+
     static const char field_quote_ch = '"';
     static const char field_sep_ch = ',';
 
 
 public:
+    /// Coalition formation outcomes and coalition VM allocations that do not
+    /// depend on the length of coalition formation intervals, and can thus
+    /// be shared by experiments on the same scenario and workload that differ
+    /// only in that length (see \c setup)
+    struct formation_cache_t
+    {
+        std::map<std::vector<RealT>, interval_formation_t> interval_memo; ///< Outcome of the coalition formation for a unit duration, by service arrival rates
+        std::mutex interval_memo_mutex;
+        std::map<std::pair<gtpack::cid_type,std::vector<RealT>>, vm_allocation_t<RealT>> coal_value_table; ///< Precomputed VM allocation of coalitions, by CID and arrival rates of the coalition services
+    }; // formation_cache_t
+
+
     experiment_t()
     : num_fns_(0),
-      num_svcs_(0)
+      num_svcs_(0),
+      num_formations_(0),
+      num_skipped_formations_(0),
+      rep_num_formations_(0),
+      rep_num_skipped_formations_(0),
+      rep_last_formation_time_(0),
+      rep_last_formation_duration_(0),
+      deterministic_(false),
+      has_replay_record_(false),
+      p_formation_cache_(std::make_shared<formation_cache_t>()),
+      num_interval_memo_hits_(0),
+      num_interval_memo_misses_(0),
+      num_value_table_hits_(0),
+      num_reused_coalitions_(0),
+      num_updated_coalitions_(0),
+      num_recomputed_coalitions_(0)
     {
     }
 
-    void setup(const scenario_t<RealT>& scenario, const options_t<RealT>& options, random_number_engine_t& rng)
+    /// Sets up the experiment.
+    /// If \a p_formation_cache is not null, the experiment uses that
+    /// formation cache, e.g., the one of an experiment on the same scenario
+    /// and workload but with another coalition formation interval, so that
+    /// coalition values are precomputed once and the coalition formations of
+    /// the intervals with the same service arrival rates are evaluated once.
+    void setup(const scenario_t<RealT>& scenario,
+               const options_t<RealT>& options,
+               random_number_engine_t& rng,
+               const std::shared_ptr<formation_cache_t>& p_formation_cache = nullptr)
     {
         this->reset();
 
+        if (p_formation_cache)
+        {
+            p_formation_cache_ = p_formation_cache;
+        }
+
         scen_ = scenario;
         opts_ = options;
         rng_ = rng;
 
+        nash_selector_ = nash_stable_partition_selector_t<RealT>(opts_.preference_cache_size,
+                                                                opts_.search_best_partition && !opts_.find_all_best_partitions,
+                                                                opts_.max_partition_blocks);
+
+        if (!opts_.solution_store_file.empty())
+        {
+            p_vm_alloc_store_ = std::make_shared<vm_allocation_store_t<RealT>>(opts_.solution_store_file, opts_.solution_store_capacity);
+        }
+
+        if (opts_.frontier_cache)
+        {
+            p_vm_alloc_frontier_ = std::make_shared<vm_allocation_frontier_t<RealT>>();
+        }
+
         fps_.resize(scen_.num_fps);
         std::iota(fps_.begin(), fps_.end(), 0);
 
         // Fills FN data structures and compute the total number of FNs
+        fp_fns_.resize(scen_.num_fps);
         for (std::size_t fp = 0; fp < scen_.num_fps; ++fp)
         {
             for (std::size_t fnc = 0; fnc < scen_.num_fn_categories; ++fnc)
@@ -1153,6 +1416,7 @@ public:
 
                 for (std::size_t i = 0; i < nfns; ++i)
                 {
+                    fp_fns_[fp].push_back(fn_fps_.size());
                     fn_fps_.push_back(fp);
                     fn_categories_.push_back(fnc);
                 }
@@ -1162,6 +1426,7 @@ public:
         }
 
         // Fills service data structures and computes the total number of services
+        fp_svcs_.resize(scen_.num_fps);
         for (std::size_t p = 0; p < scen_.num_fps; ++p)
         {
             for (std::size_t s = 0; s < scen_.num_svc_categories; ++s)
@@ -1170,6 +1435,7 @@ public:
 
                 for (std::size_t i = 0; i < nsvcs; ++i)
                 {
+                    fp_svcs_[p].push_back(svc_fps_.size());
                     svc_fps_.push_back(p);
                     svc_categories_.push_back(s);
                 }
@@ -1178,6 +1444,35 @@ public:
             }
         }
 
+        // Resolves the category- and FP-based scenario inputs of the VM
+        // allocation problem into per-FN and per-service tables
+        vm_alloc_features_ = make_vm_allocation_features(fn_fps_,
+                                                         fn_categories_,
+                                                         scen_.fn_min_powers,
+                                                         scen_.fn_max_powers,
+                                                         scen_.svc_vm_categories,
+                                                         scen_.vm_cpu_requirements,
+                                                         scen_.vm_ram_requirements,
+                                                         svc_fps_,
+                                                         svc_categories_,
+                                                         scen_.svc_max_delays,
+                                                         scen_.fp_svc_penalties,
+                                                         scen_.fp_electricity_costs,
+                                                         scen_.fp_fn_asleep_costs,
+                                                         scen_.fp_fn_awake_costs);
+
+        // Bound the profit rate of FPs (VM allocation costs are non-negative)
+        fp_max_profit_rates_.assign(scen_.num_fps, 0);
+        for (std::size_t fp = 0; fp < scen_.num_fps; ++fp)
+        {
+            RealT rate = std::max(scen_.fp_coalition_costs[fp], RealT(0));
+            for (auto const svc : fp_svcs_[fp])
+            {
+                rate += scen_.fp_svc_revenues[fp][svc_categories_[svc]];
+            }
+            fp_max_profit_rates_[fp] = std::max(rate, RealT(0));
+        }
+
         // Initialize workload generators
         wkl_gens_.resize(scen_.num_svc_categories);
         for (std::size_t i = 0; i < scen_.num_svc_categories; ++i)
@@ -1193,6 +1488,73 @@ public:
 
             wkl_gens_[i] = std::make_shared<multistep_workload_generator_t<RealT>>(durations.begin(), durations.end(), arr_rates.begin(), arr_rates.end());
         }
+
+        // Enumerate the coalitions that can form: with an FP topology, only the
+        // FPs inducing a connected subgraph (sorted by CID, so that every
+        // coalition follows its sub-coalitions)
+        if (scen_.fp_adjacency.empty())
+        {
+            dcs::algorithm::lexicographic_subset subset(scen_.num_fps, false);
+            while (subset.has_next())
+            {
+                feasible_coal_fps_.push_back(dcs::algorithm::next_subset(fps_.begin(), fps_.end(), subset));
+            }
+        }
+        else
+        {
+            fp_adjacency_cids_.resize(scen_.num_fps, gtpack::empty_cid);
+            for (std::size_t fp1 = 0; fp1 < scen_.num_fps; ++fp1)
+            {
+                for (std::size_t fp2 = 0; fp2 < scen_.num_fps; ++fp2)
+                {
+                    if (fp1 != fp2 && scen_.fp_adjacency[fp1][fp2])
+                    {
+                        fp_adjacency_cids_[fp1] |= gtpack::make_coalition_id(fp2);
+                    }
+                }
+            }
+
+            dcs::algorithm::connected_subset subset(scen_.fp_adjacency);
+            while (subset.has_next())
+            {
+                feasible_coal_fps_.push_back(dcs::algorithm::next_subset(fps_.begin(), fps_.end(), subset));
+            }
+            std::sort(feasible_coal_fps_.begin(),
+                      feasible_coal_fps_.end(),
+                      [](const std::vector<std::size_t>& fps1, const std::vector<std::size_t>& fps2)
+                      {
+                        return gtpack::make_coalition_id(fps1.begin(), fps1.end()) < gtpack::make_coalition_id(fps2.begin(), fps2.end());
+                      });
+
+            if (opts_.verbosity > none)
+            {
+                DCS_LOGGING_STREAM << "-- FP topology: " << feasible_coal_fps_.size() << " connected coalitions";
+                if (scen_.num_fps < static_cast<std::size_t>(std::numeric_limits<gtpack::cid_type>::digits))
+                {
+                    DCS_LOGGING_STREAM << " out of " << ((static_cast<gtpack::cid_type>(1) << scen_.num_fps)-1);
+                }
+                DCS_LOGGING_STREAM << std::endl;
+            }
+        }
+
+        num_feasible_coals_by_size_.assign(scen_.num_fps+1, 0);
+        for (auto const& coal_fps : feasible_coal_fps_)
+        {
+            ++num_feasible_coals_by_size_[coal_fps.size()];
+        }
+
+        planner_.reset(opts_.interval_budget);
+
+        // Every replication is the same when no stochastic component is configured
+        deterministic_ = std::all_of(wkl_gens_.begin(),
+                                     wkl_gens_.end(),
+                                     [](const std::shared_ptr<workload_generator_t<RealT>>& p_gen) { return p_gen->deterministic(); });
+    }
+
+    /// Returns the formation cache of this experiment
+    std::shared_ptr<formation_cache_t> formation_cache() const
+    {
+        return p_formation_cache_;
     }
 
     void reset()
@@ -1206,14 +1568,65 @@ public:
         fn_categories_.clear();
         svc_fps_.clear();
         svc_categories_.clear();
+        fp_fns_.clear();
+        fp_svcs_.clear();
+        fp_max_profit_rates_.clear();
+        vm_alloc_features_ = vm_allocation_features_t<RealT>();
         wkl_gens_.clear();
+        lp_rngs_.clear();
+        lp_wkl_gens_.clear();
         fp_coal_profit_ci_stats_.clear();
         fp_alone_profit_ci_stats_.clear();
         rep_fp_coal_profit_stats_.clear();
         rep_fp_alone_profit_stats_.clear();
+        fp_coal_profit_quantile_stats_.clear();
+        fp_alone_profit_quantile_stats_.clear();
+        fp_profit_ratio_quantile_stats_.clear();
+        fp_coal_below_alone_stats_.clear();
+        stability_num_partitions_stats_.clear();
+        stability_existence_stats_.clear();
+        rep_fp_coal_profit_quantile_stats_.clear();
+        rep_fp_alone_profit_quantile_stats_.clear();
+        rep_fp_profit_ratio_quantile_stats_.clear();
+        num_formations_ = num_skipped_formations_ = 0;
+        deterministic_ = false;
+        feasible_coal_fps_.clear();
+        fp_adjacency_cids_.clear();
+        num_feasible_coals_by_size_.clear();
+        p_vm_alloc_store_.reset();
+        p_vm_alloc_frontier_.reset();
+        p_game_log_writer_.reset();
+        p_game_log_reader_.reset();
+        has_replay_record_ = false;
+        p_formation_cache_ = std::make_shared<formation_cache_t>();
+        num_interval_memo_hits_ = num_interval_memo_misses_ = 0;
+        num_value_table_hits_ = 0;
+        num_reused_coalitions_ = num_updated_coalitions_ = num_recomputed_coalitions_ = 0;
+        p_metrics_exporter_.reset();
+        p_metrics_.reset();
     }
 
 private:
+    /// The orders of the quantiles of interval profits that are reported
+    static std::vector<RealT> interval_profit_quantiles()
+    {
+        return {0.05, 0.5, 0.95};
+    }
+
+    static std::string quantile_summary(const quantile_estimator_t<RealT>& stat)
+    {
+        std::ostringstream oss;
+
+        oss << "[" << stat.min();
+        for (auto const q : interval_profit_quantiles())
+        {
+            oss << ", p" << q*100 << ": " << stat.quantile(q);
+        }
+        oss << ", " << stat.max() << "] (size: " << stat.size() << ")";
+
+        return oss.str();
+    }
+
     template <typename IterT>
     static bool check_stats(IterT first, IterT last)
     {
@@ -1242,6 +1655,69 @@ private:
             this->max_replication_duration(opts_.sim_max_replication_duration);
         }
 
+        // Initialize game logs
+
+        if (!opts_.game_replay_file.empty())
+        {
+            p_game_log_reader_ = std::make_shared<game_log_reader_t<RealT>>(opts_.game_replay_file);
+
+            DCS_ASSERT(p_game_log_reader_->num_fps() == scen_.num_fps && p_game_log_reader_->num_svcs() == num_svcs_,
+                       DCS_EXCEPTION_THROW(std::invalid_argument, "The game log to replay does not match the scenario"));
+
+            has_replay_record_ = p_game_log_reader_->read(next_replay_record_);
+
+            // A replication ends when all of its recorded intervals have been replayed
+            this->max_replication_duration(std::numeric_limits<RealT>::infinity());
+        }
+        if (!opts_.game_log_file.empty())
+        {
+            p_game_log_writer_ = std::make_shared<game_log_writer_t<RealT>>(opts_.game_log_file, scen_.num_fps, num_svcs_);
+        }
+
+        // Partition services into logical processes (LPs), each with its own
+        // random number stream and workload generators, so that the workload
+        // of different LPs is generated independently
+
+        lp_rngs_.clear();
+        lp_wkl_gens_.clear();
+        if (opts_.sim_num_logical_processes > 0 && !p_game_log_reader_)
+        {
+            const std::size_t num_lps = std::min(opts_.sim_num_logical_processes, num_svcs_);
+
+            for (std::size_t lp = 0; lp < num_lps; ++lp)
+            {
+                lp_rngs_.push_back(random_number_engine_t(rng_()));
+
+                lp_wkl_gens_.push_back(std::vector<std::shared_ptr<workload_generator_t<RealT>>>());
+                for (auto const& p_wkl_gen : wkl_gens_)
+                {
+                    lp_wkl_gens_.back().push_back(p_wkl_gen->clone());
+                }
+            }
+
+            this->num_logical_processes(num_lps);
+            this->num_threads(opts_.num_threads);
+        }
+        else
+        {
+            this->num_logical_processes(0);
+        }
+
+        // Precompute coalition values
+
+        if (opts_.precompute_values && !p_game_log_reader_)
+        {
+            if (!deterministic_)
+            {
+                dcs::log_warn(DCS_LOGGING_AT, "Coalition values are not precomputed since the workload is not deterministic");
+            }
+            else if (p_formation_cache_->coal_value_table.empty())
+            {
+                // Not already precomputed by an experiment sharing the formation cache
+                this->precompute_coalition_values();
+            }
+        }
+
         // Initialize confidence interval variables
         fp_coal_profit_ci_stats_.resize(scen_.num_fps);
         fp_alone_profit_ci_stats_.resize(scen_.num_fps);
@@ -1263,6 +1739,86 @@ private:
             fp_alone_profit_ci_stats_[fp]->name(oss.str());
             rep_fp_alone_profit_stats_[fp] = std::make_shared<mean_estimator_t<RealT>>();
             rep_fp_alone_profit_stats_[fp]->name(oss.str());
+
+            if (deterministic_ && opts_.collapse_deterministic_replications)
+            {
+                fp_coal_profit_ci_stats_[fp]->exact(true);
+                fp_alone_profit_ci_stats_[fp]->exact(true);
+            }
+        }
+
+        // Initialize quantile variables (interval profits are summarized by
+        // replication and then merged into the simulation-wide summaries)
+        fp_coal_profit_quantile_stats_.resize(scen_.num_fps);
+        fp_alone_profit_quantile_stats_.resize(scen_.num_fps);
+        fp_profit_ratio_quantile_stats_.resize(scen_.num_fps);
+        fp_coal_below_alone_stats_.resize(scen_.num_fps);
+        rep_fp_coal_profit_quantile_stats_.resize(scen_.num_fps);
+        rep_fp_alone_profit_quantile_stats_.resize(scen_.num_fps);
+        rep_fp_profit_ratio_quantile_stats_.resize(scen_.num_fps);
+        for (std::size_t fp = 0; fp < scen_.num_fps; ++fp)
+        {
+            std::ostringstream oss;
+
+            oss << "CoalitionProfitQuantiles_{" << fp << "}";
+            fp_coal_profit_quantile_stats_[fp] = std::make_shared<quantile_estimator_t<RealT>>();
+            fp_coal_profit_quantile_stats_[fp]->name(oss.str());
+            rep_fp_coal_profit_quantile_stats_[fp] = std::make_shared<quantile_estimator_t<RealT>>();
+            rep_fp_coal_profit_quantile_stats_[fp]->name(oss.str());
+
+            oss.str("");
+            oss << "AloneProfitQuantiles_{" << fp << "}";
+            fp_alone_profit_quantile_stats_[fp] = std::make_shared<quantile_estimator_t<RealT>>();
+            fp_alone_profit_quantile_stats_[fp]->name(oss.str());
+            rep_fp_alone_profit_quantile_stats_[fp] = std::make_shared<quantile_estimator_t<RealT>>();
+            rep_fp_alone_profit_quantile_stats_[fp]->name(oss.str());
+
+            oss.str("");
+            oss << "CoalitionVsAloneProfitQuantiles_{" << fp << "}";
+            fp_profit_ratio_quantile_stats_[fp] = std::make_shared<quantile_estimator_t<RealT>>();
+            fp_profit_ratio_quantile_stats_[fp]->name(oss.str());
+            rep_fp_profit_ratio_quantile_stats_[fp] = std::make_shared<quantile_estimator_t<RealT>>();
+            rep_fp_profit_ratio_quantile_stats_[fp]->name(oss.str());
+
+            oss.str("");
+            oss << "CoalitionBelowAloneProfit_{" << fp << "}";
+            fp_coal_below_alone_stats_[fp] = std::make_shared<mean_estimator_t<RealT>>();
+            fp_coal_below_alone_stats_[fp]->name(oss.str());
+        }
+
+        // Initialize stability comparison variables
+        if (opts_.compare_stability)
+        {
+            for (auto const category : stability_categories())
+            {
+                std::ostringstream oss;
+
+                oss << "NumStablePartitions_{" << category << "}";
+                stability_num_partitions_stats_[category] = std::make_shared<mean_estimator_t<RealT>>();
+                stability_num_partitions_stats_[category]->name(oss.str());
+
+                oss.str("");
+                oss << "StablePartitionExistence_{" << category << "}";
+                stability_existence_stats_[category] = std::make_shared<mean_estimator_t<RealT>>();
+                stability_existence_stats_[category]->name(oss.str());
+            }
+        }
+
+        if (deterministic_ && opts_.collapse_deterministic_replications && opts_.verbosity > none)
+        {
+            DCS_LOGGING_STREAM << "-- No stochastic component configured: running a single replication" << std::endl;
+        }
+
+        // Initialize live metrics
+
+        if (!opts_.metrics_file.empty())
+        {
+            p_metrics_ = std::make_shared<experiment_metrics_t>(scen_.num_fps);
+            p_metrics_->max_num_replications = (deterministic_ && opts_.collapse_deterministic_replications) ? 1 : opts_.sim_max_num_replications;
+            p_metrics_->max_replication_duration = this->max_replication_duration();
+            p_metrics_->target_relative_precision = opts_.sim_ci_rel_precision;
+
+            p_metrics_exporter_ = std::make_shared<metrics_exporter_t>(opts_.metrics_file, p_metrics_, opts_.metrics_interval);
         }
 
         // Initialize output files
@@ -1308,6 +1864,14 @@ private:
 
     void do_finalize_simulation()
     {
+        if (p_metrics_exporter_)
+        {
+            p_metrics_exporter_->stop();
+        }
+        if (p_game_log_writer_)
+        {
+            p_game_log_writer_->flush();
+        }
         if (stats_dat_ofs_.is_open())
         {
             stats_dat_ofs_.close();
@@ -1317,6 +1881,43 @@ private:
             trace_dat_ofs_.close();
         }
 
+        if (!opts_.output_quantile_data_file.empty())
+        {
+            std::ofstream quantile_dat_ofs(opts_.output_quantile_data_file.c_str());
+
+            DCS_ASSERT(quantile_dat_ofs,
+                       DCS_EXCEPTION_THROW(std::runtime_error, "Unable to open output quantile data file"));
+
+            quantile_dat_ofs    << field_quote_ch << "FP" << field_quote_ch
+                                << field_sep_ch << field_quote_ch << "Statistic" << field_quote_ch
+                                << field_sep_ch << field_quote_ch << "Size" << field_quote_ch
+                                << field_sep_ch << field_quote_ch << "Min" << field_quote_ch;
+            for (auto const q : interval_profit_quantiles())
+            {
+                quantile_dat_ofs << field_sep_ch << field_quote_ch << "P" << q*100 << field_quote_ch;
+            }
+            quantile_dat_ofs    << field_sep_ch << field_quote_ch << "Max" << field_quote_ch
+                                << field_sep_ch << field_quote_ch << "Coalition Profit Below Alone Profit Probability" << field_quote_ch
+                                << std::endl;
+            for (std::size_t fp = 0; fp < scen_.num_fps; ++fp)
+            {
+                for (auto const& p_stat : {fp_coal_profit_quantile_stats_[fp], fp_alone_profit_quantile_stats_[fp], fp_profit_ratio_quantile_stats_[fp]})
+                {
+                    quantile_dat_ofs    << fp
+                                        << field_sep_ch << field_quote_ch << p_stat->name() << field_quote_ch
+                                        << field_sep_ch << p_stat->size()
+                                        << field_sep_ch << p_stat->min();
+                    for (auto const q : interval_profit_quantiles())
+                    {
+                        quantile_dat_ofs << field_sep_ch << p_stat->quantile(q);
+                    }
+                    quantile_dat_ofs    << field_sep_ch << p_stat->max()
+                                        << field_sep_ch << fp_coal_below_alone_stats_[fp]->estimate()
+                                        << std::endl;
+                }
+            }
+        }
+
         if (opts_.verbosity > none)
         {
             DCS_LOGGING_STREAM << "-- CONFIDENCE INTERVALS OUTPUTS:" << std::endl;
@@ -1326,6 +1927,65 @@ private:
                 DCS_LOGGING_STREAM << "   - Coalition profit statistics: " << fp_coal_profit_ci_stats_[fp]->estimate() << " (s.d. " << fp_coal_profit_ci_stats_[fp]->standard_deviation() << ") [" << fp_coal_profit_ci_stats_[fp]->lower() << ", " << fp_coal_profit_ci_stats_[fp]->upper() << "] (rel. prec.: " << fp_coal_profit_ci_stats_[fp]->relative_precision() << ", size: " << fp_coal_profit_ci_stats_[fp]->size() << ")" << std::endl;
                 DCS_LOGGING_STREAM << "   - Alone profit statistics: " << fp_alone_profit_ci_stats_[fp]->estimate() << " (s.d. " << fp_alone_profit_ci_stats_[fp]->standard_deviation() << ") [" << fp_alone_profit_ci_stats_[fp]->lower() << ", " << fp_alone_profit_ci_stats_[fp]->upper() << "] (rel. prec.: " << fp_alone_profit_ci_stats_[fp]->relative_precision() << ", size: " << fp_alone_profit_ci_stats_[fp]->size() << ")" << std::endl;
             }
+
+            DCS_LOGGING_STREAM << "-- INTERVAL PROFIT QUANTILES OUTPUTS:" << std::endl;
+            for (std::size_t fp = 0; fp < scen_.num_fps; ++fp)
+            {
+                DCS_LOGGING_STREAM << "  * FP " << fp << std::endl;
+                DCS_LOGGING_STREAM << "   - Coalition profit quantiles: " << quantile_summary(*fp_coal_profit_quantile_stats_[fp]) << std::endl;
+                DCS_LOGGING_STREAM << "   - Alone profit quantiles: " << quantile_summary(*fp_alone_profit_quantile_stats_[fp]) << std::endl;
+                DCS_LOGGING_STREAM << "   - Coalition profit vs. alone profit quantiles: " << quantile_summary(*fp_profit_ratio_quantile_stats_[fp]) << std::endl;
+                DCS_LOGGING_STREAM << "   - Coalition profit below alone profit probability: " << fp_coal_below_alone_stats_[fp]->estimate() << " (size: " << fp_coal_below_alone_stats_[fp]->size() << ")" << std::endl;
+            }
+
+            if (opts_.compare_stability)
+            {
+                DCS_LOGGING_STREAM << "-- STABILITY NOTIONS COMPARISON:" << std::endl;
+                for (auto const category : stability_categories())
+                {
+                    DCS_LOGGING_STREAM << "  * " << category << ": stable partitions per interval: " << stability_num_partitions_stats_.at(category)->estimate() << " (s.d. " << stability_num_partitions_stats_.at(category)->standard_deviation() << "), intervals with a stable partition: " << stability_existence_stats_.at(category)->estimate() << " (size: " << stability_existence_stats_.at(category)->size() << ")" << std::endl;
+                }
+            }
+
+            if (opts_.preference_cache_size > 0)
+            {
+                DCS_LOGGING_STREAM << "-- PREFERENCE PROFILE CACHE: hits: " << nash_selector_.num_cache_hits() << ", misses: " << nash_selector_.num_cache_misses() << std::endl;
+            }
+
+            if (opts_.coalition_formation_trigger == demand_change_coalition_formation_trigger)
+            {
+                DCS_LOGGING_STREAM << "-- COALITION FORMATION TRIGGER: performed: " << num_formations_ << ", skipped: " << num_skipped_formations_ << std::endl;
+            }
+
+            if (opts_.interval_memo)
+            {
+                DCS_LOGGING_STREAM << "-- INTERVAL MEMO: hits: " << num_interval_memo_hits_ << ", misses: " << num_interval_memo_misses_ << std::endl;
+            }
+
+            if (!p_formation_cache_->coal_value_table.empty())
+            {
+                DCS_LOGGING_STREAM << "-- COALITION VALUE TABLE: precomputed coalition demand states: " << p_formation_cache_->coal_value_table.size() << ", hits: " << num_value_table_hits_ << std::endl;
+            }
+
+            if (p_vm_alloc_store_)
+            {
+                DCS_LOGGING_STREAM << "-- SOLUTION STORE: hits: " << p_vm_alloc_store_->num_hits() << ", misses: " << p_vm_alloc_store_->num_misses() << ", stored solutions: " << p_vm_alloc_store_->size() << "/" << p_vm_alloc_store_->capacity() << std::endl;
+            }
+
+            if (p_vm_alloc_frontier_)
+            {
+                DCS_LOGGING_STREAM << "-- FRONTIER CACHE: infeasible hits: " << p_vm_alloc_frontier_->num_infeasible_hits() << ", bounded solves: " << p_vm_alloc_frontier_->num_bounded_solves() << std::endl;
+            }
+
+            if (opts_.incremental_payoffs)
+            {
+                DCS_LOGGING_STREAM << "-- INCREMENTAL PAYOFFS: reused coalitions: " << num_reused_coalitions_ << ", delta-updated coalitions: " << num_updated_coalitions_ << ", recomputed coalitions: " << num_recomputed_coalitions_ << std::endl;
+            }
+
+            if (opts_.interval_budget > 0)
+            {
+                DCS_LOGGING_STREAM << "-- STRATEGY PLANNER: budget: " << planner_.budget() << "s, planned formations: " << planner_.num_plans() << ", over budget: " << planner_.num_overruns() << ", mean absolute prediction error: " << planner_.mean_absolute_error() << "s" << std::endl;
+            }
         }
     }
 
@@ -1334,6 +1994,25 @@ private:
         rep_fn_power_states_.resize(num_fns_);
         std::fill(rep_fn_power_states_.begin(), rep_fn_power_states_.end(), true);
 
+        rep_num_formations_ = rep_num_skipped_formations_ = 0;
+        rep_last_formation_time_ = rep_last_formation_duration_ = 0;
+        rep_pending_formations_.clear();
+        rep_pending_intervals_.clear();
+        rep_incremental_state_ = incremental_formation_state_t();
+
+        // Restart workloads so that replications of deterministic workloads are identical
+        for (auto& p_wkl_gen : wkl_gens_)
+        {
+            p_wkl_gen->reset();
+        }
+        for (auto& lp_wkl_gens : lp_wkl_gens_)
+        {
+            for (auto& p_wkl_gen : lp_wkl_gens)
+            {
+                p_wkl_gen->reset();
+            }
+        }
+
         rep_fp_coal_profit_stats_.resize(scen_.num_fps);
         rep_fp_alone_profit_stats_.resize(scen_.num_fps);
         for (std::size_t fp = 0; fp < scen_.num_fps; ++fp)
@@ -1342,6 +2021,35 @@ private:
 
             rep_fp_coal_profit_stats_[fp]->reset();
             rep_fp_alone_profit_stats_[fp]->reset();
+            rep_fp_coal_profit_quantile_stats_[fp]->reset();
+            rep_fp_alone_profit_quantile_stats_[fp]->reset();
+            rep_fp_profit_ratio_quantile_stats_[fp]->reset();
+        }
+
+        if (p_game_log_reader_)
+        {
+            // Schedule the recorded intervals of the next replication in the
+            // game log in place of the workload
+
+            rep_replay_records_.clear();
+            if (has_replay_record_)
+            {
+                auto const replication = next_replay_record_.replication;
+                do
+                {
+                    auto p_state = std::make_shared<coalition_formation_trigger_event_state_t>();
+                    p_state->start_time = next_replay_record_.start_time;
+                    p_state->stop_time = next_replay_record_.stop_time;
+                    this->schedule_event(p_state->stop_time, coalition_formation_trigger_event, p_state);
+
+                    rep_replay_records_.push_back(next_replay_record_);
+
+                    has_replay_record_ = p_game_log_reader_->read(next_replay_record_);
+                }
+                while (has_replay_record_ && next_replay_record_.replication == replication);
+            }
+
+            return;
         }
 
         // Schedule initial events
@@ -1357,12 +2065,10 @@ private:
 
             assert( svc < svc_categories_.size() );
 
-            auto const svc_cat = svc_categories_[svc];
-
             auto p_state = std::make_shared<arrival_burst_event_state_t>();
             p_state->service = svc;
-            std::tie(p_state->duration, p_state->arrival_rate) = (*wkl_gens_[svc_cat])(rng_);
-            this->schedule_event(this->simulated_time(), arrival_burst_start_event, p_state);
+            this->generate_arrival_burst(*p_state);
+            this->schedule_arrival_burst_event(this->simulated_time(), arrival_burst_start_event, p_state);
         }
 
         auto p_state = std::make_shared<coalition_formation_trigger_event_state_t>();
@@ -1373,18 +2079,44 @@ private:
 
     void do_finalize_replication()
     {
+        // Evaluate the coalition formations deferred to the end of the replication (if any)
+
+        this->analyze_pending_coalitions();
+
         // Collect stats
 
         for (std::size_t fp = 0; fp < scen_.num_fps; ++fp)
         {
             fp_coal_profit_ci_stats_[fp]->collect(rep_fp_coal_profit_stats_[fp]->estimate());
             fp_alone_profit_ci_stats_[fp]->collect(rep_fp_alone_profit_stats_[fp]->estimate());
+
+            fp_coal_profit_quantile_stats_[fp]->merge(*rep_fp_coal_profit_quantile_stats_[fp]);
+            fp_alone_profit_quantile_stats_[fp]->merge(*rep_fp_alone_profit_quantile_stats_[fp]);
+            fp_profit_ratio_quantile_stats_[fp]->merge(*rep_fp_profit_ratio_quantile_stats_[fp]);
         }
 
-        if (opts_.verbosity >= low)
+        num_formations_ += rep_num_formations_;
+        num_skipped_formations_ += rep_num_skipped_formations_;
+
+        if (p_metrics_)
+        {
+            for (std::size_t fp = 0; fp < scen_.num_fps; ++fp)
+            {
+                p_metrics_->fp_coal_profit_relative_precisions[fp] = fp_coal_profit_ci_stats_[fp]->relative_precision();
+                p_metrics_->fp_alone_profit_relative_precisions[fp] = fp_alone_profit_ci_stats_[fp]->relative_precision();
+            }
+            p_metrics_->num_replications = this->num_replications();
+        }
+
+        if (opts_.verbosity >= low)
         {
             DCS_LOGGING_STREAM << "-- REPLICATION #" << this->num_replications() << std::endl;
 
+            if (opts_.coalition_formation_trigger == demand_change_coalition_formation_trigger)
+            {
+                DCS_LOGGING_STREAM << " - COALITION FORMATION TRIGGER: performed: " << rep_num_formations_ << ", skipped: " << rep_num_skipped_formations_ << std::endl;
+            }
+
             if (opts_.verbosity >= low_medium)
             {
                 DCS_LOGGING_STREAM << " - SUMMARY OUTPUTS:" << std::endl;
@@ -1429,6 +2161,11 @@ private:
 
     bool do_check_end_of_simulation() const
     {
+        if (p_game_log_reader_ && !has_replay_record_)
+        {
+            return true;
+        }
+
         return  check_stats(fp_coal_profit_ci_stats_.cbegin(), fp_coal_profit_ci_stats_.cend());
             //||  check_stats(fp_alone_profit_ci_stats_.cbegin(), fp_alone_profit_ci_stats_.cend());
     }
@@ -1472,15 +2209,19 @@ private:
         auto const svc = p_state->service;
         //auto const svc_cat = svc_categories_[svc];
 
-        DCS_DEBUG_TRACE("Processing 'ARRIVAL_BURST_START' event for service: " << svc << " (time: " << this->simulated_time() << ")");
+        // Burst events may be processed by logical processes, which do not
+        // advance the simulated time
+        auto const burst_start_time = p_event->fire_time;
+
+        DCS_DEBUG_TRACE("Processing 'ARRIVAL_BURST_START' event for service: " << svc << " (time: " << burst_start_time << ")");
 
         DCS_DEBUG_ASSERT( svc < rep_svc_wkl_bursts_.size() );
 
-        auto burst_stop_time = this->simulated_time() + p_state->duration;
+        auto burst_stop_time = burst_start_time + p_state->duration;
 
-        rep_svc_wkl_bursts_[svc].push_back(std::make_tuple(this->simulated_time(), burst_stop_time, p_state->arrival_rate));
+        rep_svc_wkl_bursts_[svc].push_back(std::make_tuple(burst_start_time, burst_stop_time, p_state->arrival_rate));
 
-        this->schedule_event(burst_stop_time, arrival_burst_stop_event, p_state);
+        this->schedule_arrival_burst_event(burst_stop_time, arrival_burst_stop_event, p_state);
     }
 
     void process_arrival_burst_stop_event(const std::shared_ptr<event_t<RealT>>& p_event)
@@ -1500,15 +2241,46 @@ private:
         DCS_DEBUG_ASSERT( p_state );
 
         auto const svc = p_state->service;
-        auto const svc_cat = svc_categories_[svc];
 
-        DCS_DEBUG_TRACE("Processing 'ARRIVAL_BURST_STOP' event for service: " << svc << " (time: " << this->simulated_time() << ")");
+        DCS_DEBUG_TRACE("Processing 'ARRIVAL_BURST_STOP' event for service: " << svc << " (time: " << p_event->fire_time << ")");
 
         p_state = std::make_shared<arrival_burst_event_state_t>();
         p_state->service = svc;
-        std::tie(p_state->duration, p_state->arrival_rate) = (*wkl_gens_[svc_cat])(rng_);
+        this->generate_arrival_burst(*p_state);
+
+        this->schedule_arrival_burst_event(p_event->fire_time, arrival_burst_start_event, p_state);
+    }
+
+    /// Generates the duration and the arrival rate of the next workload burst
+    /// of the service of the given event state
+    void generate_arrival_burst(arrival_burst_event_state_t& state)
+    {
+        auto const svc_cat = svc_categories_[state.service];
+
+        if (lp_rngs_.empty())
+        {
+            std::tie(state.duration, state.arrival_rate) = (*wkl_gens_[svc_cat])(rng_);
+        }
+        else
+        {
+            auto const lp = state.service % lp_rngs_.size();
+
+            std::tie(state.duration, state.arrival_rate) = (*lp_wkl_gens_[lp][svc_cat])(lp_rngs_[lp]);
+        }
+    }
 
-        this->schedule_event(this->simulated_time(), arrival_burst_start_event, p_state);
+    /// Schedules a workload burst event, in the logical process of its
+    /// service (if any)
+    void schedule_arrival_burst_event(RealT time, event_tag_t tag, const std::shared_ptr<arrival_burst_event_state_t>& p_state)
+    {
+        if (lp_rngs_.empty())
+        {
+            this->schedule_event(time, tag, p_state);
+        }
+        else
+        {
+            this->schedule_lp_event(p_state->service % lp_rngs_.size(), time, tag, p_state);
+        }
     }
 
     void process_coalition_formation_trigger_event(const std::shared_ptr<event_t<RealT>>& p_event)
@@ -1524,6 +2296,20 @@ private:
 
         DCS_DEBUG_TRACE("Processing 'COALITION_FORMATION_TRIGGER' event - start: " << p_state->start_time << ", stop: " << p_state->stop_time << " (time: " << this->simulated_time() << ")");
 
+        if (p_metrics_)
+        {
+            p_metrics_->simulated_time = this->simulated_time();
+        }
+
+        if (p_game_log_reader_)
+        {
+            // Recorded intervals are scheduled all at once
+
+            this->replay_coalitions(*p_state);
+
+            return;
+        }
+
         this->analyze_coalitions(*p_state);
 
         // Schedule a new coalition formation trigger event
@@ -1534,11 +2320,76 @@ private:
         this->schedule_event(p_state->stop_time, coalition_formation_trigger_event, p_state);
     }
 
-    void analyze_coalitions(const coalition_formation_trigger_event_state_t& coal_form_state)
+    /**
+     * Partitions FPs into equivalence classes of interchangeable FPs, that is
+     * FPs with the same costs, revenues, penalties and FNs, and whose services
+     * see the same workload in the current interval.
+     * Returns the class of each FP.
+     */
+    std::vector<std::size_t> make_fp_classes(const std::vector<RealT>& svc_arrival_rates) const
     {
-        namespace gt = gtpack;
-        namespace alg = dcs::algorithm;
+        std::vector<std::vector<RealT>> fp_signatures(scen_.num_fps);
+        for (std::size_t fp = 0; fp < scen_.num_fps; ++fp)
+        {
+            auto& sig = fp_signatures[fp];
 
+            sig.push_back(scen_.fp_electricity_costs[fp]);
+            sig.push_back(scen_.fp_coalition_costs[fp]);
+            for (std::size_t fnc = 0; fnc < scen_.num_fn_categories; ++fnc)
+            {
+                sig.push_back(scen_.fp_num_fns[fp][fnc]);
+                sig.push_back(scen_.fp_fn_asleep_costs[fp][fnc]);
+                sig.push_back(scen_.fp_fn_awake_costs[fp][fnc]);
+            }
+            for (std::size_t svc_cat = 0; svc_cat < scen_.num_svc_categories; ++svc_cat)
+            {
+                sig.push_back(scen_.fp_num_svcs[fp][svc_cat]);
+                sig.push_back(scen_.fp_svc_revenues[fp][svc_cat]);
+                sig.push_back(scen_.fp_svc_penalties[fp][svc_cat]);
+            }
+
+            // Number of powered-on FNs, by FN category
+            std::vector<RealT> fn_power_states(scen_.num_fn_categories, 0);
+            for (std::size_t fn = 0; fn < num_fns_; ++fn)
+            {
+                if (fn_fps_[fn] == fp && rep_fn_power_states_[fn])
+                {
+                    fn_power_states[fn_categories_[fn]] += 1;
+                }
+            }
+            sig.insert(sig.end(), fn_power_states.begin(), fn_power_states.end());
+
+            // Arrival rates of services, by service category
+            std::vector<std::pair<std::size_t,RealT>> svc_rates;
+            for (std::size_t svc = 0; svc < num_svcs_; ++svc)
+            {
+                if (svc_fps_[svc] == fp)
+                {
+                    svc_rates.push_back(std::make_pair(svc_categories_[svc], svc_arrival_rates[svc]));
+                }
+            }
+            std::sort(svc_rates.begin(), svc_rates.end());
+            for (auto const& svc_rate : svc_rates)
+            {
+                sig.push_back(svc_rate.first);
+                sig.push_back(svc_rate.second);
+            }
+        }
+
+        std::vector<std::size_t> fp_classes(scen_.num_fps);
+        std::map<std::vector<RealT>,std::size_t> signature_classes;
+        for (std::size_t fp = 0; fp < scen_.num_fps; ++fp)
+        {
+            auto const ins = signature_classes.insert(std::make_pair(fp_signatures[fp], signature_classes.size()));
+
+            fp_classes[fp] = ins.first->second;
+        }
+
+        return fp_classes;
+    }
+
+    void analyze_coalitions(const coalition_formation_trigger_event_state_t& coal_form_state)
+    {
         // Analyze the best coalitions for the just finished trigger interval
         // NOTE: We use a backward evaluation: analyze the workload arrived to
         //       date and then analyze the best FP coalitions that should form
@@ -1549,18 +2400,299 @@ private:
         //       of the coalition formation algorithm).
 
         auto const cur_timestamp = std::time(nullptr);
+        auto const coalition_duration = coal_form_state.stop_time - coal_form_state.start_time;
+
+        auto const demand = this->analyze_demand(coal_form_state);
+
+        auto const formed = this->check_coalition_formation_trigger(coal_form_state, demand);
+
+        if (formed)
+        {
+            rep_last_formation_demand_ = demand;
+            rep_last_formation_time_ = coal_form_state.stop_time;
+            rep_last_formation_duration_ = coalition_duration;
+
+            ++rep_num_formations_;
+        }
+        else
+        {
+            DCS_DEBUG_TRACE("Coalition formation skipped: the demand has not changed since time " << rep_last_formation_time_);
+
+            ++rep_num_skipped_formations_;
+        }
+
+        if (opts_.num_threads != 1)
+        {
+            // The coalition games of different intervals are independent of
+            // each other (the demand has already been derived and FN power
+            // states do not change within a replication), so they are
+            // evaluated all together at the end of the replication
+
+            if (formed)
+            {
+                pending_formation_t formation;
+                formation.demand = demand;
+                formation.duration = coalition_duration;
+
+                rep_pending_formations_.push_back(formation);
+            }
+
+            pending_interval_t interval;
+            interval.state = coal_form_state;
+            interval.timestamp = cur_timestamp;
+            interval.formation = rep_pending_formations_.size()-1;
+            interval.formed = formed;
+
+            rep_pending_intervals_.push_back(interval);
+
+            return;
+        }
+
+        if (formed)
+        {
+            rep_last_formation_ = this->evaluate_formation(demand, coalition_duration);
+
+            this->report_coalitions(coal_form_state, rep_last_formation_, cur_timestamp);
+        }
+        else
+        {
+            // Reuse the previous partition and profits (rescaled to the length of this interval)
+
+            this->report_coalitions(coal_form_state,
+                                    scale_formation(rep_last_formation_, coalition_duration/rep_last_formation_duration_),
+                                    cur_timestamp);
+        }
+    }
+
+    /// Evaluates the coalition formations deferred in the current replication
+    /// on multiple threads, and then reports them in interval order
+    void analyze_pending_coalitions()
+    {
+        if (rep_pending_intervals_.empty())
+        {
+            return;
+        }
+
+        DCS_DEBUG_TRACE("Evaluating " << rep_pending_formations_.size() << " coalition formations on " << num_parallel_threads(opts_.num_threads) << " threads");
+
+        std::vector<interval_formation_t> formations(rep_pending_formations_.size());
+
+        parallel_for(formations.size(),
+                     opts_.num_threads,
+                     [&](std::size_t i)
+                     {
+                        formations[i] = this->evaluate_formation(rep_pending_formations_[i].demand, rep_pending_formations_[i].duration);
+                     });
+
+        for (auto const& interval : rep_pending_intervals_)
+        {
+            if (interval.formed)
+            {
+                this->report_coalitions(interval.state, formations[interval.formation], interval.timestamp);
+            }
+            else
+            {
+                auto const coalition_duration = interval.state.stop_time - interval.state.start_time;
+
+                this->report_coalitions(interval.state,
+                                        scale_formation(formations[interval.formation], coalition_duration/rep_pending_formations_[interval.formation].duration),
+                                        interval.timestamp);
+            }
+        }
+
+        rep_pending_intervals_.clear();
+        rep_pending_formations_.clear();
+    }
+
+    /// Tells if the coalition formation has to be performed for the given
+    /// interval, according to the coalition formation trigger policy
+    bool check_coalition_formation_trigger(const coalition_formation_trigger_event_state_t& coal_form_state, const interval_demand_t& demand) const
+    {
+        if (opts_.coalition_formation_trigger == periodic_coalition_formation_trigger
+            || rep_num_formations_ == 0)
+        {
+            return true;
+        }
+
+        if (opts_.coalition_formation_max_staleness > 0
+            && (coal_form_state.stop_time-rep_last_formation_time_) >= opts_.coalition_formation_max_staleness)
+        {
+            return true;
+        }
+
+        for (std::size_t svc = 0; svc < num_svcs_; ++svc)
+        {
+            auto const old_num_vms = rep_last_formation_demand_.svc_num_vms[svc];
+            auto const new_num_vms = demand.svc_num_vms[svc];
+            auto const delta_num_vms = (new_num_vms > old_num_vms) ? (new_num_vms-old_num_vms) : (old_num_vms-new_num_vms);
+
+            if (delta_num_vms > 0 && delta_num_vms >= opts_.coalition_formation_trigger_vms_threshold)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /// Scales coalition values and payoffs by the given factor.
+    /// The scaled outcome is meant to be reused, and thus is not marked as
+    /// planned.
+    static interval_formation_t scale_formation(interval_formation_t formation, RealT factor)
+    {
+        formation.planned = false;
+
+        for (auto& coal_info : formation.formed_coalitions.coalitions)
+        {
+            coal_info.second.value *= factor;
+            for (auto& payoff_info : coal_info.second.payoffs)
+            {
+                payoff_info.second *= factor;
+            }
+        }
+        for (auto& partition : formation.formed_coalitions.best_partitions)
+        {
+            partition.value *= factor;
+            for (auto& payoff_info : partition.payoffs)
+            {
+                payoff_info.second *= factor;
+            }
+        }
+        for (auto& profit : formation.fp_alone_profits)
+        {
+            profit *= factor;
+        }
+
+        return formation;
+    }
+
+    /**
+     * Values every disconnected sub-coalition of the given coalition by the
+     * graph-restricted game (R.B. Myerson, "Graphs and Cooperation in Games",
+     * Mathematics of Operations Research 2(3), 1977), i.e., as the sum of the
+     * values of its connected components.
+     * Such values are needed to compute payoffs in the subgame of the given
+     * coalition, since disconnected coalitions are never analyzed.
+     * The connected sub-coalitions must have already been valued.
+     */
+    void value_disconnected_coalitions(gtpack::cooperative_game<RealT>& game, gtpack::cid_type cid, std::set<gtpack::cid_type>& valued_cids) const
+    {
+        // Enumerate the non-empty sub-coalitions of the given coalition
+        for (gtpack::cid_type sub_cid = cid; sub_cid != gtpack::empty_cid; sub_cid = (sub_cid-1) & cid)
+        {
+            if (valued_cids.count(sub_cid) > 0)
+            {
+                continue;
+            }
+
+            // Split the sub-coalition into its connected components
+            RealT value = 0;
+            std::size_t num_components = 0;
+            gtpack::cid_type left_cid = sub_cid;
+            while (left_cid != gtpack::empty_cid)
+            {
+                gtpack::cid_type comp_cid = left_cid & (~left_cid+1); // lowest FP
+                gtpack::cid_type frontier_cid = comp_cid;
+                while (frontier_cid != gtpack::empty_cid)
+                {
+                    gtpack::cid_type next_cid = gtpack::empty_cid;
+                    for (std::size_t fp = 0; fp < scen_.num_fps; ++fp)
+                    {
+                        if (frontier_cid & gtpack::make_coalition_id(fp))
+                        {
+                            next_cid |= fp_adjacency_cids_[fp];
+                        }
+                    }
+                    frontier_cid = next_cid & sub_cid & ~comp_cid;
+                    comp_cid |= frontier_cid;
+                }
+
+                value += game.value(comp_cid);
+                ++num_components;
+                left_cid &= ~comp_cid;
+            }
+
+            if (num_components > 1)
+            {
+                game.value(sub_cid, value);
+            }
+
+            valued_cids.insert(sub_cid);
+        }
+    }
+
+    /// Returns the outcome of the coalition formation for the given workload
+    /// demand over an interval of the given duration, possibly reusing the
+    /// memoized outcome of an interval with the same arrival rates.
+    /// Since coalition values are proportional to the interval duration,
+    /// outcomes are memoized for a unit duration and then rescaled.
+    interval_formation_t evaluate_formation(const interval_demand_t& demand, RealT coalition_duration)
+    {
+        if (!opts_.interval_memo)
+        {
+            return this->form_coalitions(demand, coalition_duration);
+        }
+
+        bool memo_hit = false;
+        interval_formation_t unit_formation;
+        {
+            std::lock_guard<std::mutex> lock(p_formation_cache_->interval_memo_mutex);
+
+            auto const memo_it = p_formation_cache_->interval_memo.find(demand.svc_arrival_rates);
+            if (memo_it != p_formation_cache_->interval_memo.end())
+            {
+                memo_hit = true;
+                unit_formation = memo_it->second;
+                ++num_interval_memo_hits_;
+                if (p_metrics_)
+                {
+                    ++p_metrics_->num_interval_memo_hits;
+                }
+            }
+            else
+            {
+                ++num_interval_memo_misses_;
+                if (p_metrics_)
+                {
+                    ++p_metrics_->num_interval_memo_misses;
+                }
+            }
+        }
+
+        if (!memo_hit)
+        {
+            unit_formation = this->form_coalitions(demand, 1);
+
+            std::lock_guard<std::mutex> lock(p_formation_cache_->interval_memo_mutex);
+
+            p_formation_cache_->interval_memo[demand.svc_arrival_rates] = unit_formation;
+        }
+        else
+        {
+            DCS_DEBUG_TRACE("Coalition formation outcome found in the interval memo");
+
+            unit_formation.planned = false;
+        }
+
+        auto formation = scale_formation(unit_formation, coalition_duration);
+        formation.planned = unit_formation.planned;
+
+        return formation;
+    }
+
+    /// Determines the workload demand of the given coalition formation
+    /// interval from the workload bursts arrived to date, and discards the
+    /// bursts that will not be needed anymore
+    interval_demand_t analyze_demand(const coalition_formation_trigger_event_state_t& coal_form_state)
+    {
         auto const coal_form_start_time = coal_form_state.start_time;
         auto const coal_form_stop_time = coal_form_state.stop_time;
-        auto const coalition_duration = coal_form_stop_time - coal_form_start_time;
 
         // Determines the maximum arrival rate of the workload bursts arrived in the last coalition formation interval
 
-        std::vector<std::vector<RealT>> svc_predicted_delays(num_svcs_);
-        std::vector<std::size_t> vm_svcs;
+        std::vector<RealT> svc_arrival_rates(num_svcs_, 0);
         for (std::size_t svc = 0; svc < num_svcs_; ++svc)
         {
-            auto const svc_cat = svc_categories_[svc];
-
             RealT max_rate = 0;
             std::size_t b = 0;
             while (b < rep_svc_wkl_bursts_[svc].size())
@@ -1581,121 +2713,734 @@ DCS_DEBUG_TRACE("Service: " << svc << ", Burst #" << b << ", start: " << burst_s
                 {
                     // This burst is inside this coalition formation interval -> analyze
 
-                    if (max_rate < arr_rate)
-                    {
-                        max_rate = arr_rate;
-                    }
+                    if (max_rate < arr_rate)
+                    {
+                        max_rate = arr_rate;
+                    }
+
+                    if (burst_stop < coal_form_stop_time)
+                    {
+                        // This burst is already done -> erase
+                        rep_svc_wkl_bursts_[svc].erase(rep_svc_wkl_bursts_[svc].cbegin()+b);
+                    }
+                    else
+                    {
+                        ++b;
+                    }
+                }
+                else
+                {
+                    // This burst starts in the next coalition formation interval and thus will be considered later
+                    break;
+                }
+            }
+
+            svc_arrival_rates[svc] = max_rate;
+        }
+
+        return this->make_demand(svc_arrival_rates);
+    }
+
+    /// Determines the workload demand for the given (maximum) arrival rate of
+    /// each service
+    interval_demand_t make_demand(const std::vector<RealT>& svc_arrival_rates) const
+    {
+        DCS_ASSERT(svc_arrival_rates.size() == num_svcs_,
+                   DCS_EXCEPTION_THROW(std::invalid_argument, "Unexpected number of services in arrival rates"));
+
+        std::vector<std::vector<RealT>> svc_predicted_delays(num_svcs_);
+        std::vector<std::size_t> svc_num_vms(num_svcs_, 0);
+        std::vector<std::size_t> vm_svcs;
+        // The first service of every category and arrival rate, whose
+        // performance model is shared by the other services of the same class
+        std::map<std::pair<std::size_t,RealT>,std::size_t> class_svcs;
+        for (std::size_t svc = 0; svc < num_svcs_; ++svc)
+        {
+            auto const svc_class = std::make_pair(svc_categories_[svc], svc_arrival_rates[svc]);
+
+            auto it = std::isnan(svc_arrival_rates[svc]) ? class_svcs.end() : class_svcs.find(svc_class);
+            if (it != class_svcs.end())
+            {
+                svc_predicted_delays[svc] = svc_predicted_delays[it->second];
+                svc_num_vms[svc] = svc_num_vms[it->second];
+            }
+            else
+            {
+                svc_num_vms[svc] = this->predict_service_delays(svc, svc_arrival_rates[svc], svc_predicted_delays[svc]);
+
+                if (!std::isnan(svc_arrival_rates[svc]))
+                {
+                    class_svcs[svc_class] = svc;
+                }
+            }
+
+            vm_svcs.insert(vm_svcs.end(), svc_num_vms[svc], svc);
+        }
+
+        interval_demand_t demand;
+        demand.svc_arrival_rates = svc_arrival_rates;
+        demand.svc_num_vms = svc_num_vms;
+        demand.svc_predicted_delays = svc_predicted_delays;
+        demand.vm_svcs = vm_svcs;
+
+        return demand;
+    }
+
+    /// Predicts the delay of the given service for every number of VMs when
+    /// its arrival rate is \a rate, and returns the min number of VMs needed
+    /// to meet its max delay
+    std::size_t predict_service_delays(std::size_t svc, RealT rate, std::vector<RealT>& predicted_delays) const
+    {
+        auto const svc_cat = svc_categories_[svc];
+
+        MMc<double> svc_perf_model(rate, scen_.svc_vm_service_rates[svc_cat], scen_.svc_max_delays[svc_cat], opts_.service_delay_tolerance);
+        auto min_num_vms = svc_perf_model.computeQueueParameters(true);
+        svc_perf_model.getDelays(&predicted_delays);
+
+        DCS_DEBUG_TRACE("Service: " << svc << ", arrival rate: " << rate << ", service rate: " << scen_.svc_vm_service_rates[svc_cat] << ", max delay: " << scen_.svc_max_delays[svc_cat] << " -> Min number of VMs: " << min_num_vms << ", Predicted delay: " << predicted_delays.back());
+
+        return min_num_vms;
+    }
+
+    /// Divides the value of the coalition of all the players of the given
+    /// (sub)game among them, according to the value division rule in use
+    std::map<gtpack::pid_type,RealT> divide_coalition_value(const gtpack::cooperative_game<RealT>& subgame) const
+    {
+        switch (opts_.coalition_value_division)
+        {
+            case shapley_coalition_value_division:
+                return gtpack::shapley_value(subgame);
+            default:
+                DCS_EXCEPTION_THROW(std::runtime_error, "Unknown coalition value division rule");
+        }
+    }
+
+    /// Checks if the core of the given subgame of a coalition is empty and,
+    /// if not, if the payoffs of the coalition belong to it.
+    /// With a separation check, only the latter is checked, by searching a
+    /// coalition of the subgame, over an interval of the given duration,
+    /// whose value exceeds the payoffs of its members (so the emptiness of
+    /// the core stays unknown when the payoffs are not in it).
+    void check_coalition_core(gtpack::cid_type cid, const gtpack::cooperative_game<RealT>& subgame, RealT coalition_duration, coalition_info_t<RealT>& coal_info) const
+    {
+        if (opts_.core_check == separation_core_check)
+        {
+            auto const& fp_max_profit_rates = fp_max_profit_rates_;
+
+            coal_info.payoffs_in_core = gtpack::belongs_to_core_by_separation(subgame,
+                                                                              coal_info.payoffs.begin(),
+                                                                              coal_info.payoffs.end(),
+                                                                              [&](gtpack::cid_type, gtpack::cid_type upper_cid)
+                                                                              {
+                                                                                RealT bound = 0;
+                                                                                for (std::size_t fp = 0; fp < fp_max_profit_rates.size(); ++fp)
+                                                                                {
+                                                                                    if (upper_cid & gtpack::make_coalition_id(fp))
+                                                                                    {
+                                                                                        bound += fp_max_profit_rates[fp];
+                                                                                    }
+                                                                                }
+                                                                                return bound*coalition_duration;
+                                                                              });
+            // Payoffs in the core prove it non-empty, while payoffs out of it
+            // tell nothing about its emptiness
+            if (coal_info.payoffs_in_core)
+            {
+                coal_info.core_empty = false;
+            }
+            coal_info.core_empty_known = coal_info.payoffs_in_core;
+
+            DCS_DEBUG_TRACE( "CID: " << cid << " - The coalition value " << (coal_info.payoffs_in_core ? "belongs" : "does not belong") << " to the core" );
+
+            return;
+        }
+
+        gtpack::core<RealT> core = gtpack::find_core(subgame);
+        if (core.empty())
+        {
+            DCS_DEBUG_TRACE( "CID: " << cid << " - The core is empty" );
+
+            coal_info.core_empty = true;
+            coal_info.core_empty_known = true;
+            coal_info.payoffs_in_core = false;
+
+            if (subgame.num_players() == scen_.num_fps)
+            {
+                DCS_DEBUG_TRACE( "CID: " << cid << " - The grand-coalition has an empty core" );
+            }
+        }
+        else
+        {
+            DCS_DEBUG_TRACE( "CID: " << cid << " - The core is not empty" );
+
+            coal_info.core_empty = false;
+            coal_info.core_empty_known = true;
+
+            // Check if the value is in the core
+
+            coal_info.payoffs_in_core = gtpack::belongs_to_core(subgame, coal_info.payoffs.begin(), coal_info.payoffs.end());
+
+            DCS_DEBUG_TRACE( "CID: " << cid << " - The coalition value " << (coal_info.payoffs_in_core ? "belongs" : "does not belong") << " to the core" );
+        }
+    }
+
+    /// Selects the stable partitions of the given game according to the
+    /// stability notion in use, possibly up to the symmetry among the FPs in
+    /// the same of the given classes.
+    /// When stability notions are compared, the partitions that are stable
+    /// according to every notion are selected in the same enumeration, and
+    /// their number is stored in \a num_stable_partitions
+    std::vector<partition_info_t<RealT>> select_partitions(const gtpack::cooperative_game<RealT>& game,
+                                                           const std::map<gtpack::cid_type,coalition_info_t<RealT>>& visited_coalitions,
+                                                           const std::vector<std::size_t>& fp_classes,
+                                                           bool symmetric_formation,
+                                                           std::map<coalition_formation_category, std::size_t>& num_stable_partitions)
+    {
+        if (opts_.compare_stability)
+        {
+            auto stable_partitions = multi_stable_partition_selector_t<RealT>(stability_categories().begin(), stability_categories().end())(game, visited_coalitions);
+
+            for (auto const& category_partitions : stable_partitions)
+            {
+                num_stable_partitions[category_partitions.first] = category_partitions.second.size();
+            }
+
+            return stable_partitions.at(opts_.coalition_formation);
+        }
+
+        switch (opts_.coalition_formation)
+        {
+            case nash_stable_coalition_formation:
+                if (symmetric_formation)
+                {
+                    return symmetric_nash_stable_partition_selector_t<RealT>(fp_classes.begin(), fp_classes.end())(game, visited_coalitions);
+                }
+                return nash_selector_(game, visited_coalitions);
+            case individually_stable_coalition_formation:
+            case contractually_individually_stable_coalition_formation:
+            case core_stable_coalition_formation:
+                return multi_stable_partition_selector_t<RealT>(&opts_.coalition_formation, &opts_.coalition_formation+1)(game, visited_coalitions).at(opts_.coalition_formation);
+            default:
+                DCS_EXCEPTION_THROW(std::runtime_error, "Unknown coalition formation stability selector");
+        }
+    }
+
+    /// The stability notions compared when \c options_t::compare_stability is set
+    static const std::vector<coalition_formation_category>& stability_categories()
+    {
+        static const std::vector<coalition_formation_category> categories = {nash_stable_coalition_formation,
+                                                                             individually_stable_coalition_formation,
+                                                                             contractually_individually_stable_coalition_formation,
+                                                                             core_stable_coalition_formation};
+
+        return categories;
+    }
+
+    /**
+     * Solves the given VM allocation problem, unless it is found in the
+     * solution store (if any).
+     *
+     * If \a planned_num_fps is positive, the time taken by the solver is
+     * reported to the strategy planner as that of a coalition of
+     * \a planned_num_fps FPs.
+     * If \a p_model_cache is not null, the model is composed from the blocks
+     * cached for the other coalitions of the same interval.
+     * The optimal objective value is known to lie between
+     * \a objective_lower_bound and \a objective_upper_bound.
+     */
+    vm_allocation_t<RealT> solve_vm_allocation(const vm_allocation_problem_t<RealT>& problem,
+                                               RealT optim_time_limit,
+                                               std::size_t planned_num_fps,
+                                               vm_allocation_model_cache_t<RealT>* p_model_cache = nullptr,
+                                               RealT objective_lower_bound = -std::numeric_limits<RealT>::infinity(),
+                                               RealT objective_upper_bound = std::numeric_limits<RealT>::infinity())
+    {
+        fgt::optimal_vm_allocation_solver_t<RealT> opt_solver(opts_.optim_relative_tolerance, optim_time_limit);
+        opt_solver.objective_bounds(objective_lower_bound, objective_upper_bound);
+
+        return this->solve_or_find_vm_allocation(problem,
+                                                 planned_num_fps,
+                                                 opt_solver,
+                                                 [&]()
+                                                 {
+                                                    return p_model_cache ? opt_solver(problem, *p_model_cache) : opt_solver(problem);
+                                                 });
+    }
+
+    /**
+     * Solves the given VM allocation problem in aggregated form, unless it is
+     * found in the solution store (if any).
+     *
+     * The allocation of VMs to FNs is only expanded to every FN and VM when
+     * solutions are stored.
+     */
+    vm_allocation_t<RealT> solve_vm_allocation(const vm_allocation_class_problem_t<RealT>& problem,
+                                               RealT optim_time_limit,
+                                               std::size_t planned_num_fps,
+                                               RealT objective_lower_bound = -std::numeric_limits<RealT>::infinity(),
+                                               RealT objective_upper_bound = std::numeric_limits<RealT>::infinity())
+    {
+        fgt::optimal_vm_allocation_solver_t<RealT> opt_solver(opts_.optim_relative_tolerance, optim_time_limit);
+        opt_solver.objective_bounds(objective_lower_bound, objective_upper_bound);
+
+        bool const with_placement = p_vm_alloc_store_ != nullptr;
+
+        return this->solve_or_find_vm_allocation(problem,
+                                                 planned_num_fps,
+                                                 opt_solver,
+                                                 [&]()
+                                                 {
+                                                    return opt_solver(problem, with_placement);
+                                                 });
+    }
+
+    /// Calls the given solver of the given VM allocation problem, unless the
+    /// problem is found in the solution store (if any).
+    /// If no solution is found within the objective bounds of \a opt_solver
+    /// (which \a solve uses), the problem is solved again without them.
+    template <typename ProblemT, typename SolveT>
+    vm_allocation_t<RealT> solve_or_find_vm_allocation(const ProblemT& problem, std::size_t planned_num_fps, optimal_vm_allocation_solver_t<RealT>& opt_solver, SolveT solve)
+    {
+        fgt::vm_allocation_t<RealT> vm_alloc;
+
+        // Skip the instances already solved to optimality (possibly by other runs)
+        typename vm_allocation_store_t<RealT>::key_type vm_alloc_key = {0, 0};
+        if (p_vm_alloc_store_)
+        {
+            vm_alloc_key = vm_allocation_store_t<RealT>::make_key(opts_.optim_relative_tolerance, problem);
+
+            if (p_vm_alloc_store_->find(vm_alloc_key, vm_alloc))
+            {
+                return vm_alloc;
+            }
+        }
+
+        auto const solve_start_clock = std::chrono::steady_clock::now();
+
+        vm_alloc = solve();
+
+        if (!vm_alloc.solved && opt_solver.has_objective_bounds())
+        {
+            opt_solver.objective_bounds(-std::numeric_limits<RealT>::infinity(), std::numeric_limits<RealT>::infinity());
+
+            vm_alloc = solve();
+        }
+
+        if (planned_num_fps > 0)
+        {
+            planner_.observe_solve(planned_num_fps, std::chrono::duration<RealT>(std::chrono::steady_clock::now()-solve_start_clock).count());
+        }
+
+        if (p_metrics_)
+        {
+            ++p_metrics_->num_solver_calls;
+        }
+
+        if (p_vm_alloc_store_)
+        {
+            p_vm_alloc_store_->insert(vm_alloc_key, vm_alloc);
+        }
+
+        return vm_alloc;
+    }
+
+    /**
+     * Solves, before the simulation, the VM allocation of every coalition for
+     * every combination of the arrival rates its services can take.
+     *
+     * With deterministic workloads, the arrival rate of a service in any
+     * interval is one of the rates in the step table of its category.
+     * Since the VM allocation of a coalition only depends on the demand of
+     * its own services, the allocations are solved (in parallel) by CID and
+     * arrival rates of the coalition services, and then looked up by
+     * \c value_coalitions instead of calling the solver.
+     * Coalitions with too many combinations of rates are left to be solved
+     * on demand.
+     */
+    void precompute_coalition_values()
+    {
+        // Max number of demand states precomputed for a single coalition
+        const std::size_t max_coalition_states = 4096;
+
+        auto const start_clock = std::chrono::steady_clock::now();
+
+        // The distinct arrival rates of every service category
+        std::vector<std::vector<RealT>> svc_cat_rates(scen_.num_svc_categories);
+        for (std::size_t svc_cat = 0; svc_cat < scen_.num_svc_categories; ++svc_cat)
+        {
+            for (auto const& step : scen_.svc_workloads[svc_cat])
+            {
+                svc_cat_rates[svc_cat].push_back(step.second);
+            }
+            std::sort(svc_cat_rates[svc_cat].begin(), svc_cat_rates[svc_cat].end());
+            svc_cat_rates[svc_cat].erase(std::unique(svc_cat_rates[svc_cat].begin(), svc_cat_rates[svc_cat].end()), svc_cat_rates[svc_cat].end());
+        }
+
+        // Enumerate the demand states of every coalition
+        std::vector<std::pair<std::size_t,std::vector<RealT>>> coal_states; // (coalition, arrival rates of the coalition services)
+        std::size_t num_skipped_coalitions = 0;
+        for (std::size_t c = 0; c < feasible_coal_fps_.size(); ++c)
+        {
+            std::vector<std::size_t> coal_svcs;
+            for (auto const fp : feasible_coal_fps_[c])
+            {
+                coal_svcs.insert(coal_svcs.end(), fp_svcs_[fp].begin(), fp_svcs_[fp].end());
+            }
+
+            std::size_t num_states = 1;
+            for (auto const svc : coal_svcs)
+            {
+                num_states *= svc_cat_rates[svc_categories_[svc]].size();
+                if (num_states > max_coalition_states)
+                {
+                    break;
+                }
+            }
+            if (num_states == 0 || num_states > max_coalition_states)
+            {
+                ++num_skipped_coalitions;
+                continue;
+            }
+
+            // Mixed-radix enumeration of the rate of every service
+            std::vector<std::size_t> rate_idxs(coal_svcs.size(), 0);
+            for (std::size_t k = 0; k < num_states; ++k)
+            {
+                std::vector<RealT> rates(coal_svcs.size());
+                for (std::size_t i = 0; i < coal_svcs.size(); ++i)
+                {
+                    rates[i] = svc_cat_rates[svc_categories_[coal_svcs[i]]][rate_idxs[i]];
+                }
+                coal_states.push_back(std::make_pair(c, rates));
+
+                for (std::size_t i = 0; i < coal_svcs.size(); ++i)
+                {
+                    if (++rate_idxs[i] < svc_cat_rates[svc_categories_[coal_svcs[i]]].size())
+                    {
+                        break;
+                    }
+                    rate_idxs[i] = 0;
+                }
+            }
+        }
+
+        // Solve every demand state of every coalition (FNs are powered on at
+        // the beginning of every replication)
+        const std::vector<bool> fn_power_states(num_fns_, true);
+        std::vector<vm_allocation_t<RealT>> vm_allocs(coal_states.size());
+        parallel_for(coal_states.size(),
+                     opts_.num_threads,
+                     [&](std::size_t k)
+                     {
+                        auto const& coal_fps = feasible_coal_fps_[coal_states[k].first];
+                        auto const& rates = coal_states[k].second;
+
+                        std::vector<std::size_t> coal_fns;
+                        std::vector<std::size_t> coal_svcs;
+                        std::vector<std::size_t> coal_vms;
+                        std::vector<std::size_t> vm_svcs;
+                        std::vector<std::size_t> svc_num_vms(num_svcs_, 0);
+                        std::vector<std::vector<RealT>> svc_predicted_delays(num_svcs_);
+                        std::size_t i = 0;
+                        for (auto const fp : coal_fps)
+                        {
+                            coal_fns.insert(coal_fns.end(), fp_fns_[fp].begin(), fp_fns_[fp].end());
+
+                            for (auto const svc : fp_svcs_[fp])
+                            {
+                                auto const min_num_vms = this->predict_service_delays(svc, rates[i++], svc_predicted_delays[svc]);
+
+                                coal_svcs.push_back(svc);
+                                svc_num_vms[svc] = min_num_vms;
+                                vm_svcs.insert(vm_svcs.end(), min_num_vms, svc);
+                            }
+                        }
+
+                        if (opts_.aggregate_models)
+                        {
+                            auto const coal_fn_classes = make_vm_allocation_fn_classes(vm_alloc_features_, coal_fns, fn_power_states);
+
+                            const fgt::vm_allocation_class_problem_t<RealT> vm_alloc_problem(vm_alloc_features_,
+                                                                                             coal_fn_classes,
+                                                                                             coal_svcs,
+                                                                                             svc_num_vms,
+                                                                                             svc_predicted_delays);
+
+                            vm_allocs[k] = this->solve_vm_allocation(vm_alloc_problem, opts_.optim_time_limit, 0);
+                        }
+                        else
+                        {
+                            coal_vms.resize(vm_svcs.size());
+                            std::iota(coal_vms.begin(), coal_vms.end(), 0);
+
+                            const fgt::vm_allocation_problem_t<RealT> vm_alloc_problem(vm_alloc_features_,
+                                                                                       coal_fns,
+                                                                                       coal_vms,
+                                                                                       vm_svcs,
+                                                                                       fn_power_states,
+                                                                                       svc_predicted_delays);
+
+                            vm_allocs[k] = this->solve_vm_allocation(vm_alloc_problem, opts_.optim_time_limit, 0);
+                        }
+                     });
+
+        for (std::size_t k = 0; k < coal_states.size(); ++k)
+        {
+            auto const& coal_fps = feasible_coal_fps_[coal_states[k].first];
+            auto const cid = gtpack::make_coalition_id(coal_fps.begin(), coal_fps.end());
+
+            p_formation_cache_->coal_value_table[std::make_pair(cid, coal_states[k].second)] = vm_allocs[k];
+        }
+
+        if (opts_.verbosity > none)
+        {
+            DCS_LOGGING_STREAM << "-- Precomputed " << coal_states.size() << " coalition demand states (" << num_skipped_coalitions << " coalitions left to be solved on demand) in " << std::chrono::duration<RealT>(std::chrono::steady_clock::now()-start_clock).count() << "s" << std::endl;
+        }
+    }
+
+    /// Looks up the precomputed VM allocation of the given coalition, whose
+    /// services are \a coal_svcs, for the given arrival rates of services
+    bool find_precomputed_vm_allocation(gtpack::cid_type cid,
+                                        const std::vector<std::size_t>& coal_svcs,
+                                        const std::vector<RealT>& svc_arrival_rates,
+                                        vm_allocation_t<RealT>& vm_alloc)
+    {
+        auto const& coal_value_table = p_formation_cache_->coal_value_table;
+
+        if (coal_value_table.empty())
+        {
+            return false;
+        }
+
+        std::vector<RealT> rates;
+        for (auto const svc : coal_svcs)
+        {
+            rates.push_back(svc_arrival_rates[svc]);
+        }
+
+        auto const it = coal_value_table.find(std::make_pair(cid, rates));
+        if (it == coal_value_table.end())
+        {
+            return false;
+        }
+
+        vm_alloc = it->second;
+        ++num_value_table_hits_;
+
+        return true;
+    }
+
+    /**
+     * Values the given coalitions for the given workload demand over an
+     * interval of the given duration, and computes their payoffs and checks
+     * their core.
+     *
+     * Every coalition must follow its sub-coalitions, which must be valued
+     * too (or, with an FP topology, its connected sub-coalitions).
+     * With \a incremental_enabled, the given coalitions must be all the
+     * feasible ones, since their analysis is the starting point of the next
+     * coalition formation of this replication.
+     */
+    void value_coalitions(const interval_demand_t& demand,
+                          RealT coalition_duration,
+                          const std::vector<std::vector<std::size_t>>& coalitions,
+                          RealT optim_time_limit,
+                          bool incremental_enabled,
+                          bool planned,
+                          gtpack::cooperative_game<RealT>& game,
+                          std::map<gtpack::cid_type,coalition_info_t<RealT>>& visited_coalitions,
+                          std::vector<RealT>& fp_interval_alone_profits)
+    {
+        namespace gt = gtpack;
+
+        auto const& svc_arrival_rates = demand.svc_arrival_rates;
+        auto const& svc_predicted_delays = demand.svc_predicted_delays;
+        auto const& vm_svcs = demand.vm_svcs;
+
+        // The VMs of every service or, with aggregated models, the classes of
+        // interchangeable FNs of every FP
+        std::vector<std::vector<std::size_t>> svc_vms;
+        std::vector<std::vector<vm_allocation_fn_class_t>> fp_fn_classes;
+        if (opts_.aggregate_models)
+        {
+            fp_fn_classes.resize(scen_.num_fps);
+            for (std::size_t fp = 0; fp < scen_.num_fps; ++fp)
+            {
+                fp_fn_classes[fp] = make_vm_allocation_fn_classes(vm_alloc_features_, fp_fns_[fp], rep_fn_power_states_);
+            }
+        }
+        else
+        {
+            svc_vms.resize(num_svcs_);
+            for (std::size_t vm = 0; vm < vm_svcs.size(); ++vm)
+            {
+                svc_vms[vm_svcs[vm]].push_back(vm);
+            }
+        }
+
+        // Find the FPs whose demand changed since the previous coalition
+        // formation of this replication: the coalitions without such FPs
+        // (said clean) keep their values (up to the interval length), and so
+        // do their sub-coalitions, their payoffs and their core
 
-                    if (burst_stop < coal_form_stop_time)
-                    {
-                        // This burst is already done -> erase
-                        rep_svc_wkl_bursts_[svc].erase(rep_svc_wkl_bursts_[svc].cbegin()+b);
-                    }
-                    else
-                    {
-                        ++b;
-                    }
-                }
-                else
+        bool const incremental = incremental_enabled && rep_incremental_state_.valid;
+        auto const& prev_state = rep_incremental_state_;
+        RealT prev_scale = 1;
+        gt::cid_type dirty_fps_cid = gt::empty_cid;
+        if (incremental)
+        {
+            prev_scale = coalition_duration/prev_state.duration;
+
+            for (std::size_t svc = 0; svc < num_svcs_; ++svc)
+            {
+                if (svc_arrival_rates[svc] != prev_state.svc_arrival_rates[svc])
                 {
-                    // This burst starts in the next coalition formation interval and thus will be considered later
-                    break;
+                    dirty_fps_cid |= gt::make_coalition_id(svc_fps_[svc]);
                 }
             }
 
-            // Predict delays for this service
-            MMc<double> svc_perf_model(max_rate, scen_.svc_vm_service_rates[svc_cat], scen_.svc_max_delays[svc_cat], opts_.service_delay_tolerance);
-            auto min_num_vms = svc_perf_model.computeQueueParameters(true);
-            svc_perf_model.getDelays(&svc_predicted_delays[svc]);
+            DCS_DEBUG_TRACE("FPs with changed demand: CID=" << dirty_fps_cid);
+        }
 
-            DCS_DEBUG_TRACE("Service: " << svc << ", arrival rate: " << max_rate << ", service rate: " << scen_.svc_vm_service_rates[svc_cat] << ", max delay: " << scen_.svc_max_delays[svc_cat] << " -> Min number of VMs: " << min_num_vms << ", Predicted delay: " << svc_predicted_delays[svc].back());
+        std::set<gt::cid_type> restricted_cids;
 
-            vm_svcs.insert(vm_svcs.end(), min_num_vms, svc);
+        if (p_vm_alloc_frontier_)
+        {
+            p_vm_alloc_frontier_->bind(rep_fn_power_states_);
         }
 
-        std::vector<RealT> fp_interval_alone_profits(scen_.num_fps, std::numeric_limits<RealT>::quiet_NaN());
-        std::vector<RealT> fp_interval_coal_profits(scen_.num_fps, std::numeric_limits<RealT>::quiet_NaN());
+        // The model blocks shared by the VM allocation problems of this interval
+        std::unique_ptr<vm_allocation_model_cache_t<RealT>> p_model_cache;
+        if (opts_.incremental_models && !opts_.aggregate_models)
+        {
+            p_model_cache.reset(new vm_allocation_model_cache_t<RealT>(vm_alloc_features_));
+        }
 
-        // Solve the coalition formation problem
+        for (auto const& coal_fps : coalitions)
+        {
+            auto cid = gt::make_coalition_id(coal_fps.begin(), coal_fps.end());
 
-        gt::cooperative_game<RealT> game(scen_.num_fps, boost::make_shared<gt::enumerated_characteristic_function<RealT>>());
+            DCS_DEBUG_TRACE("--- COALITION: " << game.coalition(cid) << " (CID=" << cid << ")");//XXX
 
-        std::map<gt::cid_type,coalition_info_t<RealT>> visited_coalitions;
-        std::map<gt::pid_type, std::vector<partition_info_t<RealT>>> best_partitions;
-        //bool found_same_struc(false);
+            auto const coal_num_fps = coal_fps.size();
 
-        alg::lexicographic_subset subset(scen_.num_fps, false);
+            if (incremental && (cid & dirty_fps_cid) == gt::empty_cid)
+            {
+                // Clean coalition: reuse its previous analysis (rescaled to the length of this interval)
 
-        while (subset.has_next())
-        {
-            //typedef typename alg::subset_traits<std::size_t>::element_container element_container;
+                auto coal_info = prev_state.coalitions.at(cid);
+                coal_info.value *= prev_scale;
+                for (auto& payoff_info : coal_info.payoffs)
+                {
+                    payoff_info.second *= prev_scale;
+                }
 
-            DCS_DEBUG_TRACE("--- SUBSET: " << subset);//XXX
+                game.value(cid, prev_state.values.at(cid)*prev_scale);
 
-            auto coal_fps = alg::next_subset(fps_.begin(), fps_.end(), subset);
+                if (coal_num_fps == 1 && coal_info.vm_allocation.solved)
+                {
+                    fp_interval_alone_profits[coal_fps[0]] = coal_info.value;
+                }
 
-            auto cid = gt::make_coalition_id(coal_fps.begin(), coal_fps.end());
+                visited_coalitions[cid] = coal_info;
 
-            DCS_DEBUG_TRACE("--- COALITION: " << game.coalition(cid) << " (CID=" << cid << ")");//XXX
+                if (!scen_.fp_adjacency.empty())
+                {
+                    this->value_disconnected_coalitions(game, cid, restricted_cids);
+                }
 
-            auto const coal_num_fps = coal_fps.size();
+                ++num_reused_coalitions_;
+
+                continue;
+            }
 
-            std::vector<std::size_t> coal_fns;
             std::vector<std::size_t> coal_svcs;
-            std::vector<std::size_t> coal_vms;
-            //TODO: could be optimized by using auxiliary data structures (e.g., for each FP, stores the set of its service)
             for (std::size_t i = 0; i < coal_num_fps; ++i)
             {
                 auto const fp = coal_fps[i];
 
-                for (std::size_t fn = 0; fn < num_fns_; ++fn)
+                coal_svcs.insert(coal_svcs.end(), fp_svcs_[fp].begin(), fp_svcs_[fp].end());
+            }
+
+            // The demand of the coalition, which is monotone in the
+            // feasibility and in the cost of its VM allocation problem
+            std::vector<RealT> coal_rates;
+            RealT obj_lb = -std::numeric_limits<RealT>::infinity();
+            RealT obj_ub = std::numeric_limits<RealT>::infinity();
+            if (p_vm_alloc_frontier_)
+            {
+                for (auto const svc : coal_svcs)
+                {
+                    coal_rates.push_back(svc_arrival_rates[svc]);
+                }
+            }
+
+            fgt::vm_allocation_t<RealT> vm_alloc;
+            bool solve = !this->find_precomputed_vm_allocation(cid, coal_svcs, svc_arrival_rates, vm_alloc);
+            if (solve && p_vm_alloc_frontier_)
+            {
+                if (p_vm_alloc_frontier_->infeasible(cid, coal_rates))
+                {
+                    // Skip the problems with a higher demand than an infeasible one
+                    vm_alloc.infeasible = true;
+                    solve = false;
+                }
+                else
                 {
-                    if (fn_fps_[fn] == fp)
+                    p_vm_alloc_frontier_->objective_bounds(cid, coal_rates, obj_lb, obj_ub);
+                }
+            }
+            if (solve)
+            {
+                if (opts_.aggregate_models)
+                {
+                    std::vector<vm_allocation_fn_class_t> coal_fn_classes;
+                    for (std::size_t i = 0; i < coal_num_fps; ++i)
                     {
-                        coal_fns.push_back(fn);
+                        auto const fp = coal_fps[i];
+
+                        coal_fn_classes.insert(coal_fn_classes.end(), fp_fn_classes[fp].begin(), fp_fn_classes[fp].end());
                     }
-                }
 
-                for (std::size_t svc = 0; svc < num_svcs_; ++svc)
+                    const fgt::vm_allocation_class_problem_t<RealT> vm_alloc_problem(vm_alloc_features_,
+                                                                                     coal_fn_classes,
+                                                                                     coal_svcs,
+                                                                                     demand.svc_num_vms,
+                                                                                     svc_predicted_delays);
+
+                    vm_alloc = this->solve_vm_allocation(vm_alloc_problem, optim_time_limit, planned ? coal_num_fps : 0, obj_lb, obj_ub);
+                }
+                else
                 {
-                    if (svc_fps_[svc] == fp)
+                    std::vector<std::size_t> coal_fns;
+                    std::vector<std::size_t> coal_vms;
+                    for (std::size_t i = 0; i < coal_num_fps; ++i)
                     {
-                        coal_svcs.push_back(svc);
+                        auto const fp = coal_fps[i];
+
+                        coal_fns.insert(coal_fns.end(), fp_fns_[fp].begin(), fp_fns_[fp].end());
 
-                        auto num_vms = vm_svcs.size();
-                        for (std::size_t vm = 0; vm < num_vms; ++vm)
+                        for (auto const svc : fp_svcs_[fp])
                         {
-                            if (vm_svcs[vm] == svc)
-                            {
-                                coal_vms.push_back(vm);
-                            }
+                            coal_vms.insert(coal_vms.end(), svc_vms[svc].begin(), svc_vms[svc].end());
                         }
                     }
-                }
-            }
 
-            fgt::optimal_vm_allocation_solver_t<RealT> opt_solver(opts_.optim_relative_tolerance, opts_.optim_time_limit);
-            fgt::vm_allocation_t<RealT> vm_alloc;
+                    const fgt::vm_allocation_problem_t<RealT> vm_alloc_problem(vm_alloc_features_,
+                                                                               coal_fns,
+                                                                               coal_vms,
+                                                                               vm_svcs,
+                                                                               rep_fn_power_states_,
+                                                                               svc_predicted_delays);
+
+                    vm_alloc = this->solve_vm_allocation(vm_alloc_problem, optim_time_limit, planned ? coal_num_fps : 0, p_model_cache.get(), obj_lb, obj_ub);
+                }
 
-            vm_alloc = opt_solver(coal_fns,
-                                  coal_vms,
-                                  fn_fps_,
-                                  fn_categories_,
-                                  rep_fn_power_states_,
-                                  scen_.fn_min_powers,
-                                  scen_.fn_max_powers,
-                                  vm_svcs,
-                                  scen_.svc_vm_categories,
-                                  scen_.vm_cpu_requirements,
-                                  scen_.vm_ram_requirements,
-                                  svc_fps_,
-                                  svc_categories_,
-                                  scen_.svc_max_delays,
-                                  svc_predicted_delays,
-                                  scen_.fp_svc_penalties,
-                                  scen_.fp_electricity_costs,
-                                  scen_.fp_fn_asleep_costs,
-                                  scen_.fp_fn_awake_costs);
+                if (p_vm_alloc_frontier_)
+                {
+                    p_vm_alloc_frontier_->insert(cid, coal_rates, vm_alloc);
+                }
+            }
 
             visited_coalitions[cid].vm_allocation = vm_alloc;
 
@@ -1740,31 +3485,56 @@ DCS_DEBUG_TRACE("Service: " << svc << ", Burst #" << b << ", start: " << burst_s
 
                 DCS_DEBUG_TRACE( "CID: " << cid << " - VM allocation objective value: " << vm_alloc.objective_value << " => v(CID)=" << game.value(cid) );
 
-                gt::cooperative_game<RealT> subgame = game.subgame(coal_fps.begin(), coal_fps.end());
-                gt::core<RealT> core = gt::find_core(subgame);
-                if (core.empty())
+                if (!scen_.fp_adjacency.empty())
                 {
-                    DCS_DEBUG_TRACE( "CID: " << cid << " - The core is empty" );
+                    this->value_disconnected_coalitions(game, cid, restricted_cids);
+                }
+
+                gt::cooperative_game<RealT> subgame = game.subgame(coal_fps.begin(), coal_fps.end());
 
-                    visited_coalitions[cid].core_empty = true;
-                    visited_coalitions[cid].payoffs_in_core = false;
+                // Compute the coalition payoffs (i.e., FP profits), by
+                // updating the previous ones (if any) with the value changes
+                // of the sub-coalitions with some FP whose demand changed
+
+                std::map<gt::pid_type,RealT> coal_payoffs;
+                bool reuse_core = false;
+                if (incremental && prev_state.coalitions.at(cid).vm_allocation.solved)
+                {
+                    coal_payoffs = prev_state.coalitions.at(cid).payoffs;
+                    for (auto& payoff_info : coal_payoffs)
+                    {
+                        payoff_info.second *= prev_scale;
+                    }
 
-                    if (subgame.num_players() == scen_.num_fps)
+                    std::vector<std::pair<gt::cid_type,RealT>> value_deltas;
+                    for (gt::cid_type sub_cid = cid; sub_cid != gt::empty_cid; sub_cid = (sub_cid-1) & cid)
                     {
-                        DCS_DEBUG_TRACE( "CID: " << cid << " - The grand-coalition has an empty core" );
+                        if (sub_cid & dirty_fps_cid)
+                        {
+                            auto const delta = game.value(sub_cid) - prev_state.values.at(sub_cid)*prev_scale;
+
+                            if (delta != 0)
+                            {
+                                value_deltas.push_back(std::make_pair(sub_cid, delta));
+                            }
+                        }
                     }
+
+                    gt::update_shapley_value(subgame, coal_payoffs, value_deltas.begin(), value_deltas.end());
+                    reuse_core = value_deltas.empty();
+
+                    ++num_updated_coalitions_;
                 }
                 else
                 {
-                    DCS_DEBUG_TRACE( "CID: " << cid << " - The core is not empty" );
+                    coal_payoffs = this->divide_coalition_value(subgame);
 
-                    visited_coalitions[cid].core_empty = false;
+                    if (incremental_enabled)
+                    {
+                        ++num_recomputed_coalitions_;
+                    }
                 }
 
-                // Compute the coalition payoffs (i.e., FP profits)
-
-                std::map<gt::pid_type,RealT> coal_payoffs = gt::shapley_value(subgame);
-
 #ifdef DCS_DEBUG
                 for (auto fp : coal_fps)
                 {
@@ -1774,29 +3544,32 @@ DCS_DEBUG_TRACE("Service: " << svc << ", Burst #" << b << ", start: " << burst_s
 
                 visited_coalitions[cid].payoffs = coal_payoffs;
 
-                // Check if the value is in the core (if the core != empty)
+                // Check the core only if some sub-coalition value changed
 
-                if (!visited_coalitions.at(cid).core_empty)
+                if (reuse_core)
                 {
-                    if (gtpack::belongs_to_core(subgame, coal_payoffs.begin(), coal_payoffs.end()))
-                    {
-                        DCS_DEBUG_TRACE( "CID: " << cid << " - The coalition value belongs to the core" );
-
-                        visited_coalitions[cid].payoffs_in_core = true;
-                    }
-                    else
-                    {
-                        DCS_DEBUG_TRACE( "CID: " << cid << " - The coaition value does not belong to the core" );
+                    DCS_DEBUG_TRACE( "CID: " << cid << " - No sub-coalition value changed: the core is unchanged" );
 
-                        visited_coalitions[cid].payoffs_in_core = false;
-                    }
+                    visited_coalitions[cid].core_empty = prev_state.coalitions.at(cid).core_empty;
+                    visited_coalitions[cid].core_empty_known = prev_state.coalitions.at(cid).core_empty_known;
+                    visited_coalitions[cid].payoffs_in_core = prev_state.coalitions.at(cid).payoffs_in_core;
+                }
+                else
+                {
+                    this->check_coalition_core(cid, subgame, coalition_duration, visited_coalitions[cid]);
                 }
             }
             else
             {
                 DCS_DEBUG_TRACE( "CID: " << cid << " - The VM assignment problem is infeasible" );
 
+                if (incremental_enabled)
+                {
+                    ++num_recomputed_coalitions_;
+                }
+
                 visited_coalitions[cid].core_empty = true;
+                visited_coalitions[cid].core_empty_known = true;
                 visited_coalitions[cid].payoffs_in_core = false;
 
                 game.value(cid, -std::numeric_limits<RealT>::min());
@@ -1810,18 +3583,103 @@ DCS_DEBUG_TRACE("Service: " << svc << ", Burst #" << b << ", start: " << burst_s
             }
         }
 
+        if (incremental_enabled)
+        {
+            rep_incremental_state_.valid = true;
+            rep_incremental_state_.svc_arrival_rates = svc_arrival_rates;
+            rep_incremental_state_.duration = coalition_duration;
+            rep_incremental_state_.coalitions = visited_coalitions;
+            rep_incremental_state_.values.clear();
+            for (auto const& coal_info : visited_coalitions)
+            {
+                rep_incremental_state_.values[coal_info.first] = game.value(coal_info.first);
+            }
+            for (auto const sub_cid : restricted_cids)
+            {
+                rep_incremental_state_.values[sub_cid] = game.value(sub_cid);
+            }
+        }
+    }
+
+    /// Solves the coalition formation problem for the given workload demand
+    /// over an interval of the given duration
+    interval_formation_t form_coalitions(const interval_demand_t& demand, RealT coalition_duration)
+    {
+        namespace gt = gtpack;
+        namespace alg = dcs::algorithm;
+
+        auto const& svc_arrival_rates = demand.svc_arrival_rates;
+
+        std::vector<RealT> fp_interval_alone_profits(scen_.num_fps, std::numeric_limits<RealT>::quiet_NaN());
+
+        // Choose the formation and valuation strategies that fit the interval budget (if any)
+
+        auto const formation_start_clock = std::chrono::steady_clock::now();
+
+        bool const planned = opts_.interval_budget > 0;
+        std::vector<std::size_t> fp_classes;
+        std::vector<std::size_t> fp_class_sizes;
+        bool symmetric_formation = false;
+        // NOTE: the FP classes do not account for the FP topology
+        if (opts_.coalition_formation == nash_stable_coalition_formation && opts_.symmetry_reduction && !opts_.compare_stability && scen_.fp_adjacency.empty())
+        {
+            fp_classes = this->make_fp_classes(svc_arrival_rates);
+
+            fp_class_sizes.assign(*std::max_element(fp_classes.begin(), fp_classes.end())+1, 0);
+            for (auto const fp_class : fp_classes)
+            {
+                ++fp_class_sizes[fp_class];
+            }
+
+            if (fp_class_sizes.size() < scen_.num_fps)
+            {
+                symmetric_formation = true;
+            }
+            else
+            {
+                fp_class_sizes.clear();
+            }
+        }
+
+        strategy_plan_t<RealT> plan;
+        RealT optim_time_limit = opts_.optim_time_limit;
+        if (planned)
+        {
+            plan = planner_.plan(num_feasible_coals_by_size_, scen_.num_fps, fp_class_sizes, opts_.optim_time_limit);
+
+            symmetric_formation = plan.formation == symmetric_coalition_formation_strategy;
+            optim_time_limit = plan.time_limit;
+        }
+
+        // Solve the coalition formation problem
+
+        gt::cooperative_game<RealT> game(scen_.num_fps, boost::make_shared<gt::enumerated_characteristic_function<RealT>>());
+
+        std::map<gt::cid_type,coalition_info_t<RealT>> visited_coalitions;
+
+        this->value_coalitions(demand,
+                               coalition_duration,
+                               feasible_coal_fps_,
+                               optim_time_limit,
+                               opts_.incremental_payoffs && opts_.num_threads == 1 && opts_.coalition_value_division == shapley_coalition_value_division,
+                               planned,
+                               game,
+                               visited_coalitions,
+                               fp_interval_alone_profits);
+
         // Form stable coalitions
 
         coalition_formation_info_t<RealT> formed_coalitions;
 
+        auto const selection_start_clock = std::chrono::steady_clock::now();
+
         formed_coalitions.coalitions = visited_coalitions;
-        switch (opts_.coalition_formation)
+        std::map<coalition_formation_category, std::size_t> num_stable_partitions;
+        formed_coalitions.best_partitions = this->select_partitions(game, visited_coalitions, fp_classes, symmetric_formation, num_stable_partitions);
+
+        if (planned)
         {
-            case nash_stable_coalition_formation:
-                formed_coalitions.best_partitions = nash_stable_partition_selector_t<RealT>()(game, visited_coalitions);
-                break;
-            default:
-                DCS_EXCEPTION_THROW(std::runtime_error, "Unknown coalition formation stability selector");
+            planner_.observe_formation(plan.formation, scen_.num_fps, fp_class_sizes, formed_coalitions.best_partitions.size(), std::chrono::duration<RealT>(std::chrono::steady_clock::now()-selection_start_clock).count());
         }
 
 #ifdef DCS_DEBUG
@@ -1839,8 +3697,196 @@ DCS_DEBUG_TRACE("Service: " << svc << ", Burst #" << b << ", start: " << burst_s
         }
 #endif // DCS_DEBUG
 
+        interval_formation_t formation;
+        formation.formed_coalitions = formed_coalitions;
+        formation.fp_alone_profits = fp_interval_alone_profits;
+        formation.svc_arrival_rates = svc_arrival_rates;
+        formation.num_stable_partitions = num_stable_partitions;
+        if (planned)
+        {
+            formation.planned = true;
+            formation.plan = plan;
+            formation.elapsed_time = std::chrono::duration<RealT>(std::chrono::steady_clock::now()-formation_start_clock).count();
+
+            planner_.observe_plan(plan, formation.elapsed_time);
+        }
+
+        return formation;
+    }
+
+    /// Replays the next recorded interval of the current replication
+    void replay_coalitions(const coalition_formation_trigger_event_state_t& coal_form_state)
+    {
+        DCS_DEBUG_ASSERT( !rep_replay_records_.empty() );
+
+        auto const record = rep_replay_records_.front();
+        rep_replay_records_.pop_front();
+
+        DCS_DEBUG_ASSERT( record.stop_time == coal_form_state.stop_time );
+
+        auto const formation = this->analyze_recorded_game(record);
+
+        ++rep_num_formations_;
+
+        this->report_coalitions(coal_form_state, formation, record.timestamp);
+    }
+
+    /**
+     * Solves the coalition formation problem for the game recorded in a game
+     * log, that is computes payoffs, checks the core and selects stable
+     * partitions from the recorded coalition values (according to the value
+     * division rule and to the stability notion in use), without solving any
+     * VM allocation problem.
+     */
+    interval_formation_t analyze_recorded_game(const game_log_record_t<RealT>& record)
+    {
+        namespace gt = gtpack;
+
+        gt::cooperative_game<RealT> game(scen_.num_fps, boost::make_shared<gt::enumerated_characteristic_function<RealT>>());
+
+        std::map<gt::cid_type,coalition_info_t<RealT>> visited_coalitions;
+        std::vector<RealT> fp_interval_alone_profits(scen_.num_fps, std::numeric_limits<RealT>::quiet_NaN());
+        std::set<gt::cid_type> restricted_cids;
+
+        // NOTE: coalitions are recorded by CID, so that every coalition
+        //       follows its sub-coalitions
+        for (auto const& coal : record.coalitions)
+        {
+            auto const cid = coal.cid;
+            auto& coal_info = visited_coalitions[cid];
+
+            coal_info.vm_allocation.solved = coal.solved;
+
+            if (coal.solved)
+            {
+                game.value(cid, coal.value);
+                coal_info.value = coal.value;
+
+                auto const coal_fps = game.coalition(cid).players();
+
+                if (coal_fps.size() == 1)
+                {
+                    fp_interval_alone_profits[coal_fps[0]] = coal.value;
+                }
+
+                if (!scen_.fp_adjacency.empty())
+                {
+                    this->value_disconnected_coalitions(game, cid, restricted_cids);
+                }
+
+                gt::cooperative_game<RealT> subgame = game.subgame(coal_fps.begin(), coal_fps.end());
+
+                coal_info.payoffs = this->divide_coalition_value(subgame);
+
+                this->check_coalition_core(cid, subgame, record.stop_time-record.start_time, coal_info);
+            }
+            else
+            {
+                coal_info.core_empty = true;
+                coal_info.core_empty_known = true;
+                coal_info.payoffs_in_core = false;
+
+                game.value(cid, -std::numeric_limits<RealT>::min());
+            }
+        }
+
+        // Form stable coalitions
+
+        std::vector<std::size_t> fp_classes;
+        bool symmetric_formation = false;
+        // NOTE: the FP classes do not account for the FP topology
+        if (opts_.coalition_formation == nash_stable_coalition_formation && opts_.symmetry_reduction && !opts_.compare_stability && scen_.fp_adjacency.empty())
+        {
+            fp_classes = this->make_fp_classes(record.svc_arrival_rates);
+
+            symmetric_formation = *std::max_element(fp_classes.begin(), fp_classes.end())+1 < scen_.num_fps;
+        }
+
+        interval_formation_t formation;
+        formation.formed_coalitions.coalitions = visited_coalitions;
+        formation.formed_coalitions.best_partitions = this->select_partitions(game, visited_coalitions, fp_classes, symmetric_formation, formation.num_stable_partitions);
+        formation.fp_alone_profits = fp_interval_alone_profits;
+        formation.svc_arrival_rates = record.svc_arrival_rates;
+
+        return formation;
+    }
+
+    /// Records the coalition values of the given interval to the game log
+    void log_game(const coalition_formation_trigger_event_state_t& coal_form_state, const interval_formation_t& formation, std::time_t cur_timestamp)
+    {
+        game_log_record_t<RealT> record;
+
+        record.replication = this->num_replications();
+        record.timestamp = cur_timestamp;
+        record.start_time = coal_form_state.start_time;
+        record.stop_time = coal_form_state.stop_time;
+        record.svc_arrival_rates = formation.svc_arrival_rates;
+        for (auto const& coal_info : formation.formed_coalitions.coalitions)
+        {
+            game_log_coalition_t<RealT> coal;
+            coal.cid = coal_info.first;
+            coal.solved = coal_info.second.vm_allocation.solved;
+            coal.value = coal.solved ? coal_info.second.value : 0;
+
+            record.coalitions.push_back(coal);
+        }
+
+        p_game_log_writer_->write(record);
+    }
+
+    /// Outputs the outcome of the coalition formation in the given interval
+    /// and collects replication statistics
+    void report_coalitions(const coalition_formation_trigger_event_state_t& coal_form_state, const interval_formation_t& formation, std::time_t cur_timestamp)
+    {
+        namespace gt = gtpack;
+
+        if (p_game_log_writer_)
+        {
+            this->log_game(coal_form_state, formation, cur_timestamp);
+        }
+
+        if (p_metrics_)
+        {
+            ++p_metrics_->num_intervals;
+            p_metrics_->num_preference_cache_hits = nash_selector_.num_cache_hits();
+            p_metrics_->num_preference_cache_misses = nash_selector_.num_cache_misses();
+            if (p_vm_alloc_store_)
+            {
+                p_metrics_->num_solution_store_hits = p_vm_alloc_store_->num_hits();
+                p_metrics_->num_solution_store_misses = p_vm_alloc_store_->num_misses();
+            }
+        }
+
+        auto const coal_form_start_time = coal_form_state.start_time;
+        auto const coalition_duration = coal_form_state.stop_time - coal_form_state.start_time;
+        auto const& formed_coalitions = formation.formed_coalitions;
+        auto const& fp_interval_alone_profits = formation.fp_alone_profits;
+
+        std::vector<RealT> fp_interval_coal_profits(scen_.num_fps, std::numeric_limits<RealT>::quiet_NaN());
+
         // Collects statistics and outputs some information
 
+        for (auto const& category_count : formation.num_stable_partitions)
+        {
+            stability_num_partitions_stats_.at(category_count.first)->collect(category_count.second);
+            stability_existence_stats_.at(category_count.first)->collect(category_count.second > 0 ? 1 : 0);
+        }
+
+        if (!formation.num_stable_partitions.empty() && opts_.verbosity >= medium)
+        {
+            DCS_LOGGING_STREAM << "-- STABLE PARTITIONS (interval starting at " << coal_form_start_time << "):";
+            for (auto const& category_count : formation.num_stable_partitions)
+            {
+                DCS_LOGGING_STREAM << " " << category_count.first << ": " << category_count.second;
+            }
+            DCS_LOGGING_STREAM << std::endl;
+        }
+
+        if (formation.planned && opts_.verbosity >= low_medium)
+        {
+            DCS_LOGGING_STREAM << "-- STRATEGY PLAN (interval starting at " << coal_form_start_time << "): " << formation.plan << ", actual time: " << formation.elapsed_time << "s (budget: " << planner_.budget() << "s)" << std::endl;
+        }
+
         if (trace_dat_ofs_.is_open())
         {
             trace_dat_ofs_ << cur_timestamp << field_sep_ch << coal_form_start_time << field_sep_ch << coalition_duration;
@@ -2067,6 +4113,14 @@ DCS_DEBUG_TRACE("Service: " << svc << ", Burst #" << b << ", start: " << burst_s
         {
             rep_fp_coal_profit_stats_[fp]->collect(fp_interval_coal_profits[fp]);
             rep_fp_alone_profit_stats_[fp]->collect(fp_interval_alone_profits[fp]);
+
+            rep_fp_coal_profit_quantile_stats_[fp]->collect(fp_interval_coal_profits[fp]);
+            rep_fp_alone_profit_quantile_stats_[fp]->collect(fp_interval_alone_profits[fp]);
+            rep_fp_profit_ratio_quantile_stats_[fp]->collect(relative_increment(fp_interval_coal_profits[fp], fp_interval_alone_profits[fp]));
+            if (!std::isnan(fp_interval_coal_profits[fp]) && !std::isnan(fp_interval_alone_profits[fp]))
+            {
+                fp_coal_below_alone_stats_[fp]->collect(fp_interval_coal_profits[fp] < fp_interval_alone_profits[fp] ? 1 : 0);
+            }
         }
 
         // Outputs some information
@@ -2151,15 +4205,63 @@ private:
     std::vector<std::size_t> fn_categories_; // Map an FN to its category
     std::vector<std::size_t> svc_fps_; // Map a service to the FP that runs it
     std::vector<std::size_t> svc_categories_; // Map a service to its category
+    std::vector<std::vector<std::size_t>> fp_fns_; // Map an FP to its FNs
+    std::vector<std::vector<std::size_t>> fp_svcs_; // Map an FP to its services
+    std::vector<RealT> fp_max_profit_rates_; ///< Upper bound of the profit (per unit of time) an FP contributes to any coalition, by FP
+    vm_allocation_features_t<RealT> vm_alloc_features_; ///< Per-FN and per-service inputs of the VM allocation problem
     std::vector<std::shared_ptr<workload_generator_t<RealT>>> wkl_gens_;
+    std::vector<random_number_engine_t> lp_rngs_; ///< Random number engines, by logical process (empty if services are simulated sequentially)
+    std::vector<std::vector<std::shared_ptr<workload_generator_t<RealT>>>> lp_wkl_gens_; ///< Workload generators, by logical process and service category
+    nash_stable_partition_selector_t<RealT> nash_selector_; ///< Selector of Nash-stable partitions (keeps its preference profile cache across intervals)
     std::vector<std::vector<std::tuple<RealT,RealT,RealT>>> rep_svc_wkl_bursts_; ///< Arrival burst profiles (a sequence of <start-time,stop-time,arrival-rate> triples) in a single replication, by service
     std::vector<std::shared_ptr<mean_estimator_t<RealT>>> rep_fp_coal_profit_stats_; ///< FP coalition profits in a single replication, by FP
     std::vector<std::shared_ptr<mean_estimator_t<RealT>>> rep_fp_alone_profit_stats_; ///< FP alone profits in a single replication, by FP
+    std::vector<std::shared_ptr<quantile_estimator_t<RealT>>> rep_fp_coal_profit_quantile_stats_; ///< FP interval coalition profits in a single replication, by FP
+    std::vector<std::shared_ptr<quantile_estimator_t<RealT>>> rep_fp_alone_profit_quantile_stats_; ///< FP interval alone profits in a single replication, by FP
+    std::vector<std::shared_ptr<quantile_estimator_t<RealT>>> rep_fp_profit_ratio_quantile_stats_; ///< FP interval coalition profits relative to alone profits in a single replication, by FP
     std::vector<bool> rep_fn_power_states_;
+    std::size_t num_formations_; ///< Number of performed coalition formations along all the simulation
+    std::size_t num_skipped_formations_; ///< Number of coalition formations skipped by the demand-change trigger along all the simulation
+    std::size_t rep_num_formations_; ///< Number of performed coalition formations in a single replication
+    std::size_t rep_num_skipped_formations_; ///< Number of coalition formations skipped by the demand-change trigger in a single replication
+    interval_demand_t rep_last_formation_demand_; ///< Workload demand of the last performed coalition formation in a single replication
+    interval_formation_t rep_last_formation_; ///< Outcome of the last performed coalition formation in a single replication
+    RealT rep_last_formation_time_; ///< Time of the last performed coalition formation in a single replication
+    RealT rep_last_formation_duration_; ///< Length of the interval of the last performed coalition formation in a single replication
+    std::vector<pending_formation_t> rep_pending_formations_; ///< Coalition formations to be evaluated at the end of a single replication
+    std::vector<pending_interval_t> rep_pending_intervals_; ///< Coalition formation intervals to be reported at the end of a single replication
+    bool deterministic_; ///< Tells if no stochastic component is configured (i.e., all replications are identical)
+    std::vector<std::vector<std::size_t>> feasible_coal_fps_; ///< The coalitions allowed by the FP topology (if any), sorted by CID
+    std::vector<gtpack::cid_type> fp_adjacency_cids_; ///< The neighbors of each FP in the FP topology (if any)
+    std::vector<std::size_t> num_feasible_coals_by_size_; ///< The number of coalitions allowed by the FP topology (if any), by number of FPs
+    incremental_formation_state_t rep_incremental_state_; ///< Outcome of the last coalition formation in a single replication, from which the next one is incrementally updated
+    strategy_planner_t<RealT> planner_; ///< Chooses the formation and valuation strategies of every coalition formation according to the interval budget
+    std::shared_ptr<vm_allocation_store_t<RealT>> p_vm_alloc_store_; ///< Persistent store of solved VM allocation problems (if any)
+    std::shared_ptr<vm_allocation_frontier_t<RealT>> p_vm_alloc_frontier_; ///< Feasibility frontier of the VM allocation problems of coalitions (if any)
+    std::shared_ptr<game_log_writer_t<RealT>> p_game_log_writer_; ///< Writer of the game log (if any)
+    std::shared_ptr<game_log_reader_t<RealT>> p_game_log_reader_; ///< Reader of the game log to replay (if any)
+    game_log_record_t<RealT> next_replay_record_; ///< The next record of the game log to replay, which is the first of the next replication
+    bool has_replay_record_; ///< Tells if the game log to replay has further records
+    std::deque<game_log_record_t<RealT>> rep_replay_records_; ///< The recorded intervals of the current replication still to replay
+    std::shared_ptr<formation_cache_t> p_formation_cache_; ///< Memoized coalition formation outcomes and precomputed coalition VM allocations (possibly shared with other experiments, see \c setup)
+    std::size_t num_interval_memo_hits_;
+    std::size_t num_interval_memo_misses_;
+    std::atomic<std::size_t> num_value_table_hits_; ///< Number of coalition valuations that used a precomputed VM allocation
+    std::size_t num_reused_coalitions_; ///< Number of coalitions whose previous analysis has been reused by incremental coalition formations
+    std::size_t num_updated_coalitions_; ///< Number of coalitions whose payoffs have been delta-updated by incremental coalition formations
+    std::size_t num_recomputed_coalitions_; ///< Number of coalitions analyzed from scratch by incremental coalition formations
     std::vector<std::shared_ptr<ci_mean_estimator_t<RealT>>> fp_coal_profit_ci_stats_; // FP coalition profits along all the simulation, by FP
     std::vector<std::shared_ptr<ci_mean_estimator_t<RealT>>> fp_alone_profit_ci_stats_; // FP alone profits along all the simulation, by FP
+    std::vector<std::shared_ptr<quantile_estimator_t<RealT>>> fp_coal_profit_quantile_stats_; // FP interval coalition profits along all the simulation, by FP
+    std::vector<std::shared_ptr<quantile_estimator_t<RealT>>> fp_alone_profit_quantile_stats_; // FP interval alone profits along all the simulation, by FP
+    std::vector<std::shared_ptr<quantile_estimator_t<RealT>>> fp_profit_ratio_quantile_stats_; // FP interval coalition profits relative to alone profits along all the simulation, by FP
+    std::vector<std::shared_ptr<mean_estimator_t<RealT>>> fp_coal_below_alone_stats_; // Fraction of intervals where the FP coalition profit is below the alone profit along all the simulation, by FP
+    std::map<coalition_formation_category, std::shared_ptr<mean_estimator_t<RealT>>> stability_num_partitions_stats_; // Number of stable partitions per interval along all the simulation, by stability notion
+    std::map<coalition_formation_category, std::shared_ptr<mean_estimator_t<RealT>>> stability_existence_stats_; // Fraction of intervals with some stable partition along all the simulation, by stability notion
     std::ofstream stats_dat_ofs_;
     std::ofstream trace_dat_ofs_;
+    std::shared_ptr<experiment_metrics_t> p_metrics_; ///< Live metrics of the simulation (if any)
+    std::shared_ptr<metrics_exporter_t> p_metrics_exporter_; ///< Writer of the live metrics file (if any)
 }; // experiment_t
 
 
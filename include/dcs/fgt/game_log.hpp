@@ -0,0 +1,252 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file dcs/fgt/game_log.hpp
+ *
+ * \brief Binary log of the coalitional games played in coalition formation
+ *  intervals.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_FGT_GAME_LOG_HPP
+#define DCS_FGT_GAME_LOG_HPP
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <dcs/assert.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/exception.hpp>
+#include <fstream>
+#include <gtpack/cooperative.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace dcs { namespace fgt {
+
+/// The value of a coalition in a recorded game
+template <typename RealT>
+struct game_log_coalition_t
+{
+    gtpack::cid_type cid = gtpack::empty_cid;
+    RealT value = 0; ///< The coalition profit (meaningless if not solved)
+    bool solved = false; ///< Tells if the VM allocation problem of the coalition is feasible
+}; // game_log_coalition_t
+
+/// The coalitional game played in a coalition formation interval
+template <typename RealT>
+struct game_log_record_t
+{
+    std::size_t replication = 0; ///< The replication the interval belongs to
+    std::time_t timestamp = 0; ///< The wall-clock time the interval has been reported
+    RealT start_time = 0; ///< The simulated time the interval starts
+    RealT stop_time = 0; ///< The simulated time the interval stops
+    std::vector<RealT> svc_arrival_rates; ///< Max arrival rate, by service
+    std::vector<game_log_coalition_t<RealT>> coalitions; ///< The feasible coalitions, sorted by CID
+}; // game_log_record_t
+
+
+namespace detail {
+
+static const char game_log_magic[8] = {'F','G','T','G','L','O','G','1'};
+static const std::uint32_t game_log_version = 1;
+
+} // Namespace detail
+
+
+/**
+ * \brief Writer of game logs
+ *
+ * A game log starts with a header (the magic string, the format version, the
+ * number of FPs and of services), followed by a record for every coalition
+ * formation interval.
+ * Every record stores the interval, the arrival rates of services and, for
+ * every coalition that can form, its CID, its value and whether it is
+ * feasible; numbers are stored in host byte order with fixed widths.
+ * Coalition values do not depend on the value division rule nor on the
+ * stability notion, thus a game log is all is needed to re-analyze a
+ * simulation under other rules (see \c options_t::game_replay_file).
+ */
+template <typename RealT>
+class game_log_writer_t
+{
+public:
+    game_log_writer_t(const std::string& path, std::size_t num_fps, std::size_t num_svcs)
+    : ofs_(path.c_str(), std::ios::binary | std::ios::trunc),
+      num_svcs_(num_svcs)
+    {
+        DCS_ASSERT(ofs_,
+                   DCS_EXCEPTION_THROW(std::runtime_error, "Unable to open game log file '" + path + "'"));
+
+        ofs_.write(detail::game_log_magic, sizeof(detail::game_log_magic));
+        this->put<std::uint32_t>(detail::game_log_version);
+        this->put<std::uint32_t>(num_fps);
+        this->put<std::uint32_t>(num_svcs);
+
+        DCS_ASSERT(ofs_,
+                   DCS_EXCEPTION_THROW(std::runtime_error, "Unable to write the header of game log file '" + path + "'"));
+    }
+
+    void write(const game_log_record_t<RealT>& record)
+    {
+        DCS_ASSERT(record.svc_arrival_rates.size() == num_svcs_,
+                   DCS_EXCEPTION_THROW(std::invalid_argument, "Number of arrival rates does not match"));
+
+        this->put<std::uint64_t>(record.replication);
+        this->put<std::int64_t>(record.timestamp);
+        this->put<double>(record.start_time);
+        this->put<double>(record.stop_time);
+        for (auto const rate : record.svc_arrival_rates)
+        {
+            this->put<double>(rate);
+        }
+        this->put<std::uint32_t>(record.coalitions.size());
+        for (auto const& coal : record.coalitions)
+        {
+            this->put<std::uint64_t>(coal.cid);
+            this->put<double>(coal.value);
+            this->put<std::uint8_t>(coal.solved);
+        }
+
+        DCS_ASSERT(ofs_,
+                   DCS_EXCEPTION_THROW(std::runtime_error, "Unable to write to game log file"));
+    }
+
+    void flush()
+    {
+        ofs_.flush();
+    }
+
+private:
+    template <typename T, typename U>
+    void put(U x)
+    {
+        const T v = static_cast<T>(x);
+
+        ofs_.write(reinterpret_cast<const char*>(&v), sizeof(v));
+    }
+
+
+    std::ofstream ofs_;
+    std::size_t num_svcs_;
+}; // game_log_writer_t
+
+
+/// Reader of game logs written by \c game_log_writer_t
+template <typename RealT>
+class game_log_reader_t
+{
+public:
+    explicit game_log_reader_t(const std::string& path)
+    : ifs_(path.c_str(), std::ios::binary),
+      num_fps_(0),
+      num_svcs_(0)
+    {
+        DCS_ASSERT(ifs_,
+                   DCS_EXCEPTION_THROW(std::runtime_error, "Unable to open game log file '" + path + "'"));
+
+        char magic[sizeof(detail::game_log_magic)];
+        ifs_.read(magic, sizeof(magic));
+        DCS_ASSERT(ifs_ && std::memcmp(magic, detail::game_log_magic, sizeof(magic)) == 0,
+                   DCS_EXCEPTION_THROW(std::runtime_error, "File '" + path + "' is not a game log"));
+
+        DCS_ASSERT(this->get<std::uint32_t>() == detail::game_log_version,
+                   DCS_EXCEPTION_THROW(std::runtime_error, "Unsupported version of game log file '" + path + "'"));
+
+        num_fps_ = this->get<std::uint32_t>();
+        num_svcs_ = this->get<std::uint32_t>();
+
+        DCS_ASSERT(ifs_,
+                   DCS_EXCEPTION_THROW(std::runtime_error, "Truncated header in game log file '" + path + "'"));
+    }
+
+    std::size_t num_fps() const
+    {
+        return num_fps_;
+    }
+
+    std::size_t num_svcs() const
+    {
+        return num_svcs_;
+    }
+
+    /// Reads the next record, returning \c false at the end of the log
+    bool read(game_log_record_t<RealT>& record)
+    {
+        record.replication = this->get<std::uint64_t>();
+        if (ifs_.gcount() == 0 && ifs_.eof())
+        {
+            return false;
+        }
+        DCS_ASSERT(static_cast<std::size_t>(ifs_.gcount()) == sizeof(std::uint64_t),
+                   DCS_EXCEPTION_THROW(std::runtime_error, "Truncated record in game log file"));
+        record.timestamp = static_cast<std::time_t>(this->get<std::int64_t>());
+        record.start_time = this->get<double>();
+        record.stop_time = this->get<double>();
+        record.svc_arrival_rates.resize(num_svcs_);
+        for (std::size_t svc = 0; svc < num_svcs_; ++svc)
+        {
+            record.svc_arrival_rates[svc] = this->get<double>();
+        }
+        const std::uint32_t num_coalitions = this->get<std::uint32_t>();
+        DCS_ASSERT(ifs_,
+                   DCS_EXCEPTION_THROW(std::runtime_error, "Truncated record in game log file"));
+        // There are at most 2^n coalitions of n FPs
+        DCS_ASSERT(num_fps_ >= 32 || num_coalitions <= (std::uint64_t(1) << num_fps_),
+                   DCS_EXCEPTION_THROW(std::runtime_error, "Bad number of coalitions in game log file"));
+        record.coalitions.resize(num_coalitions);
+        for (auto& coal : record.coalitions)
+        {
+            coal.cid = this->get<std::uint64_t>();
+            coal.value = this->get<double>();
+            coal.solved = this->get<std::uint8_t>() != 0;
+        }
+
+        DCS_ASSERT(ifs_,
+                   DCS_EXCEPTION_THROW(std::runtime_error, "Truncated record in game log file"));
+
+        return true;
+    }
+
+private:
+    template <typename T>
+    T get()
+    {
+        T v = 0;
+
+        ifs_.read(reinterpret_cast<char*>(&v), sizeof(v));
+
+        return v;
+    }
+
+
+    std::ifstream ifs_;
+    std::size_t num_fps_;
+    std::size_t num_svcs_;
+}; // game_log_reader_t
+
+}} // Namespace dcs::fgt
+
+
+#endif // DCS_FGT_GAME_LOG_HPP
@@ -0,0 +1,355 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file dcs/fgt/metrics.hpp
+ *
+ * \brief Live metrics of running experiments.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_FGT_METRICS_HPP
+#define DCS_FGT_METRICS_HPP
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <dcs/assert.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/logging.hpp>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace dcs { namespace fgt {
+
+/**
+ * \brief Progress counters of a running experiment
+ *
+ * Counters are updated by the simulation (possibly from the threads
+ * evaluating coalition formations) and read by \c metrics_exporter_t
+ * from its own thread, thus they are all atomic and no lock is needed on
+ * either side.
+ * Cache counters are cumulative totals, as published by their caches.
+ */
+struct experiment_metrics_t
+{
+    explicit experiment_metrics_t(std::size_t num_fps)
+    : max_num_replications(0),
+      max_replication_duration(std::numeric_limits<double>::infinity()),
+      target_relative_precision(0),
+      simulated_time(0),
+      num_replications(0),
+      num_intervals(0),
+      num_solver_calls(0),
+      num_interval_memo_hits(0),
+      num_interval_memo_misses(0),
+      num_preference_cache_hits(0),
+      num_preference_cache_misses(0),
+      num_solution_store_hits(0),
+      num_solution_store_misses(0),
+      fp_coal_profit_relative_precisions(num_fps),
+      fp_alone_profit_relative_precisions(num_fps)
+    {
+        for (std::size_t fp = 0; fp < num_fps; ++fp)
+        {
+            fp_coal_profit_relative_precisions[fp] = std::numeric_limits<double>::infinity();
+            fp_alone_profit_relative_precisions[fp] = std::numeric_limits<double>::infinity();
+        }
+    }
+
+
+    // Settings (written before the exporter starts)
+    std::size_t max_num_replications; ///< Maximum number of replications (0 for no limit)
+    double max_replication_duration; ///< Maximum simulated length of each replication
+    double target_relative_precision; ///< Relative precision the confidence intervals have to reach
+
+    // Progress
+    std::atomic<double> simulated_time; ///< Simulated time in the current replication
+    std::atomic<std::size_t> num_replications; ///< Number of completed replications
+    std::atomic<std::size_t> num_intervals; ///< Number of reported coalition formation intervals
+    std::atomic<std::size_t> num_solver_calls; ///< Number of VM allocation problems passed to the solver
+    std::atomic<std::size_t> num_interval_memo_hits;
+    std::atomic<std::size_t> num_interval_memo_misses;
+    std::atomic<std::size_t> num_preference_cache_hits;
+    std::atomic<std::size_t> num_preference_cache_misses;
+    std::atomic<std::size_t> num_solution_store_hits;
+    std::atomic<std::size_t> num_solution_store_misses;
+    std::vector<std::atomic<double>> fp_coal_profit_relative_precisions; ///< Relative precision of the confidence interval of coalition profits, by FP
+    std::vector<std::atomic<double>> fp_alone_profit_relative_precisions; ///< Relative precision of the confidence interval of alone profits, by FP
+}; // experiment_metrics_t
+
+
+/**
+ * \brief Periodic writer of experiment metrics in the Prometheus text format
+ *
+ * A background thread rewrites the metrics file every \c interval seconds
+ * (and once more when the exporter is stopped), so that long runs can be
+ * followed with tools like \c watch or scraped by the textfile collector of
+ * the Prometheus node exporter.
+ * The file is written to a temporary file first and then renamed, so that
+ * readers never see a partially written file.
+ *
+ * Rates are computed over the last write interval; the estimated time to
+ * completion extrapolates the number of replications still needed from the
+ * current relative precision of the coalition profit confidence intervals
+ * (the half-width of a confidence interval shrinks as the square root of the
+ * number of replications).
+ */
+class metrics_exporter_t
+{
+public:
+    static constexpr double default_interval = 5; ///< Default write interval (in seconds)
+
+
+    metrics_exporter_t(const std::string& path, std::shared_ptr<const experiment_metrics_t> p_metrics, double interval = default_interval)
+    : path_(path),
+      p_metrics_(p_metrics),
+      interval_(interval),
+      stop_(false),
+      last_num_intervals_(0),
+      last_num_solver_calls_(0),
+      interval_rate_(0),
+      solver_call_rate_(0)
+    {
+        DCS_ASSERT(p_metrics_,
+                   DCS_EXCEPTION_THROW(std::invalid_argument, "Metrics are not available"));
+        DCS_ASSERT(interval_ > 0,
+                   DCS_EXCEPTION_THROW(std::invalid_argument, "Metrics write interval must be positive"));
+
+        start_clock_ = last_clock_ = std::chrono::steady_clock::now();
+
+        this->write();
+
+        thread_ = std::thread([this]() { this->run(); });
+    }
+
+    metrics_exporter_t(const metrics_exporter_t&) = delete;
+
+    metrics_exporter_t& operator=(const metrics_exporter_t&) = delete;
+
+    ~metrics_exporter_t()
+    {
+        try
+        {
+            this->stop();
+        }
+        catch (...)
+        {
+            // Destructors must not throw
+        }
+    }
+
+    /// Stops the background thread and writes the final metrics
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (stop_)
+            {
+                return;
+            }
+            stop_ = true;
+        }
+        cv_.notify_one();
+
+        thread_.join();
+
+        this->write();
+    }
+
+private:
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        while (!cv_.wait_for(lock, std::chrono::duration<double>(interval_), [this]() { return stop_; }))
+        {
+            lock.unlock();
+            try
+            {
+                this->write();
+            }
+            catch (const std::exception& e)
+            {
+                // A failed write must not stop the simulation; try again at the next interval
+                dcs::log_warn(DCS_LOGGING_AT, e.what());
+            }
+            lock.lock();
+        }
+    }
+
+    void write()
+    {
+        const experiment_metrics_t& m = *p_metrics_;
+
+        auto const now = std::chrono::steady_clock::now();
+        auto const elapsed = std::chrono::duration<double>(now-start_clock_).count();
+        auto const dt = std::chrono::duration<double>(now-last_clock_).count();
+
+        auto const sim_time = m.simulated_time.load();
+        auto const num_reps = m.num_replications.load();
+        auto const num_intervals = m.num_intervals.load();
+        auto const num_solver_calls = m.num_solver_calls.load();
+
+        // Keep the previous rates when the last write is too recent (e.g.,
+        // for the final write) for them to be meaningful
+        bool const new_rates = dt >= 0.5*interval_;
+        if (new_rates)
+        {
+            interval_rate_ = (num_intervals-last_num_intervals_)/dt;
+            solver_call_rate_ = (num_solver_calls-last_num_solver_calls_)/dt;
+        }
+
+        const std::string tmp_path = path_ + ".tmp";
+        std::ofstream ofs(tmp_path.c_str(), std::ios::trunc);
+
+        DCS_ASSERT(ofs,
+                   DCS_EXCEPTION_THROW(std::runtime_error, "Unable to open metrics file '" + tmp_path + "'"));
+
+        put_metric(ofs, "fgt_elapsed_seconds", "gauge", "Wall-clock time since the start of the simulation", elapsed);
+        put_metric(ofs, "fgt_simulated_time", "gauge", "Simulated time in the current replication", sim_time);
+        put_metric(ofs, "fgt_replications_total", "counter", "Completed replications", num_reps);
+        put_metric(ofs, "fgt_intervals_total", "counter", "Reported coalition formation intervals", num_intervals);
+        put_metric(ofs, "fgt_intervals_per_second", "gauge", "Reported coalition formation intervals per second", interval_rate_);
+        put_metric(ofs, "fgt_solver_calls_total", "counter", "VM allocation problems passed to the solver", num_solver_calls);
+        put_metric(ofs, "fgt_solver_calls_per_second", "gauge", "VM allocation problems passed to the solver per second", solver_call_rate_);
+
+        ofs << "# HELP fgt_cache_hit_ratio Fraction of lookups served by a cache" << std::endl
+            << "# TYPE fgt_cache_hit_ratio gauge" << std::endl;
+        put_sample(ofs, "fgt_cache_hit_ratio{cache=\"interval_memo\"}", hit_ratio(m.num_interval_memo_hits.load(), m.num_interval_memo_misses.load()));
+        put_sample(ofs, "fgt_cache_hit_ratio{cache=\"preference_profile\"}", hit_ratio(m.num_preference_cache_hits.load(), m.num_preference_cache_misses.load()));
+        put_sample(ofs, "fgt_cache_hit_ratio{cache=\"solution_store\"}", hit_ratio(m.num_solution_store_hits.load(), m.num_solution_store_misses.load()));
+
+        ofs << "# HELP fgt_ci_relative_precision Relative precision of the confidence interval of profits" << std::endl
+            << "# TYPE fgt_ci_relative_precision gauge" << std::endl;
+        // Confidence intervals are meaningless before the second replication
+        double needed_reps = num_reps > 1 ? num_reps : std::numeric_limits<double>::quiet_NaN();
+        for (std::size_t fp = 0; fp < m.fp_coal_profit_relative_precisions.size(); ++fp)
+        {
+            auto const coal_rel_prec = m.fp_coal_profit_relative_precisions[fp].load();
+
+            put_sample(ofs, "fgt_ci_relative_precision{fp=\"" + std::to_string(fp) + "\",profit=\"coalition\"}", coal_rel_prec);
+            put_sample(ofs, "fgt_ci_relative_precision{fp=\"" + std::to_string(fp) + "\",profit=\"alone\"}", m.fp_alone_profit_relative_precisions[fp].load());
+
+            // The simulation stops when the coalition profit intervals reach the target precision
+            if (coal_rel_prec > m.target_relative_precision && m.target_relative_precision > 0)
+            {
+                needed_reps = std::max(needed_reps, num_reps*std::pow(coal_rel_prec/m.target_relative_precision, 2));
+            }
+        }
+        if (m.max_num_replications > 0)
+        {
+            needed_reps = std::isnan(needed_reps) ? m.max_num_replications : std::min(needed_reps, static_cast<double>(m.max_num_replications));
+        }
+
+        // Count the fraction of the current replication, if its length is known
+        double done_reps = num_reps;
+        if (std::isfinite(m.max_replication_duration) && m.max_replication_duration > 0)
+        {
+            done_reps += std::min(sim_time/m.max_replication_duration, 1.0);
+        }
+
+        double eta = std::numeric_limits<double>::quiet_NaN();
+        if (std::isfinite(needed_reps) && done_reps > 0)
+        {
+            eta = std::max(needed_reps-done_reps, 0.0)*elapsed/done_reps;
+        }
+        put_metric(ofs, "fgt_estimated_seconds_to_completion", "gauge", "Estimated wall-clock time to the end of the simulation (NaN when unknown)", eta);
+
+        ofs.close();
+
+        DCS_ASSERT(ofs,
+                   DCS_EXCEPTION_THROW(std::runtime_error, "Unable to write metrics file '" + tmp_path + "'"));
+        DCS_ASSERT(std::rename(tmp_path.c_str(), path_.c_str()) == 0,
+                   DCS_EXCEPTION_THROW(std::runtime_error, "Unable to replace metrics file '" + path_ + "'"));
+
+        if (new_rates)
+        {
+            last_clock_ = now;
+            last_num_intervals_ = num_intervals;
+            last_num_solver_calls_ = num_solver_calls;
+        }
+    }
+
+    static double hit_ratio(std::size_t hits, std::size_t misses)
+    {
+        return (hits+misses) > 0 ? static_cast<double>(hits)/(hits+misses) : 0.0;
+    }
+
+    static void put_metric(std::ostream& os, const std::string& name, const std::string& type, const std::string& help, double value)
+    {
+        os  << "# HELP " << name << " " << help << std::endl
+            << "# TYPE " << name << " " << type << std::endl;
+        put_sample(os, name, value);
+    }
+
+    static void put_sample(std::ostream& os, const std::string& name, double value)
+    {
+        os << name << " ";
+        if (std::isnan(value))
+        {
+            os << "NaN";
+        }
+        else if (std::isinf(value))
+        {
+            os << (value > 0 ? "+Inf" : "-Inf");
+        }
+        else
+        {
+            // With the default 6 digits, counters above 1e6 would be rounded
+            auto const precision = os.precision(std::numeric_limits<double>::max_digits10);
+            os << value;
+            os.precision(precision);
+        }
+        os << std::endl;
+    }
+
+
+    std::string path_;
+    std::shared_ptr<const experiment_metrics_t> p_metrics_;
+    double interval_;
+    bool stop_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread thread_;
+    std::chrono::steady_clock::time_point start_clock_;
+    std::chrono::steady_clock::time_point last_clock_;
+    std::size_t last_num_intervals_;
+    std::size_t last_num_solver_calls_;
+    double interval_rate_; ///< Reported intervals per second over the last write interval
+    double solver_call_rate_; ///< Solver calls per second over the last write interval
+}; // metrics_exporter_t
+
+}} // Namespace dcs::fgt
+
+
+#endif // DCS_FGT_METRICS_HPP
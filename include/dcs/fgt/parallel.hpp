@@ -0,0 +1,126 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file dcs/fgt/parallel.hpp
+ *
+ * \brief Utilities for running independent tasks on multiple threads.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_FGT_PARALLEL_HPP
+#define DCS_FGT_PARALLEL_HPP
+
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace dcs { namespace fgt {
+
+/// Returns the number of threads to use when \a num_threads threads are
+/// requested, where 0 stands for the number of hardware threads
+inline std::size_t num_parallel_threads(std::size_t num_threads)
+{
+    if (num_threads == 0)
+    {
+        num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    return num_threads;
+}
+
+/**
+ * Calls \a fn(i) for every \a i in [0, \a n) on (at most) \a num_threads
+ * threads, where 0 stands for the number of hardware threads.
+ *
+ * Tasks are assigned dynamically (each thread takes the next unprocessed
+ * index) so that tasks of unbalanced cost are spread among threads.
+ * The calls for different indices must be independent of each other.
+ * If some call throws, the remaining tasks are not started and the first
+ * exception is re-thrown once all threads have finished.
+ */
+template <typename FuncT>
+void parallel_for(std::size_t n, std::size_t num_threads, FuncT fn)
+{
+    num_threads = std::min(num_parallel_threads(num_threads), n);
+
+    if (num_threads <= 1)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            fn(i);
+        }
+
+        return;
+    }
+
+    std::atomic<std::size_t> next_idx(0);
+    std::atomic<bool> failed(false);
+    std::exception_ptr p_exc;
+    std::mutex exc_mutex;
+
+    auto worker = [&]()
+    {
+        std::size_t i = 0;
+        while (!failed && (i = next_idx++) < n)
+        {
+            try
+            {
+                fn(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(exc_mutex);
+
+                if (!failed)
+                {
+                    p_exc = std::current_exception();
+                    failed = true;
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t t = 1; t < num_threads; ++t)
+    {
+        threads.push_back(std::thread(worker));
+    }
+    worker();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    if (p_exc)
+    {
+        std::rethrow_exception(p_exc);
+    }
+}
+
+}} // Namespace dcs::fgt
+
+
+#endif // DCS_FGT_PARALLEL_HPP
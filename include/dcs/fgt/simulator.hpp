@@ -28,7 +28,10 @@
 #define DCS_FGT_SIMULATOR_HPP
 
 
+#include <algorithm>
 #include <cstddef>
+#include <dcs/fgt/parallel.hpp>
+#include <limits>
 #include <memory>
 #include <queue>
 #include <vector>
@@ -36,6 +39,10 @@
 
 namespace dcs { namespace fgt {
 
+/// The logical process of the events that are not bound to any logical
+/// process (see \c simulator_t::num_logical_processes)
+constexpr std::size_t global_logical_process = std::numeric_limits<std::size_t>::max();
+
 struct event_state_t
 {
 	virtual ~event_state_t() { }
@@ -46,20 +53,23 @@ struct event_t
 {
 	event_t(RealT fire_time, int tag)
 	: fire_time(fire_time),
-	  tag(tag)
+	  tag(tag),
+	  lp(global_logical_process)
 	{
 	}
 
-	event_t(RealT fire_time, int tag, const std::shared_ptr<event_state_t>& p_state)
+	event_t(RealT fire_time, int tag, const std::shared_ptr<event_state_t>& p_state, std::size_t lp = global_logical_process)
 	: fire_time(fire_time),
 	  tag(tag),
-	  p_state(p_state)
+	  p_state(p_state),
+	  lp(lp)
 	{
 	}
 
 	RealT fire_time;
 	int tag;
 	std::shared_ptr<event_state_t> p_state;
+	std::size_t lp; ///< The logical process the event belongs to
 }; // event_t
 
 
@@ -98,7 +108,8 @@ public:
     : max_rep_len_(replication_duration),
       max_num_rep_(std::numeric_limits<std::size_t>::max()),
       sim_time_(0),
-      done_(false)
+      done_(false),
+      num_threads_(1)
     {
     }
 
@@ -120,6 +131,25 @@ public:
         evt_queue_.push(p_event);
     }
 
+    /// Schedules an event of the given logical process.
+    /// While logical processes are advanced in parallel, this must only be
+    /// called by the handlers of the events of the same logical process.
+    void schedule_lp_event(std::size_t lp, RealT time, int tag, const std::shared_ptr<event_state_t>& p_state = nullptr)
+    {
+        auto p_event = std::make_shared<event_t<RealT>>(time, tag, p_state, lp);
+
+        if (lp_evt_queues_.empty())
+        {
+            evt_queue_.push(p_event);
+        }
+        else
+        {
+            DCS_DEBUG_ASSERT( lp < lp_evt_queues_.size() );
+
+            lp_evt_queues_[lp].push(p_event);
+        }
+    }
+
     void run()
     {
         initialize_simulation();
@@ -161,6 +191,45 @@ public:
         return max_num_rep_;
     }
 
+    /**
+     * Sets the number of logical processes (LPs) the events scheduled by
+     * \c schedule_lp_event are partitioned into (0 means that all events are
+     * processed sequentially in a single queue).
+     *
+     * Every LP has its own event queue, and the events of an LP must only
+     * depend on the other events of the same LP; global events (the ones
+     * scheduled by \c schedule_event) act as synchronization points.
+     * Before each global event fires, the LPs are independently advanced (on
+     * \c num_threads threads) to the fire time of that event, and wait for
+     * each other (conservative synchronization).
+     * Hence, the events of LPs fire concurrently with each other (at times
+     * not observable by LP events), and after the global events with the same
+     * fire time.
+     * A replication ends when no global event is pending.
+     */
+    void num_logical_processes(std::size_t value)
+    {
+        lp_evt_queues_.clear();
+        lp_evt_queues_.resize(value);
+    }
+
+    std::size_t num_logical_processes() const
+    {
+        return lp_evt_queues_.size();
+    }
+
+    /// Sets the number of threads used to advance logical processes (0 means
+    /// the number of hardware threads)
+    void num_threads(std::size_t value)
+    {
+        num_threads_ = value;
+    }
+
+    std::size_t num_threads() const
+    {
+        return num_threads_;
+    }
+
     RealT simulated_time() const
     {
         return sim_time_;
@@ -239,6 +308,13 @@ private:
         {
             evt_queue_.pop();
         }
+        for (auto& lp_evt_queue : lp_evt_queues_)
+        {
+            while (!lp_evt_queue.empty())
+            {
+                lp_evt_queue.pop();
+            }
+        }
 
         do_initialize_replication();
     }
@@ -264,6 +340,27 @@ private:
     {
         if (evt_queue_.size() > 0)
         {
+            if (!lp_evt_queues_.empty())
+            {
+                // Advance logical processes up to the next global event
+                const RealT horizon = evt_queue_.top()->fire_time;
+
+                parallel_for(lp_evt_queues_.size(),
+                             num_threads_,
+                             [&](std::size_t lp)
+                             {
+                                auto& lp_evt_queue = lp_evt_queues_[lp];
+
+                                while (!lp_evt_queue.empty() && lp_evt_queue.top()->fire_time < horizon)
+                                {
+                                    auto p_lp_event = lp_evt_queue.top();
+                                    lp_evt_queue.pop();
+
+                                    do_process_event(p_lp_event);
+                                }
+                             });
+            }
+
             auto p_event = evt_queue_.top();
             evt_queue_.pop();
             sim_time_ = p_event->fire_time;
@@ -291,6 +388,8 @@ private:
     RealT sim_time_;
     bool done_;
 	std::priority_queue<std::shared_ptr<event_t<RealT>>, std::vector<std::shared_ptr<event_t<RealT>>>, event_comparator_t> evt_queue_;
+    std::vector<std::priority_queue<std::shared_ptr<event_t<RealT>>, std::vector<std::shared_ptr<event_t<RealT>>>, event_comparator_t>> lp_evt_queues_; ///< The event queues of logical processes
+    std::size_t num_threads_; ///< The number of threads used to advance logical processes
 }; // simulator_t
 
 }} // Namespace dcs::fgt
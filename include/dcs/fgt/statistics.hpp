@@ -33,15 +33,19 @@
 #include <boost/accumulators/statistics/mean.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
 #include <boost/accumulators/statistics/variance.hpp>
+#include <boost/math/constants/constants.hpp>
 #include <boost/math/distributions/normal.hpp>
 #include <boost/math/distributions/students_t.hpp>
 #include <dcs/assert.hpp>
 #include <dcs/debug.hpp>
+#include <dcs/exception.hpp>
 #include <dcs/logging.hpp>
 #include <dcs/macro.hpp>
 #include <dcs/math/function/iszero.hpp>
 #include <dcs/math/function/sqr.hpp>
 #include <dcs/math/traits/float.hpp>
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <limits>
 #include <stdexcept>
@@ -145,7 +149,8 @@ public:
       n_aborted_(false),
       n_first_call_(true),
       unstable_(false),
-      done_(false)
+      done_(false),
+      exact_(false)
     {
         // pre: min sample size >= 2
         DCS_ASSERT(n_min_ >= 2,
@@ -184,6 +189,11 @@ public:
 
     RealT variance() const
     {
+        if (exact_)
+        {
+            return 0;
+        }
+
         //FIXME: Boost.Accumulators variance computes the biased sample variance
         const std::size_t n = this->size();
         return (n/static_cast<RealT>(n-1))*boost::accumulators::variance(stat_);
@@ -198,6 +208,11 @@ public:
     {
         const std::size_t n = this->size();
 
+        if (exact_ && n > 0)
+        {
+            return 0;
+        }
+
         if (n > 1)
         {
             boost::math::students_t_distribution<RealT> t_dist(n-1);
@@ -216,6 +231,11 @@ public:
 
     RealT relative_precision() const
     {
+        if (exact_ && this->size() > 0)
+        {
+            return 0;
+        }
+
         if (!::dcs::math::iszero(this->estimate()) && this->size() > 1)
         {
             return this->half_width() / std::abs(this->estimate());
@@ -244,6 +264,22 @@ public:
         return unstable_;
     }
 
+    /**
+     * Tells that observations come from a deterministic system, so that the
+     * first observation is the exact value of the statistic: the confidence
+     * interval has zero width and the statistic is done as soon as one
+     * observation has been collected.
+     */
+    void exact(bool value)
+    {
+        exact_ = value;
+    }
+
+    bool exact() const
+    {
+        return exact_;
+    }
+
     void collect(RealT obs)
     {
         if (n_aborted_)
@@ -253,6 +289,12 @@ public:
 
         stat_(obs);
 
+        if (exact_)
+        {
+            done_ = true;
+            return;
+        }
+
         //this->check_precision();
         this->check_precision_alt();
 DCS_DEBUG_TRACE("(" << name_ << ") Statistic Info: estimate: " << this->estimate() << ", s.d.: " << this->standard_deviation() << ", size: " << this->size() << ", n_target_: " << n_target_ << ", n_min_: " << n_min_ << ", n_max_: " << n_max_ << ", rel.prec.: " << this->relative_precision() << ", n_detected_: " << std::boolalpha << n_detected_ << ", n_aborted_: " << n_aborted_ << ", unstable: " << unstable_ << ", done: " << done_ << ")");//XXX
@@ -572,8 +614,248 @@ private:
     bool n_first_call_; ///< Tells if this is the first invocation of the sample size detection process
     bool unstable_; ///< Tells if this statistics has shown an unstable behavior
     bool done_; ///< Tells if this statistics has reached the target precision
+    bool exact_; ///< Tells if observations come from a deterministic system
 }; // ci_mean_estimator_t
 
+/**
+ * \brief Streaming estimator of quantiles with bounded memory.
+ *
+ * Observations are summarized by a merging t-digest (T. Dunning and O. Ertl,
+ * "Computing Extremely Accurate Quantiles Using t-Digests", 2019), that is by
+ * a sorted sequence of centroids (i.e., mean-weight pairs) whose weight is
+ * bounded by the \f$k_1(q)=\frac{\delta}{2\pi}\arcsin(2q-1)\f$ scale
+ * function, so that centroids are small near the tails, where quantiles are
+ * thus more accurate.
+ * At most about \f$\delta\f$ centroids (where \f$\delta\f$ is the
+ * compression parameter) are kept, plus a buffer of the last observations
+ * which are merged in when the buffer gets full.
+ * Two estimators are merged by merging their centroids, so observations can
+ * be collected separately (e.g., by replication) and then combined.
+ * NaN observations are ignored.
+ */
+template <typename RealT>
+class quantile_estimator_t
+{
+private:
+    struct centroid_t
+    {
+        RealT mean;
+        RealT weight;
+
+        bool operator<(const centroid_t& other) const
+        {
+            return mean < other.mean;
+        }
+    }; // centroid_t
+
+
+public:
+    static const RealT default_compression;
+
+
+    explicit quantile_estimator_t(RealT compression = default_compression)
+    : compression_(compression),
+      name_("Unnamed"),
+      count_(0),
+      min_(std::numeric_limits<RealT>::infinity()),
+      max_(-std::numeric_limits<RealT>::infinity())
+    {
+        DCS_ASSERT(compression_ >= 1,
+                   DCS_EXCEPTION_THROW(std::invalid_argument,
+                                       "Compression must be >= 1"));
+
+        buffer_.reserve(this->buffer_capacity());
+    }
+
+    void name(std::string const& s)
+    {
+        name_ = s;
+    }
+
+    std::string name() const
+    {
+        return name_;
+    }
+
+    std::size_t size() const
+    {
+        return count_;
+    }
+
+    RealT min() const
+    {
+        return count_ > 0 ? min_ : std::numeric_limits<RealT>::quiet_NaN();
+    }
+
+    RealT max() const
+    {
+        return count_ > 0 ? max_ : std::numeric_limits<RealT>::quiet_NaN();
+    }
+
+    /// Returns the estimated \a q-quantile, with \a q in [0,1]
+    RealT quantile(RealT q) const
+    {
+        DCS_ASSERT(q >= 0 && q <= 1,
+                   DCS_EXCEPTION_THROW(std::invalid_argument,
+                                       "Quantile order must be in [0,1]"));
+
+        if (count_ == 0)
+        {
+            return std::numeric_limits<RealT>::quiet_NaN();
+        }
+
+        this->compress();
+
+        // Centroid i is assumed to be centered at the cumulative weight of
+        // the previous centroids plus half its weight, and quantiles are
+        // interpolated among such points (and the min and max at the ends)
+
+        const RealT target = q*count_;
+        const std::size_t n = centroids_.size();
+
+        RealT prev_pos = 0;
+        RealT prev_mean = min_;
+        RealT cum_weight = 0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const RealT pos = cum_weight + centroids_[i].weight/2;
+
+            if (target <= pos)
+            {
+                if (pos == prev_pos)
+                {
+                    return centroids_[i].mean;
+                }
+                return prev_mean + (centroids_[i].mean-prev_mean)*(target-prev_pos)/(pos-prev_pos);
+            }
+
+            prev_pos = pos;
+            prev_mean = centroids_[i].mean;
+            cum_weight += centroids_[i].weight;
+        }
+
+        if (cum_weight == prev_pos)
+        {
+            return max_;
+        }
+        return prev_mean + (max_-prev_mean)*(target-prev_pos)/(cum_weight-prev_pos);
+    }
+
+    void collect(RealT obs)
+    {
+        if (std::isnan(obs))
+        {
+            return;
+        }
+
+        ++count_;
+        min_ = std::min(min_, obs);
+        max_ = std::max(max_, obs);
+
+        centroid_t c;
+        c.mean = obs;
+        c.weight = 1;
+        buffer_.push_back(c);
+
+        if (buffer_.size() >= this->buffer_capacity())
+        {
+            this->compress();
+        }
+    }
+
+    /// Adds the observations summarized by the given estimator
+    void merge(const quantile_estimator_t& other)
+    {
+        other.compress();
+
+        count_ += other.count_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+
+        buffer_.insert(buffer_.end(), other.centroids_.begin(), other.centroids_.end());
+
+        this->compress();
+    }
+
+    void reset()
+    {
+        count_ = 0;
+        min_ = std::numeric_limits<RealT>::infinity();
+        max_ = -std::numeric_limits<RealT>::infinity();
+        centroids_.clear();
+        buffer_.clear();
+    }
+
+private:
+    std::size_t buffer_capacity() const
+    {
+        return static_cast<std::size_t>(5*compression_);
+    }
+
+    /// The k_1 scale function
+    RealT scale(RealT q) const
+    {
+        return compression_/(2*boost::math::constants::pi<RealT>())*std::asin(2*std::min(std::max(q, RealT(0)), RealT(1))-1);
+    }
+
+    /// Merges the buffered observations into the centroids
+    void compress() const
+    {
+        if (buffer_.empty())
+        {
+            return;
+        }
+
+        buffer_.insert(buffer_.end(), centroids_.begin(), centroids_.end());
+        std::sort(buffer_.begin(), buffer_.end());
+
+        RealT total_weight = 0;
+        for (auto const& c : buffer_)
+        {
+            total_weight += c.weight;
+        }
+
+        centroids_.clear();
+
+        centroid_t cur = buffer_.front();
+        RealT cum_weight = 0; // Weight of the centroids before the current one
+        for (std::size_t i = 1; i < buffer_.size(); ++i)
+        {
+            auto const& next = buffer_[i];
+
+            // Merge the next centroid into the current one as long as the
+            // merged centroid spans at most one unit of the scale function
+            if (this->scale((cum_weight+cur.weight+next.weight)/total_weight) - this->scale(cum_weight/total_weight) <= 1)
+            {
+                cur.weight += next.weight;
+                cur.mean += (next.mean-cur.mean)*next.weight/cur.weight;
+            }
+            else
+            {
+                cum_weight += cur.weight;
+                centroids_.push_back(cur);
+                cur = next;
+            }
+        }
+        centroids_.push_back(cur);
+
+        buffer_.clear();
+    }
+
+
+    RealT compression_; ///< The compression parameter (delta), bounding the number of centroids
+    std::string name_;
+    std::size_t count_; ///< The number of collected observations
+    RealT min_;
+    RealT max_;
+    mutable std::vector<centroid_t> centroids_; ///< The centroids, sorted by mean
+    mutable std::vector<centroid_t> buffer_; ///< The observations (or centroids) not merged yet
+}; // quantile_estimator_t
+
+template <typename RT>
+const RT quantile_estimator_t<RT>::default_compression = 100;
+
+
 template <typename RT>
 const RT ci_mean_estimator_t<RT>::default_ci_level = 0.95;
 
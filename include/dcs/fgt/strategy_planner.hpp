@@ -0,0 +1,531 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file dcs/fgt/strategy_planner.hpp
+ *
+ * \brief Cost-model-driven choice of the coalition formation strategy.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_FGT_STRATEGY_PLANNER_HPP
+#define DCS_FGT_STRATEGY_PLANNER_HPP
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/math/function/bell.hpp>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+
+namespace dcs { namespace fgt {
+
+enum coalition_formation_strategy_category
+{
+    exhaustive_coalition_formation_strategy, ///< Check every partition of the players
+    symmetric_coalition_formation_strategy ///< Check one partition per orbit of interchangeable players
+};
+
+enum coalition_valuation_strategy_category
+{
+    exact_coalition_valuation_strategy, ///< Solve every VM allocation problem with the configured optimizer options
+    time_limited_coalition_valuation_strategy ///< Stop every VM allocation solve at a time limit derived from the interval budget
+};
+
+template <typename CharT, typename CharTraitsT>
+std::basic_ostream<CharT,CharTraitsT>& operator<<(std::basic_ostream<CharT,CharTraitsT>& os, coalition_formation_strategy_category strategy)
+{
+    switch (strategy)
+    {
+        case exhaustive_coalition_formation_strategy:
+            return os << "exhaustive";
+        case symmetric_coalition_formation_strategy:
+            return os << "symmetric";
+    }
+
+    return os;
+}
+
+template <typename CharT, typename CharTraitsT>
+std::basic_ostream<CharT,CharTraitsT>& operator<<(std::basic_ostream<CharT,CharTraitsT>& os, coalition_valuation_strategy_category strategy)
+{
+    switch (strategy)
+    {
+        case exact_coalition_valuation_strategy:
+            return os << "exact";
+        case time_limited_coalition_valuation_strategy:
+            return os << "time-limited";
+    }
+
+    return os;
+}
+
+
+/// The strategy chosen for a coalition formation, with its predicted cost
+template <typename RealT>
+struct strategy_plan_t
+{
+    strategy_plan_t()
+    : formation(exhaustive_coalition_formation_strategy),
+      valuation(exact_coalition_valuation_strategy),
+      time_limit(-1),
+      predicted_formation_time(0),
+      predicted_valuation_time(0),
+      fits_budget(true)
+    {
+    }
+
+    RealT predicted_time() const
+    {
+        return predicted_formation_time+predicted_valuation_time;
+    }
+
+
+    coalition_formation_strategy_category formation;
+    coalition_valuation_strategy_category valuation;
+    RealT time_limit; ///< The time limit (in seconds) of every VM allocation solve, for the time-limited valuation (a negative value means no limit)
+    RealT predicted_formation_time; ///< Predicted time (in seconds) to select the stable partitions
+    RealT predicted_valuation_time; ///< Predicted time (in seconds) to value all the coalitions
+    bool fits_budget; ///< Tells if the predicted time fits the interval budget
+}; // strategy_plan_t
+
+template <typename CharT, typename CharTraitsT, typename RealT>
+std::basic_ostream<CharT,CharTraitsT>& operator<<(std::basic_ostream<CharT,CharTraitsT>& os, const strategy_plan_t<RealT>& plan)
+{
+    os << "formation: " << plan.formation
+       << ", valuation: " << plan.valuation;
+    if (plan.valuation == time_limited_coalition_valuation_strategy)
+    {
+        os << " (" << plan.time_limit << "s per solve)";
+    }
+    os << ", predicted time: " << plan.predicted_time() << "s"
+       << " (formation: " << plan.predicted_formation_time << "s, valuation: " << plan.predicted_valuation_time << "s)";
+    if (!plan.fits_budget)
+    {
+        os << ", over budget";
+    }
+
+    return os;
+}
+
+
+/**
+ * Chooses, at every coalition formation, the strategy to select stable
+ * partitions and to value coalitions that is expected to fit a time budget.
+ *
+ * The cost of valuing coalitions is predicted from the number of coalitions
+ * of each size and from the (exponentially smoothed) time taken so far to
+ * solve the VM allocation problem of a coalition of that size; sizes not
+ * observed yet are extrapolated from the observed ones.
+ * The cost of selecting stable partitions is predicted from the number of
+ * partitions handled by each formation strategy and from the time taken so
+ * far per partition.
+ * The exhaustive strategy checks Bell(n) partitions; the symmetric one checks
+ * one partition per orbit (i.e., per partition of the multiset of classes of
+ * interchangeable players) and then expands the orbits of the stable ones
+ * into all their partitions, whose number is predicted by the (smoothed)
+ * number of stable partitions found so far.
+ *
+ * Among the strategies that value coalitions exactly, the fastest one that
+ * fits the budget is chosen.
+ * If none fits, the VM allocation solves are stopped at a time limit such
+ * that the predicted time fits the budget (which trades the optimality of
+ * coalition values, and possibly the feasibility of the allocations found,
+ * for time).
+ *
+ * The planner is thread-safe.
+ */
+template <typename RealT>
+class strategy_planner_t
+{
+public:
+    explicit strategy_planner_t(RealT budget = 0, RealT smoothing = 0.2)
+    : budget_(budget),
+      smoothing_(smoothing),
+      num_plans_(0),
+      num_overruns_(0),
+      sum_abs_errors_(0)
+    {
+        DCS_ASSERT(smoothing_ > 0 && smoothing_ <= 1,
+                   DCS_EXCEPTION_THROW(std::invalid_argument, "Smoothing factor must be in (0,1]"));
+    }
+
+    /// Sets the time budget (in seconds) of every coalition formation, and
+    /// forgets all the timings observed so far
+    void reset(RealT budget)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        budget_ = budget;
+        solve_times_.clear();
+        partition_times_.clear();
+        stable_partition_counts_.clear();
+        num_plans_ = num_overruns_ = 0;
+        sum_abs_errors_ = 0;
+    }
+
+    RealT budget() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        return budget_;
+    }
+
+    /// Records the time (in seconds) taken to solve the VM allocation
+    /// problem of a coalition with the given number of players
+    void observe_solve(std::size_t coalition_size, RealT seconds)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        smooth(solve_times_, coalition_size, seconds);
+    }
+
+    /// Records the time (in seconds) taken by the given formation strategy
+    /// to select the given number of stable partitions of a game with the
+    /// given number of players and classes of interchangeable players
+    void observe_formation(coalition_formation_strategy_category strategy, std::size_t num_players, const std::vector<std::size_t>& class_sizes, std::size_t num_stable_partitions, RealT seconds)
+    {
+        auto const num_partitions = count_partitions(strategy, num_players, class_sizes, num_stable_partitions);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        smooth(partition_times_, strategy, seconds/num_partitions);
+        smooth(stable_partition_counts_, num_players, static_cast<RealT>(num_stable_partitions));
+    }
+
+    /// Records the time (in seconds) actually taken by a coalition formation
+    /// performed according to the given plan
+    void observe_plan(const strategy_plan_t<RealT>& plan, RealT seconds)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        ++num_plans_;
+        if (seconds > budget_)
+        {
+            ++num_overruns_;
+        }
+        sum_abs_errors_ += std::abs(seconds-plan.predicted_time());
+    }
+
+    /**
+     * Chooses the strategy for a coalition formation.
+     *
+     * \param num_coalitions_by_size The number of coalitions to value, by
+     *  number of players (i.e., element k is the number of coalitions of k
+     *  players).
+     * \param num_players The number of players.
+     * \param class_sizes The size of each class of interchangeable players,
+     *  or an empty vector if the symmetric formation strategy is not
+     *  applicable.
+     * \param max_time_limit The time limit (in seconds) already set for every
+     *  VM allocation solve (a negative value means no limit).
+     */
+    strategy_plan_t<RealT> plan(const std::vector<std::size_t>& num_coalitions_by_size, std::size_t num_players, const std::vector<std::size_t>& class_sizes, RealT max_time_limit) const
+    {
+        std::vector<coalition_formation_strategy_category> formations;
+        if (!class_sizes.empty())
+        {
+            formations.push_back(symmetric_coalition_formation_strategy);
+        }
+        formations.push_back(exhaustive_coalition_formation_strategy);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        std::vector<RealT> size_solve_times(num_coalitions_by_size.size(), 0);
+        std::size_t num_coalitions = 0;
+        RealT exact_valuation_time = 0;
+        for (std::size_t k = 0; k < num_coalitions_by_size.size(); ++k)
+        {
+            size_solve_times[k] = this->predict_solve_time(k);
+            exact_valuation_time += num_coalitions_by_size[k]*size_solve_times[k];
+            num_coalitions += num_coalitions_by_size[k];
+        }
+
+        // Exact valuation: the fastest formation strategy that fits the budget
+        strategy_plan_t<RealT> best_plan;
+        bool found = false;
+        for (auto const formation : formations)
+        {
+            strategy_plan_t<RealT> plan;
+            plan.formation = formation;
+            plan.valuation = exact_coalition_valuation_strategy;
+            plan.time_limit = max_time_limit;
+            plan.predicted_formation_time = this->predict_formation_time(formation, num_players, class_sizes);
+            plan.predicted_valuation_time = exact_valuation_time;
+            plan.fits_budget = plan.predicted_time() <= budget_;
+
+            if (plan.fits_budget && (!found || plan.predicted_time() < best_plan.predicted_time()))
+            {
+                best_plan = plan;
+                found = true;
+            }
+        }
+        if (found || num_coalitions == 0)
+        {
+            return best_plan;
+        }
+
+        // Time-limited valuation: share among coalitions the budget left by
+        // the formation strategy (or the whole budget, if nothing is left)
+        for (auto const formation : formations)
+        {
+            strategy_plan_t<RealT> plan;
+            plan.formation = formation;
+            plan.valuation = time_limited_coalition_valuation_strategy;
+            plan.predicted_formation_time = this->predict_formation_time(formation, num_players, class_sizes);
+
+            auto const available_time = (budget_ > plan.predicted_formation_time) ? (budget_-plan.predicted_formation_time) : budget_;
+            plan.time_limit = available_time/num_coalitions;
+            if (max_time_limit >= 0)
+            {
+                plan.time_limit = std::min(plan.time_limit, max_time_limit);
+            }
+
+            plan.predicted_valuation_time = 0;
+            for (std::size_t k = 0; k < num_coalitions_by_size.size(); ++k)
+            {
+                plan.predicted_valuation_time += num_coalitions_by_size[k]*std::min(size_solve_times[k], plan.time_limit);
+            }
+            plan.fits_budget = plan.predicted_time() <= budget_;
+
+            if (!found || plan.predicted_time() < best_plan.predicted_time())
+            {
+                best_plan = plan;
+                found = true;
+            }
+        }
+
+        return best_plan;
+    }
+
+    /// Returns the number of coalition formations performed according to a plan
+    std::size_t num_plans() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        return num_plans_;
+    }
+
+    /// Returns the number of coalition formations that exceeded the budget
+    std::size_t num_overruns() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        return num_overruns_;
+    }
+
+    /// Returns the mean absolute difference between the predicted and the
+    /// actual time of coalition formations
+    RealT mean_absolute_error() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        return num_plans_ > 0 ? sum_abs_errors_/num_plans_ : 0;
+    }
+
+    /// Returns the number of partitions handled by the given formation
+    /// strategy when the given number of them are stable: the partitions
+    /// checked by the exhaustive strategy, or the orbits checked plus the
+    /// stable partitions expanded by the symmetric strategy
+    static RealT count_partitions(coalition_formation_strategy_category strategy, std::size_t num_players, const std::vector<std::size_t>& class_sizes, RealT num_stable_partitions)
+    {
+        RealT count = dcs::math::bell<RealT>(num_players);
+
+        if (strategy == symmetric_coalition_formation_strategy)
+        {
+            count = std::min(count_orbits(num_players, class_sizes)+num_stable_partitions, count);
+        }
+
+        return std::max(count, static_cast<RealT>(1));
+    }
+
+    /**
+     * Returns the number of orbits of the partitions of players with the
+     * given sizes of the classes of interchangeable players, that is the
+     * number of partitions of the multiset of classes.
+     *
+     * The partitions of a multiset with multiplicities \f$m\f$ are counted by
+     * the coefficient of \f$x^m\f$ in \f$\prod_{v \ne 0} 1/(1-x^v)\f$, over
+     * the nonzero vectors \f$v \le m\f$, which is expanded one factor at a
+     * time on the grid of vectors \f$w \le m\f$.
+     * If that takes more than \a max_steps steps (i.e., with many small
+     * classes), Bell(n) is returned as an upper bound.
+     */
+    static RealT count_orbits(std::size_t num_players, const std::vector<std::size_t>& class_sizes, RealT max_steps = 1e7)
+    {
+        std::size_t grid_size = 1;
+        RealT num_steps = 1;
+        for (auto const size : class_sizes)
+        {
+            grid_size *= size+1;
+            num_steps *= static_cast<RealT>((size+1)*(size+2)/2);
+        }
+        if (num_steps > max_steps)
+        {
+            return dcs::math::bell<RealT>(num_players);
+        }
+
+        auto const nc = class_sizes.size();
+
+        // Coordinates of grid points, in mixed radix with the first class as
+        // the least significant digit
+        std::vector<std::vector<std::size_t>> points(grid_size, std::vector<std::size_t>(nc, 0));
+        for (std::size_t w = 1; w < grid_size; ++w)
+        {
+            points[w] = points[w-1];
+            for (std::size_t c = 0; c < nc; ++c)
+            {
+                if (++points[w][c] <= class_sizes[c])
+                {
+                    break;
+                }
+                points[w][c] = 0;
+            }
+        }
+
+        std::vector<RealT> counts(grid_size, 0);
+        counts[0] = 1;
+        for (std::size_t v = 1; v < grid_size; ++v)
+        {
+            // Points w >= v have larger indices than w-v, so every part v can
+            // be used any number of times
+            for (std::size_t w = v; w < grid_size; ++w)
+            {
+                bool dominates = true;
+                for (std::size_t c = 0; c < nc && dominates; ++c)
+                {
+                    dominates = points[w][c] >= points[v][c];
+                }
+                if (dominates)
+                {
+                    counts[w] += counts[w-v];
+                }
+            }
+        }
+
+        return counts[grid_size-1];
+    }
+
+private:
+    template <typename KeyT>
+    void smooth(std::map<KeyT,RealT>& times, KeyT key, RealT seconds)
+    {
+        auto it = times.find(key);
+        if (it == times.end())
+        {
+            times[key] = seconds;
+        }
+        else
+        {
+            it->second += smoothing_*(seconds-it->second);
+        }
+    }
+
+    /// Predicts the time to solve the VM allocation problem of a coalition
+    /// of the given size, by assuming an exponential growth in the number of
+    /// players between (or beyond) the observed sizes
+    RealT predict_solve_time(std::size_t size) const
+    {
+        if (solve_times_.empty())
+        {
+            return 0;
+        }
+
+        auto const it = solve_times_.lower_bound(size);
+        if (it != solve_times_.end() && it->first == size)
+        {
+            return it->second;
+        }
+        if (it == solve_times_.begin())
+        {
+            // Only larger sizes observed
+            return it->second;
+        }
+
+        auto lo_it = it;
+        --lo_it;
+
+        RealT growth = 2; // Growth factor per additional player
+        if (it != solve_times_.end())
+        {
+            if (lo_it->second > 0)
+            {
+                growth = std::pow(it->second/lo_it->second, static_cast<RealT>(1)/(it->first-lo_it->first));
+            }
+        }
+        else if (lo_it != solve_times_.begin())
+        {
+            auto lo2_it = lo_it;
+            --lo2_it;
+
+            if (lo2_it->second > 0)
+            {
+                growth = std::max(std::pow(lo_it->second/lo2_it->second, static_cast<RealT>(1)/(lo_it->first-lo2_it->first)), static_cast<RealT>(1));
+            }
+        }
+
+        return lo_it->second*std::pow(growth, static_cast<RealT>(size-lo_it->first));
+    }
+
+    RealT predict_formation_time(coalition_formation_strategy_category strategy, std::size_t num_players, const std::vector<std::size_t>& class_sizes) const
+    {
+        // Unobserved strategies are assumed to take the same time per
+        // partition of the observed ones
+        auto it = partition_times_.find(strategy);
+        if (it == partition_times_.end())
+        {
+            it = partition_times_.begin();
+        }
+        if (it == partition_times_.end())
+        {
+            return 0;
+        }
+
+        // Before any observation, every partition is assumed to be stable
+        auto const count_it = stable_partition_counts_.find(num_players);
+        auto const num_stable_partitions = (count_it != stable_partition_counts_.end())
+                                           ? count_it->second
+                                           : dcs::math::bell<RealT>(num_players);
+
+        return it->second*count_partitions(strategy, num_players, class_sizes, num_stable_partitions);
+    }
+
+
+    RealT budget_; ///< The time budget (in seconds) of every coalition formation
+    RealT smoothing_; ///< The weight of new observations in the smoothed timings
+    std::map<std::size_t, RealT> solve_times_; ///< Smoothed VM allocation solve time, by coalition size
+    std::map<coalition_formation_strategy_category, RealT> partition_times_; ///< Smoothed time per handled partition, by formation strategy
+    std::map<std::size_t, RealT> stable_partition_counts_; ///< Smoothed number of stable partitions, by number of players
+    std::size_t num_plans_;
+    std::size_t num_overruns_;
+    RealT sum_abs_errors_;
+    mutable std::mutex mutex_;
+}; // strategy_planner_t
+
+}} // Namespace dcs::fgt
+
+
+#endif // DCS_FGT_STRATEGY_PLANNER_HPP
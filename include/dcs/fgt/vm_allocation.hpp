@@ -3,7 +3,7 @@
 /**
  * \file dcs/fgt/vm_allocation.hpp
  *
- * \brief Solution to the VMs allocation problem.
+ * \brief Inputs and solution of the VMs allocation problem.
  *
  * \author Marco Guazzone (marco.guazzone@gmail.com)
  *
@@ -28,6 +28,7 @@
 #define DCS_FGT_VM_ALLOCATION_HPP
 
 
+#include <cstddef>
 #include <limits>
 #include <vector>
 
@@ -40,18 +41,262 @@ struct vm_allocation_t
 	vm_allocation_t()
 	: solved(false),
 	  optimal(false),
-	  objective_value(std::numeric_limits<RealT>::quiet_NaN())
+	  infeasible(false),
+	  objective_value(std::numeric_limits<RealT>::quiet_NaN()),
+	  objective_bound(std::numeric_limits<RealT>::quiet_NaN())
 	{
 	}
 
 
 	bool solved;
 	bool optimal;
+	bool infeasible; ///< Tells if the problem has been proven infeasible
 	RealT objective_value;
+	RealT objective_bound; ///< Lower bound of the optimal objective value proven by the solver (if any)
 	std::vector<std::vector<bool>> fn_vm_allocations;
 	std::vector<bool> fn_power_states;
 }; // vm_allocation_t
 
+
+/**
+ * \brief Per-FN and per-service attributes of the VM allocation problem.
+ *
+ * The scenario describes FNs and services by category and by FP (e.g., the
+ * min power of an FN is \c fn_cat_min_powers[fn_categories[fn]], and the
+ * cost to power it on is \c fp_fn_cat_awake_costs[fn_to_fps[fn]][fn_categories[fn]]).
+ * These tables resolve such chains once, so that every attribute of an FN or
+ * of a service is a single lookup in a contiguous array.
+ * The CPU and RAM requirements are stored in row-major order by VM category
+ * and FN category.
+ */
+template <typename RealT>
+struct vm_allocation_features_t
+{
+	vm_allocation_features_t()
+	: num_fn_categories(0)
+	{
+	}
+
+	RealT vm_cpu_requirement(std::size_t svc, std::size_t fn) const
+	{
+		return vm_fn_cat_cpu_requirements[svc_vm_categories[svc]*num_fn_categories+fn_categories[fn]];
+	}
+
+	RealT vm_ram_requirement(std::size_t svc, std::size_t fn) const
+	{
+		return vm_fn_cat_ram_requirements[svc_vm_categories[svc]*num_fn_categories+fn_categories[fn]];
+	}
+
+
+	std::size_t num_fn_categories;
+	// By FN
+	std::vector<std::size_t> fn_fps; ///< The FP owning the FN
+	std::vector<std::size_t> fn_categories; ///< The FN category
+	std::vector<RealT> fn_min_powers; ///< The power consumption (in W) when idle
+	std::vector<RealT> fn_max_powers; ///< The power consumption (in W) when fully utilized
+	std::vector<RealT> fn_electricity_costs; ///< The electricity cost (in $/Wh) of the FP owning the FN
+	std::vector<RealT> fn_asleep_costs; ///< The cost to power off the FN
+	std::vector<RealT> fn_awake_costs; ///< The cost to power on the FN
+	// By service
+	std::vector<std::size_t> svc_fps; ///< The FP owning the service
+	std::vector<std::size_t> svc_categories; ///< The service category
+	std::vector<std::size_t> svc_vm_categories; ///< The category of the VMs running the service
+	std::vector<RealT> svc_max_delays; ///< The max tolerated delay
+	std::vector<RealT> svc_penalties; ///< The penalty paid by the owning FP for violating the max delay
+	// By VM category and FN category
+	std::vector<RealT> vm_fn_cat_cpu_requirements; ///< The fraction of FN CPU needed by a VM
+	std::vector<RealT> vm_fn_cat_ram_requirements; ///< The fraction of FN RAM needed by a VM
+}; // vm_allocation_features_t
+
+
+/// Builds the per-FN and per-service attributes of the VM allocation problem
+/// from the category- and FP-based scenario tables.
+template <typename RealT>
+vm_allocation_features_t<RealT> make_vm_allocation_features(const std::vector<std::size_t>& fn_to_fps,
+															const std::vector<std::size_t>& fn_categories,
+															const std::vector<RealT>& fn_cat_min_powers,
+															const std::vector<RealT>& fn_cat_max_powers,
+															const std::vector<std::size_t>& svc_cat_vm_categories,
+															const std::vector<std::vector<RealT>>& vm_cpu_specs,
+															const std::vector<std::vector<RealT>>& vm_ram_specs,
+															const std::vector<std::size_t>& svc_to_fps,
+															const std::vector<std::size_t>& svc_categories,
+															const std::vector<RealT>& svc_cat_max_delays,
+															const std::vector<std::vector<RealT>>& fp_svc_cat_penalties,
+															const std::vector<RealT>& fp_electricity_costs,
+															const std::vector<std::vector<RealT>>& fp_fn_cat_asleep_costs,
+															const std::vector<std::vector<RealT>>& fp_fn_cat_awake_costs)
+{
+	vm_allocation_features_t<RealT> features;
+
+	const std::size_t nfns = fn_to_fps.size();
+	features.fn_fps = fn_to_fps;
+	features.fn_categories = fn_categories;
+	features.fn_min_powers.resize(nfns);
+	features.fn_max_powers.resize(nfns);
+	features.fn_electricity_costs.resize(nfns);
+	features.fn_asleep_costs.resize(nfns);
+	features.fn_awake_costs.resize(nfns);
+	for (std::size_t fn = 0; fn < nfns; ++fn)
+	{
+		const std::size_t fp = fn_to_fps[fn];
+		const std::size_t fn_cat = fn_categories[fn];
+
+		features.fn_min_powers[fn] = fn_cat_min_powers[fn_cat];
+		features.fn_max_powers[fn] = fn_cat_max_powers[fn_cat];
+		features.fn_electricity_costs[fn] = fp_electricity_costs[fp];
+		features.fn_asleep_costs[fn] = fp_fn_cat_asleep_costs[fp][fn_cat];
+		features.fn_awake_costs[fn] = fp_fn_cat_awake_costs[fp][fn_cat];
+	}
+
+	const std::size_t nsvcs = svc_to_fps.size();
+	features.svc_fps = svc_to_fps;
+	features.svc_categories = svc_categories;
+	features.svc_vm_categories.resize(nsvcs);
+	features.svc_max_delays.resize(nsvcs);
+	features.svc_penalties.resize(nsvcs);
+	for (std::size_t svc = 0; svc < nsvcs; ++svc)
+	{
+		const std::size_t fp = svc_to_fps[svc];
+		const std::size_t svc_cat = svc_categories[svc];
+
+		features.svc_vm_categories[svc] = svc_cat_vm_categories[svc_cat];
+		features.svc_max_delays[svc] = svc_cat_max_delays[svc_cat];
+		features.svc_penalties[svc] = fp_svc_cat_penalties[fp][svc_cat];
+	}
+
+	const std::size_t nvmcats = vm_cpu_specs.size();
+	features.num_fn_categories = nvmcats > 0 ? vm_cpu_specs[0].size() : 0;
+	features.vm_fn_cat_cpu_requirements.reserve(nvmcats*features.num_fn_categories);
+	features.vm_fn_cat_ram_requirements.reserve(nvmcats*features.num_fn_categories);
+	for (std::size_t vm_cat = 0; vm_cat < nvmcats; ++vm_cat)
+	{
+		features.vm_fn_cat_cpu_requirements.insert(features.vm_fn_cat_cpu_requirements.end(), vm_cpu_specs[vm_cat].begin(), vm_cpu_specs[vm_cat].end());
+		features.vm_fn_cat_ram_requirements.insert(features.vm_fn_cat_ram_requirements.end(), vm_ram_specs[vm_cat].begin(), vm_ram_specs[vm_cat].end());
+	}
+
+	return features;
+}
+
+
+/**
+ * \brief An instance of the VM allocation problem.
+ *
+ * A lightweight view made of the FNs and VMs involved in the problem, and of
+ * references to the inputs shared by all the instances of the same interval
+ * (the scenario features, the VM-to-service mapping, the current FN power
+ * states, and the predicted service delays by number of VMs).
+ */
+template <typename RealT>
+struct vm_allocation_problem_t
+{
+	vm_allocation_problem_t(const vm_allocation_features_t<RealT>& features_,
+							const std::vector<std::size_t>& fns_,
+							const std::vector<std::size_t>& vms_,
+							const std::vector<std::size_t>& vm_svcs_,
+							const std::vector<bool>& fn_power_states_,
+							const std::vector<std::vector<RealT>>& svc_predicted_delays_)
+	: features(features_),
+	  fns(fns_),
+	  vms(vms_),
+	  vm_svcs(vm_svcs_),
+	  fn_power_states(fn_power_states_),
+	  svc_predicted_delays(svc_predicted_delays_)
+	{
+	}
+
+
+	const vm_allocation_features_t<RealT>& features;
+	const std::vector<std::size_t>& fns; ///< The FNs in the problem (i.e., fns[i]=k -> FN k \in FN')
+	const std::vector<std::size_t>& vms; ///< The VMs in the problem (i.e., vms[j]=k -> VM k \in VM')
+	const std::vector<std::size_t>& vm_svcs; ///< Maps every VM to its service
+	const std::vector<bool>& fn_power_states; ///< The power status of each FN
+	const std::vector<std::vector<RealT>>& svc_predicted_delays; ///< Achieved delay by service and number of VMs
+}; // vm_allocation_problem_t
+
+
+/**
+ * \brief A class of interchangeable FNs of a VM allocation problem.
+ *
+ * FNs owned by the same FP, of the same category and in the same power state
+ * have the same attributes and thus can be exchanged in any allocation.
+ */
+struct vm_allocation_fn_class_t
+{
+	std::size_t fn; ///< A representative FN, whose attributes are those of every FN of the class
+	std::size_t size; ///< The number of FNs of the class
+	bool power_state; ///< The power status of the FNs of the class
+}; // vm_allocation_fn_class_t
+
+
+/// Groups the given FNs into classes of interchangeable FNs, in order of
+/// first appearance of their FP, category and power state.
+template <typename RealT>
+std::vector<vm_allocation_fn_class_t> make_vm_allocation_fn_classes(const vm_allocation_features_t<RealT>& features,
+																	const std::vector<std::size_t>& fns,
+																	const std::vector<bool>& fn_power_states)
+{
+	std::vector<vm_allocation_fn_class_t> fn_classes;
+
+	for (auto const fn : fns)
+	{
+		std::size_t c = 0;
+		while (c < fn_classes.size()
+			   && (features.fn_fps[fn_classes[c].fn] != features.fn_fps[fn]
+				   || features.fn_categories[fn_classes[c].fn] != features.fn_categories[fn]
+				   || fn_classes[c].power_state != fn_power_states[fn]))
+		{
+			++c;
+		}
+		if (c == fn_classes.size())
+		{
+			vm_allocation_fn_class_t fn_class;
+			fn_class.fn = fn;
+			fn_class.size = 0;
+			fn_class.power_state = fn_power_states[fn];
+			fn_classes.push_back(fn_class);
+		}
+
+		++fn_classes[c].size;
+	}
+
+	return fn_classes;
+}
+
+
+/**
+ * \brief An instance of the VM allocation problem in aggregated form.
+ *
+ * FNs are given by class of interchangeable FNs (see
+ * \c vm_allocation_fn_class_t) and VMs by number per service, so that the
+ * size of the instance does not depend on the number of FNs and VMs.
+ * The solution of an instance in this form refers to the FNs of the classes,
+ * class by class, and to the VMs of the services, service by service.
+ */
+template <typename RealT>
+struct vm_allocation_class_problem_t
+{
+	vm_allocation_class_problem_t(const vm_allocation_features_t<RealT>& features_,
+								  const std::vector<vm_allocation_fn_class_t>& fn_classes_,
+								  const std::vector<std::size_t>& svcs_,
+								  const std::vector<std::size_t>& svc_num_vms_,
+								  const std::vector<std::vector<RealT>>& svc_predicted_delays_)
+	: features(features_),
+	  fn_classes(fn_classes_),
+	  svcs(svcs_),
+	  svc_num_vms(svc_num_vms_),
+	  svc_predicted_delays(svc_predicted_delays_)
+	{
+	}
+
+
+	const vm_allocation_features_t<RealT>& features;
+	const std::vector<vm_allocation_fn_class_t>& fn_classes; ///< The classes of the FNs in the problem
+	const std::vector<std::size_t>& svcs; ///< The services in the problem
+	const std::vector<std::size_t>& svc_num_vms; ///< The number of VMs, by service
+	const std::vector<std::vector<RealT>>& svc_predicted_delays; ///< Achieved delay by service and number of VMs
+}; // vm_allocation_class_problem_t
+
 }} // Namespace dcs::fgt
 
 
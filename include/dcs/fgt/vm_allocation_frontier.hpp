@@ -0,0 +1,275 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file dcs/fgt/vm_allocation_frontier.hpp
+ *
+ * \brief Monotone feasibility frontier of the VM allocation problems of
+ *  coalitions.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_FGT_VM_ALLOCATION_FRONTIER_HPP
+#define DCS_FGT_VM_ALLOCATION_FRONTIER_HPP
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <deque>
+#include <dcs/assert.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/fgt/vm_allocation.hpp>
+#include <gtpack/cooperative.hpp>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+
+namespace dcs { namespace fgt {
+
+/**
+ * \brief Frontier of the demands for which the VM allocation problem of every
+ *  coalition has been solved or proven infeasible.
+ *
+ * For a given coalition and given FN power states, the demand of the
+ * coalition is the vector of the arrival rates of its services.
+ * Since a higher arrival rate never lowers the number of VMs a service needs
+ * nor its predicted delays, a higher demand (componentwise) never turns an
+ * infeasible problem into a feasible one, and never lowers the minimum cost.
+ * Thus, for every coalition, the frontier keeps the minimal demands proven
+ * infeasible (an antichain), and a bounded number of solved demands with the
+ * proven lower bound and the achieved value of their cost.
+ * A demand is then infeasible if it dominates an infeasible demand, and its
+ * minimum cost is bounded below by the lower bounds of the solved demands it
+ * dominates, and above by the costs of the solved demands dominating it.
+ *
+ * The frontier is only valid for the FN power states it is bound to, and is
+ * cleared when bound to different ones.
+ * It can be shared by concurrent callers.
+ */
+template <typename RealT>
+class vm_allocation_frontier_t
+{
+private:
+    /// A solved demand
+    struct solved_demand_t
+    {
+        std::vector<RealT> demand;
+        RealT lower_bound; ///< Proven lower bound of the minimum cost
+        RealT upper_bound; ///< Cost of a feasible allocation
+    };
+
+    /// The frontier of a coalition
+    struct coalition_frontier_t
+    {
+        std::vector<std::vector<RealT>> infeasible_demands; ///< Minimal infeasible demands
+        std::deque<solved_demand_t> solved_demands; ///< Solved demands, from the oldest to the newest
+    };
+
+
+public:
+    static const std::size_t default_max_solved_demands = 64;
+
+
+    /// Keeps at most \a max_solved_demands solved demands per coalition (the
+    /// oldest ones are evicted first)
+    explicit vm_allocation_frontier_t(std::size_t max_solved_demands = default_max_solved_demands)
+    : max_solved_demands_(max_solved_demands),
+      num_infeasible_hits_(0),
+      num_bounded_solves_(0)
+    {
+        DCS_ASSERT(max_solved_demands_ > 0,
+                   DCS_EXCEPTION_THROW(std::invalid_argument, "The max number of solved demands must be positive"));
+    }
+
+    /// Binds the frontier to the given FN power states, clearing it if they
+    /// differ from the current ones
+    void bind(const std::vector<bool>& fn_power_states)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (fn_power_states != fn_power_states_)
+        {
+            fn_power_states_ = fn_power_states;
+            frontiers_.clear();
+        }
+    }
+
+    /// Tells if the given demand of the given coalition dominates a demand
+    /// proven infeasible
+    bool infeasible(gtpack::cid_type cid, const std::vector<RealT>& demand)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto const it = frontiers_.find(cid);
+        if (it == frontiers_.end())
+        {
+            return false;
+        }
+
+        for (auto const& infeasible_demand : it->second.infeasible_demands)
+        {
+            if (dominates(demand, infeasible_demand))
+            {
+                ++num_infeasible_hits_;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /// Finds the bounds of the minimum cost of the given demand of the given
+    /// coalition (which are infinite, if unknown), and returns \c true if
+    /// some of them is finite
+    bool objective_bounds(gtpack::cid_type cid, const std::vector<RealT>& demand, RealT& lower_bound, RealT& upper_bound)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        lower_bound = -std::numeric_limits<RealT>::infinity();
+        upper_bound = std::numeric_limits<RealT>::infinity();
+
+        auto const it = frontiers_.find(cid);
+        if (it == frontiers_.end())
+        {
+            return false;
+        }
+
+        for (auto const& solved : it->second.solved_demands)
+        {
+            if (dominates(demand, solved.demand))
+            {
+                lower_bound = std::max(lower_bound, solved.lower_bound);
+            }
+            if (dominates(solved.demand, demand))
+            {
+                upper_bound = std::min(upper_bound, solved.upper_bound);
+            }
+        }
+
+        bool const bounded = !std::isinf(lower_bound) || !std::isinf(upper_bound);
+        if (bounded)
+        {
+            ++num_bounded_solves_;
+        }
+
+        return bounded;
+    }
+
+    /// Records the outcome of the VM allocation problem of the given
+    /// coalition for the given demand (solutions neither found nor proven
+    /// infeasible are ignored)
+    void insert(gtpack::cid_type cid, const std::vector<RealT>& demand, const vm_allocation_t<RealT>& solution)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto& frontier = frontiers_[cid];
+
+        if (solution.infeasible)
+        {
+            auto& infeasible_demands = frontier.infeasible_demands;
+
+            for (auto const& infeasible_demand : infeasible_demands)
+            {
+                if (dominates(demand, infeasible_demand))
+                {
+                    return;
+                }
+            }
+
+            // Keep the infeasible demands minimal
+            infeasible_demands.erase(std::remove_if(infeasible_demands.begin(),
+                                                    infeasible_demands.end(),
+                                                    [&](const std::vector<RealT>& infeasible_demand)
+                                                    {
+                                                        return dominates(infeasible_demand, demand);
+                                                    }),
+                                     infeasible_demands.end());
+            infeasible_demands.push_back(demand);
+        }
+        else if (solution.solved && !std::isnan(solution.objective_value))
+        {
+            solved_demand_t solved;
+            solved.demand = demand;
+            solved.upper_bound = solution.objective_value;
+            solved.lower_bound = std::isnan(solution.objective_bound)
+                                 ? (solution.optimal ? solution.objective_value : -std::numeric_limits<RealT>::infinity())
+                                 : solution.objective_bound;
+
+            if (frontier.solved_demands.size() >= max_solved_demands_)
+            {
+                frontier.solved_demands.pop_front();
+            }
+            frontier.solved_demands.push_back(solved);
+        }
+    }
+
+    /// Returns the number of demands found to be infeasible without solving
+    std::size_t num_infeasible_hits() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        return num_infeasible_hits_;
+    }
+
+    /// Returns the number of demands whose cost has been found to be bounded
+    std::size_t num_bounded_solves() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        return num_bounded_solves_;
+    }
+
+
+private:
+    /// Tells if demand \a a is greater than or equal to demand \a b, componentwise
+    static bool dominates(const std::vector<RealT>& a, const std::vector<RealT>& b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            if (!(a[i] >= b[i]))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+
+    std::size_t max_solved_demands_; ///< Maximum number of solved demands per coalition
+    std::vector<bool> fn_power_states_; ///< The FN power states the frontier is bound to
+    std::map<gtpack::cid_type, coalition_frontier_t> frontiers_; ///< Frontiers, by coalition
+    std::size_t num_infeasible_hits_;
+    std::size_t num_bounded_solves_;
+    mutable std::mutex mutex_;
+}; // vm_allocation_frontier_t
+
+}} // Namespace dcs::fgt
+
+
+#endif // DCS_FGT_VM_ALLOCATION_FRONTIER_HPP
@@ -28,6 +28,7 @@
 #define DCS_FGT_VM_ALLOCATION_SOLVERS_HPP
 
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <dcs/assert.hpp>
@@ -45,14 +46,303 @@
 #include <ilcplex/ilocplex.h>
 #include <iostream>
 #include <limits>
+#include <map>
 #include <set>
 #include <sstream>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 
 namespace dcs { namespace fgt {
 
+/**
+ * \brief Cache of the CP model blocks of the VM allocation problems of the
+ *  coalitions of an interval.
+ *
+ * Within an interval, the problem of a coalition is the problem of the
+ * coalition without its last FP, plus the FNs, VMs and services of that FP.
+ * Thus, the cache creates the variables of every FN and of every FN-VM pair
+ * once, sums the FN-VM pairs of every pair of FPs (the FNs of one and the VMs
+ * of the other) once, and composes the per-FN and per-VM expressions of a
+ * coalition from the ones of the coalition without its last FP, only adding
+ * the pair sums of the last FP.
+ *
+ * All the problems solved with the same cache must include all the FNs and
+ * VMs of their FPs, and must share the VM-to-service mapping, the FN power
+ * states and the predicted service delays (i.e., the demand of the interval).
+ * Since the model blocks live in a Concert environment owned by the cache,
+ * the cache must be used by one thread at a time, and the memory of the
+ * blocks is only released when the cache is destroyed.
+ */
+template <typename RealT>
+class vm_allocation_model_cache_t
+{
+public:
+    /// Per-FN and per-VM expressions of the constraints of a set of FPs
+    struct block_t
+    {
+        std::map<std::size_t,IloNumExpr> fn_cpu_exprs; ///< CPU allocated to the VMs of the block, by FN of the block
+        std::map<std::size_t,IloNumExpr> fn_ram_exprs; ///< RAM allocated to the VMs of the block, by FN of the block
+        std::map<std::size_t,IloIntExpr> fn_num_vms_exprs; ///< Number of VMs of the block allocated, by FN of the block
+        std::map<std::size_t,IloIntExpr> vm_num_fns_exprs; ///< Number of FNs of the block allocating it, by VM of the block
+    }; // block_t
+
+
+    explicit vm_allocation_model_cache_t(const vm_allocation_features_t<RealT>& features)
+    : features_(features),
+      p_vm_svcs_(nullptr),
+      p_fn_power_states_(nullptr),
+      p_svc_predicted_delays_(nullptr)
+    {
+    }
+
+    vm_allocation_model_cache_t(const vm_allocation_model_cache_t&) = delete;
+
+    vm_allocation_model_cache_t& operator=(const vm_allocation_model_cache_t&) = delete;
+
+    ~vm_allocation_model_cache_t()
+    {
+        env_.end();
+    }
+
+    IloEnv& environment()
+    {
+        return env_;
+    }
+
+    /// Binds the cache to the demand of the given problem (on first use), and
+    /// records the FNs and the VMs of its FPs
+    void bind(const vm_allocation_problem_t<RealT>& problem)
+    {
+        if (!p_vm_svcs_)
+        {
+            p_vm_svcs_ = &problem.vm_svcs;
+            p_fn_power_states_ = &problem.fn_power_states;
+            p_svc_predicted_delays_ = &problem.svc_predicted_delays;
+        }
+
+        // check: the demand of the problem is the one of the cache
+        DCS_ASSERT(p_vm_svcs_ == &problem.vm_svcs && p_fn_power_states_ == &problem.fn_power_states && p_svc_predicted_delays_ == &problem.svc_predicted_delays,
+                   DCS_EXCEPTION_THROW(std::invalid_argument, "The VM allocation problem does not share the demand of the model cache"));
+
+        for (auto const fn : problem.fns)
+        {
+            auto& fns = fp_fns_[features_.fn_fps[fn]];
+            if (std::find(fns.begin(), fns.end(), fn) == fns.end())
+            {
+                fns.push_back(fn);
+            }
+        }
+        for (auto const vm : problem.vms)
+        {
+            auto& vms = fp_vms_[features_.svc_fps[problem.vm_svcs[vm]]];
+            if (std::find(vms.begin(), vms.end(), vm) == vms.end())
+            {
+                vms.push_back(vm);
+            }
+        }
+    }
+
+    /// Returns the variable telling if the given FN is powered on
+    const IloBoolVar& fn_var(std::size_t fn)
+    {
+        auto it = fn_vars_.find(fn);
+        if (it == fn_vars_.end())
+        {
+            std::ostringstream oss;
+            oss << "x[" << fn << "]";
+            it = fn_vars_.insert(std::make_pair(fn, IloBoolVar(env_, oss.str().c_str()))).first;
+        }
+
+        return it->second;
+    }
+
+    /// Returns the variable telling if the given VM is allocated on the given FN
+    const IloBoolVar& fn_vm_var(std::size_t fn, std::size_t vm)
+    {
+        auto const key = std::make_pair(fn, vm);
+
+        auto it = fn_vm_vars_.find(key);
+        if (it == fn_vm_vars_.end())
+        {
+            std::ostringstream oss;
+            oss << "y[" << fn << "][" << vm << "]";
+            it = fn_vm_vars_.insert(std::make_pair(key, IloBoolVar(env_, oss.str().c_str()))).first;
+        }
+
+        return it->second;
+    }
+
+    /// Returns the predicted delays of the given service as a Concert array
+    /// (to be indexed by the number of allocated VMs)
+    const IloNumArray& svc_delays(std::size_t svc)
+    {
+        auto it = svc_delays_.find(svc);
+        if (it == svc_delays_.end())
+        {
+            auto const& delays = (*p_svc_predicted_delays_)[svc];
+
+            IloNumArray delays_aux(env_, delays.size());
+            for (std::size_t j = 0; j < delays.size(); ++j)
+            {
+                delays_aux[j] = std::isinf(delays[j]) ? IloInfinity : delays[j];
+            }
+
+            it = svc_delays_.insert(std::make_pair(svc, delays_aux)).first;
+        }
+
+        return it->second;
+    }
+
+    /// Returns the block of the given FPs (sorted in increasing order),
+    /// composing it from the block without the last FP
+    const block_t& block(const std::vector<std::size_t>& fps)
+    {
+        DCS_DEBUG_ASSERT( !fps.empty() );
+
+        auto it = blocks_.find(fps);
+        if (it != blocks_.end())
+        {
+            return it->second;
+        }
+
+        auto const last_fp = fps.back();
+
+        block_t blk;
+        if (fps.size() == 1)
+        {
+            blk = this->pair_block(last_fp, last_fp);
+        }
+        else
+        {
+            const std::vector<std::size_t> prev_fps(fps.begin(), fps.end()-1);
+            const block_t& prev_blk = this->block(prev_fps);
+
+            // FNs and VMs of the previous FPs: add the VMs and the FNs of the last FP
+            for (auto const& fn_expr : prev_blk.fn_cpu_exprs)
+            {
+                auto const fn = fn_expr.first;
+                const block_t& pair_blk = this->pair_block(features_.fn_fps[fn], last_fp);
+
+                blk.fn_cpu_exprs[fn] = fn_expr.second + pair_blk.fn_cpu_exprs.at(fn);
+                blk.fn_ram_exprs[fn] = prev_blk.fn_ram_exprs.at(fn) + pair_blk.fn_ram_exprs.at(fn);
+                blk.fn_num_vms_exprs[fn] = prev_blk.fn_num_vms_exprs.at(fn) + pair_blk.fn_num_vms_exprs.at(fn);
+            }
+            for (auto const& vm_expr : prev_blk.vm_num_fns_exprs)
+            {
+                auto const vm = vm_expr.first;
+                const block_t& pair_blk = this->pair_block(last_fp, features_.svc_fps[(*p_vm_svcs_)[vm]]);
+
+                blk.vm_num_fns_exprs[vm] = vm_expr.second + pair_blk.vm_num_fns_exprs.at(vm);
+            }
+
+            // FNs and VMs of the last FP: add the VMs and the FNs of all the FPs
+            for (auto const fp : fps)
+            {
+                const block_t& fn_pair_blk = this->pair_block(last_fp, fp);
+                for (auto const& fn_expr : fn_pair_blk.fn_cpu_exprs)
+                {
+                    auto const fn = fn_expr.first;
+
+                    if (fp == fps.front())
+                    {
+                        blk.fn_cpu_exprs[fn] = fn_expr.second;
+                        blk.fn_ram_exprs[fn] = fn_pair_blk.fn_ram_exprs.at(fn);
+                        blk.fn_num_vms_exprs[fn] = fn_pair_blk.fn_num_vms_exprs.at(fn);
+                    }
+                    else
+                    {
+                        blk.fn_cpu_exprs[fn] = blk.fn_cpu_exprs.at(fn) + fn_expr.second;
+                        blk.fn_ram_exprs[fn] = blk.fn_ram_exprs.at(fn) + fn_pair_blk.fn_ram_exprs.at(fn);
+                        blk.fn_num_vms_exprs[fn] = blk.fn_num_vms_exprs.at(fn) + fn_pair_blk.fn_num_vms_exprs.at(fn);
+                    }
+                }
+
+                const block_t& vm_pair_blk = this->pair_block(fp, last_fp);
+                for (auto const& vm_expr : vm_pair_blk.vm_num_fns_exprs)
+                {
+                    auto const vm = vm_expr.first;
+
+                    if (fp == fps.front())
+                    {
+                        blk.vm_num_fns_exprs[vm] = vm_expr.second;
+                    }
+                    else
+                    {
+                        blk.vm_num_fns_exprs[vm] = blk.vm_num_fns_exprs.at(vm) + vm_expr.second;
+                    }
+                }
+            }
+        }
+
+        return blocks_.insert(std::make_pair(fps, blk)).first->second;
+    }
+
+private:
+    /// Returns the block of the allocations of the VMs of \a vm_fp on the FNs
+    /// of \a fn_fp
+    const block_t& pair_block(std::size_t fn_fp, std::size_t vm_fp)
+    {
+        auto const key = std::make_pair(fn_fp, vm_fp);
+
+        auto it = pair_blocks_.find(key);
+        if (it != pair_blocks_.end())
+        {
+            return it->second;
+        }
+
+        auto const& fns = fp_fns_[fn_fp];
+        auto const& vms = fp_vms_[vm_fp];
+
+        block_t blk;
+        for (auto const fn : fns)
+        {
+            IloNumExpr cpu_expr(env_);
+            IloNumExpr ram_expr(env_);
+            IloIntExpr num_vms_expr(env_);
+            for (auto const vm : vms)
+            {
+                auto const svc = (*p_vm_svcs_)[vm];
+                const IloBoolVar& y = this->fn_vm_var(fn, vm);
+
+                cpu_expr += y*features_.vm_cpu_requirement(svc, fn);
+                ram_expr += y*features_.vm_ram_requirement(svc, fn);
+                num_vms_expr += y;
+            }
+            blk.fn_cpu_exprs[fn] = cpu_expr;
+            blk.fn_ram_exprs[fn] = ram_expr;
+            blk.fn_num_vms_exprs[fn] = num_vms_expr;
+        }
+        for (auto const vm : vms)
+        {
+            IloIntExpr num_fns_expr(env_);
+            for (auto const fn : fns)
+            {
+                num_fns_expr += this->fn_vm_var(fn, vm);
+            }
+            blk.vm_num_fns_exprs[vm] = num_fns_expr;
+        }
+
+        return pair_blocks_.insert(std::make_pair(key, blk)).first->second;
+    }
+
+
+    IloEnv env_;
+    const vm_allocation_features_t<RealT>& features_;
+    const std::vector<std::size_t>* p_vm_svcs_; ///< The VM-to-service mapping of the cached problems
+    const std::vector<bool>* p_fn_power_states_; ///< The FN power states of the cached problems
+    const std::vector<std::vector<RealT>>* p_svc_predicted_delays_; ///< The predicted service delays of the cached problems
+    std::map<std::size_t,std::vector<std::size_t>> fp_fns_; ///< The FNs of the FPs seen so far
+    std::map<std::size_t,std::vector<std::size_t>> fp_vms_; ///< The VMs of the FPs seen so far
+    std::map<std::size_t,IloBoolVar> fn_vars_; ///< Power variables, by FN
+    std::map<std::pair<std::size_t,std::size_t>,IloBoolVar> fn_vm_vars_; ///< Allocation variables, by FN and VM
+    std::map<std::size_t,IloNumArray> svc_delays_; ///< Predicted delays, by service
+    std::map<std::pair<std::size_t,std::size_t>,block_t> pair_blocks_; ///< Blocks of pairs of FPs, by FP of the FNs and FP of the VMs
+    std::map<std::vector<std::size_t>,block_t> blocks_; ///< Blocks of sets of FPs
+}; // vm_allocation_model_cache_t
+
+
 /**
  * \brief Optimal solver for the VM allocation problem.
  */
@@ -63,8 +353,73 @@ public:
     explicit optimal_vm_allocation_solver_t(RealT relative_tolerance = 0,
                                             RealT time_limit = -1)
     : rel_tol_(relative_tolerance),
-      time_lim_(time_limit)
+      time_lim_(time_limit),
+      obj_lb_(-std::numeric_limits<RealT>::infinity()),
+      obj_ub_(std::numeric_limits<RealT>::infinity())
+    {
+    }
+
+    /// Sets the known bounds of the optimal objective value of the next
+    /// problems to solve (use infinite bounds to remove them).
+    /// The bounds are added to the model as cuts, so that the solver can
+    /// prune the search earlier; a problem that is infeasible with the cuts
+    /// is not reported as infeasible, since its bounds may be wrong.
+    void objective_bounds(RealT lower_bound, RealT upper_bound)
+    {
+        obj_lb_ = lower_bound;
+        obj_ub_ = upper_bound;
+    }
+
+    bool has_objective_bounds() const
     {
+        return !std::isinf(obj_lb_) || !std::isinf(obj_ub_);
+    }
+
+    /// Solves the given problem instance, whose FN and service attributes
+    /// are looked up in the precomputed features of the scenario (see
+    /// \c make_vm_allocation_features).
+    vm_allocation_t<RealT> operator()(const vm_allocation_problem_t<RealT>& problem) const
+    {
+        DCS_DEBUG_TRACE("Finding optimal VM allocation:");
+        DCS_DEBUG_TRACE("- Number of FNs: " << problem.fns.size());
+        DCS_DEBUG_TRACE("- Number of VMs: " << problem.vms.size());
+        DCS_DEBUG_TRACE("- FNs: " << problem.fns);
+        DCS_DEBUG_TRACE("- VMs: " << problem.vms);
+        DCS_DEBUG_TRACE("- FN Power States: " << problem.fn_power_states);
+        DCS_DEBUG_TRACE("- VM to Service Mapping: " << problem.vm_svcs);
+        DCS_DEBUG_TRACE("- Service Predicted Delays: " << problem.svc_predicted_delays);
+        DCS_DEBUG_TRACE("- Relative Tolerance: " << rel_tol_);
+        DCS_DEBUG_TRACE("- Time Limit: " << time_lim_);
+
+        return by_native_cp(problem);
+    }
+
+    /// Solves the given problem instance, composing its model from the
+    /// blocks of the given cache (see \c vm_allocation_model_cache_t).
+    vm_allocation_t<RealT> operator()(const vm_allocation_problem_t<RealT>& problem, vm_allocation_model_cache_t<RealT>& model_cache) const
+    {
+        DCS_DEBUG_TRACE("Finding optimal VM allocation (with cached model blocks):");
+        DCS_DEBUG_TRACE("- Number of FNs: " << problem.fns.size());
+        DCS_DEBUG_TRACE("- Number of VMs: " << problem.vms.size());
+        DCS_DEBUG_TRACE("- Relative Tolerance: " << rel_tol_);
+        DCS_DEBUG_TRACE("- Time Limit: " << time_lim_);
+
+        return by_cached_native_cp(problem, model_cache);
+    }
+
+    /// Solves the given problem instance in aggregated form (see
+    /// \c vm_allocation_class_problem_t).
+    /// The allocation of VMs to FNs is only expanded to every FN and VM if
+    /// \a with_placement is \c true.
+    vm_allocation_t<RealT> operator()(const vm_allocation_class_problem_t<RealT>& problem, bool with_placement = false) const
+    {
+        DCS_DEBUG_TRACE("Finding optimal VM allocation (aggregated):");
+        DCS_DEBUG_TRACE("- Number of FN classes: " << problem.fn_classes.size());
+        DCS_DEBUG_TRACE("- Services: " << problem.svcs);
+        DCS_DEBUG_TRACE("- Relative Tolerance: " << rel_tol_);
+        DCS_DEBUG_TRACE("- Time Limit: " << time_lim_);
+
+        return by_aggregated_native_cp(problem, with_placement);
     }
 
     vm_allocation_t<RealT> operator()(const std::vector<std::size_t>& fns, // Holds the identity of FNs in FN' (i.e., fns[i]=k -> FN k \in FN')
@@ -113,53 +468,38 @@ public:
         DCS_DEBUG_TRACE("- Relative Tolerance: " << rel_tol_);
         DCS_DEBUG_TRACE("- Time Limit: " << time_lim_);
 
-        return by_native_cp(fns,
-                            vms,
-                            fn_to_fps,
-                            fn_categories,
-                            fn_power_states,
-                            fn_cat_min_powers,
-                            fn_cat_max_powers,
-                            vm_to_svcs,
-                            svc_cat_vm_categories,
-                            vm_cpu_specs,
-                            vm_ram_specs,
-                            svc_to_fps,
-                            svc_categories,
-                            svc_cat_max_delays,
-                            svc_predicted_delays,
-                            fp_svc_cat_penalties,
-                            fp_electricity_costs,
-                            fp_fn_cat_asleep_costs,
-                            fp_fn_cat_awake_costs);
+        const auto features = make_vm_allocation_features(fn_to_fps,
+                                                          fn_categories,
+                                                          fn_cat_min_powers,
+                                                          fn_cat_max_powers,
+                                                          svc_cat_vm_categories,
+                                                          vm_cpu_specs,
+                                                          vm_ram_specs,
+                                                          svc_to_fps,
+                                                          svc_categories,
+                                                          svc_cat_max_delays,
+                                                          fp_svc_cat_penalties,
+                                                          fp_electricity_costs,
+                                                          fp_fn_cat_asleep_costs,
+                                                          fp_fn_cat_awake_costs);
+
+        return by_native_cp(vm_allocation_problem_t<RealT>(features, fns, vms, vm_to_svcs, fn_power_states, svc_predicted_delays));
                             //fp_to_fp_vm_migration_costs);
     }
 
 
 private:
-    vm_allocation_t<RealT> by_native_cp(const std::vector<std::size_t>& fns, // Holds the identity of FNs in FN' (i.e., fns[i]=k -> FN k \in FN')
-                                        const std::vector<std::size_t>& vms, // Holds the identity of VMs in VM' (i.e., vms[i]=k -> VM k \in VM')
-                                        const std::vector<std::size_t>& fn_to_fps, // Maps every FN to its FP
-                                        const std::vector<std::size_t>& fn_categories, // Maps every FN to its FN category
-                                        const std::vector<bool>& fn_power_states, // The power status of each FN
-                                        const std::vector<RealT>& fn_cat_min_powers, // The min power consumption of FNs by FN category
-                                        const std::vector<RealT>& fn_cat_max_powers, // The max power consumption of FNs by FN category
-                                        const std::vector<std::size_t>& vm_to_svcs, // Maps every VM to its service
-                                        const std::vector<std::size_t>& svc_cat_vm_categories, // Maps every VM to its VM category
-                                        const std::vector<std::vector<RealT>>& vm_cpu_specs, // The CPU requirement of VMs by VM category
-                                        const std::vector<std::vector<RealT>>& vm_ram_specs, // The RAM requirement of VMs by VM category
-                                        const std::vector<std::size_t>& svc_to_fps, // Maps every service to its FP
-                                        const std::vector<std::size_t>& svc_categories, // Maps every service to its service category
-                                        const std::vector<RealT>& svc_cat_max_delays, // Max tolerated service delays, by service category
-                                        const std::vector<std::vector<RealT>>& svc_predicted_delays, // Achieved delay by service and number of VMs
-                                        const std::vector<std::vector<RealT>>& fp_svc_cat_penalties, // Monetary penalties by FP and service
-                                        const std::vector<RealT>& fp_electricity_costs, // Electricty cost (in $/Wh) of each FP
-                                        const std::vector<std::vector<RealT>>& fp_fn_cat_asleep_costs, // Cost to power-off a FN by FP and FN category
-                                        const std::vector<std::vector<RealT>>& fp_fn_cat_awake_costs) const // Cost to power-on a FN by FP and FN category
-                                        //const std::vector<std::vector<std::vector<RealT>>>& fp_to_fp_vm_migration_costs) const // Cost to migrate a VM by source FP, destination FP and VM category
+    vm_allocation_t<RealT> by_native_cp(const vm_allocation_problem_t<RealT>& problem) const
     {
         vm_allocation_t<RealT> solution;
 
+        auto const& features = problem.features;
+        auto const& fns = problem.fns;
+        auto const& vms = problem.vms;
+        auto const& vm_to_svcs = problem.vm_svcs;
+        auto const& fn_power_states = problem.fn_power_states;
+        auto const& svc_predicted_delays = problem.svc_predicted_delays;
+
         std::vector<std::size_t> svcs; // Holds the identity of services in S' (i.e., svcs.count(k)>0 -> service k \in S')
 
         // Build the services collection
@@ -237,7 +577,6 @@ private:
             for (std::size_t i = 0; i < nfns; ++i)
             {
                 const std::size_t fn = fns[i];
-                const std::size_t fn_cat = fn_categories[fn];
 
                 u[i] = IloNumExpr(env);
 
@@ -245,10 +584,8 @@ private:
                 {
                     const std::size_t vm = vms[j];
                     const std::size_t svc = vm_to_svcs[vm];
-                    const std::size_t svc_cat = svc_categories[svc];
-                    const std::size_t vm_cat = svc_cat_vm_categories[svc_cat];
 
-                    u[i] += y[i][j]*vm_cpu_specs[vm_cat][fn_cat];
+                    u[i] += y[i][j]*features.vm_cpu_requirement(svc, fn);
                 }
 
                 std::ostringstream oss;
@@ -386,18 +723,15 @@ private:
                 std::ostringstream oss;
                 oss << "C" << cc << "_{" << i << "}";
 
+                const std::size_t fn = fns[i];
+
                 IloNumExpr lhs_expr(env);
                 for (std::size_t j = 0; j < nvms; ++j)
                 {
-                    const std::size_t fn = fns[i];
-                    const std::size_t fn_cat = fn_categories[fn];
                     const std::size_t vm = vms[j];
                     const std::size_t svc = vm_to_svcs[vm];
-                    const std::size_t svc_cat = svc_categories[svc];
-                    const std::size_t vm_cat = svc_cat_vm_categories[svc_cat];
-                    const RealT req = vm_ram_specs[vm_cat][fn_cat];
 
-                    lhs_expr += y[i][j]*req;
+                    lhs_expr += y[i][j]*features.vm_ram_requirement(svc, fn);
                 }
 
                 IloConstraint cons(lhs_expr <= x[i]);
@@ -501,18 +835,16 @@ private:
                 for (std::size_t i = 0; i < nfns; ++i)
                 {
                     const std::size_t fn = fns[i];
-                    const std::size_t fn_fp = fn_to_fps[fn];
-                    const std::size_t fn_cat = fn_categories[fn];
                     const int fn_power_state = fn_power_states[fn];
-                    const RealT dC = fn_cat_max_powers[fn_cat]-fn_cat_min_powers[fn_cat];
-                    const RealT wcost = fp_electricity_costs[fn_fp];
+                    const RealT dC = features.fn_max_powers[fn]-features.fn_min_powers[fn];
+                    const RealT wcost = features.fn_electricity_costs[fn];
 
                     // Add FN electricity costs
-                    obj_expr += (x[i]*fn_cat_min_powers[fn_cat]+dC*u[i])*wcost;
+                    obj_expr += (x[i]*features.fn_min_powers[fn]+dC*u[i])*wcost;
 
                     // Add FN switch-on/off costs
-                    obj_expr += x[i]*(1-fn_power_state)*fp_fn_cat_awake_costs[fn_fp][fn_cat]
-                             +  (1-x[i])*fn_power_state*fp_fn_cat_asleep_costs[fn_fp][fn_cat];
+                    obj_expr += x[i]*(1-fn_power_state)*features.fn_awake_costs[fn]
+                             +  (1-x[i])*fn_power_state*features.fn_asleep_costs[fn];
 
 /*FIXME: VM migration not handled for now
                     // Add VM migration costs
@@ -533,8 +865,6 @@ private:
                 for (std::size_t k = 0; k < nsvcs; ++k)
                 {
                     const std::size_t svc = svcs[k];
-                    const std::size_t fp = svc_to_fps[svc];
-                    const std::size_t svc_cat = svc_categories[svc];
 
                     IloIntExpr num_vms_expr(env);
                     for (std::size_t j = 0; j < nvms; ++j)
@@ -546,11 +876,13 @@ private:
                         num_vms_expr += allocated_vms_expr[j]*IloBool(vm_to_svcs[vm] == svc);
                     }
 
-//DCS_DEBUG_TRACE("Adding SLA costs for service #" << k << ": " << svc << ", fp: "<< fp << ", cat: " << svc_cat);
-                    obj_expr += (IloMax(svc_predicted_delays_aux[svc][num_vms_expr]/svc_cat_max_delays[svc_cat], 1.0) - 1.0)*fp_svc_cat_penalties[fp][svc_cat];
+//DCS_DEBUG_TRACE("Adding SLA costs for service #" << k << ": " << svc << ", fp: "<< features.svc_fps[svc] << ", cat: " << features.svc_categories[svc]);
+                    obj_expr += (IloMax(svc_predicted_delays_aux[svc][num_vms_expr]/features.svc_max_delays[svc], 1.0) - 1.0)*features.svc_penalties[svc];
                 }
 
                 obj = IloMinimize(env, obj_expr);
+
+                this->add_objective_bounds(model, obj_expr);
             }
             model.add(obj);
 
@@ -559,61 +891,14 @@ private:
             IloCP solver(model);
 
             //write model
-#ifndef DCS_DEBUG
-            solver.setOut(env.getNullStream());
-            solver.setWarning(env.getNullStream());
-#else // DCS_DEBUG
+#ifdef DCS_DEBUG
             solver.exportModel("cplex-model.cpo");
             solver.dumpModel("cplex-model_dump.cpo");
 #endif // DCS_DEBUG
 
-            // Set Relative Optimality Tolerance to (rel_tol_*100)%: CP will stop as soon as it has found a feasible solution proved to be within (rel_tol_*100)% of optimal.
-            if (math::float_traits<RealT>::definitely_greater(rel_tol_, 0))
-            {
-                //solver.setParam(IloCplex::Param::MIP::Tolerances::MIPGap, rel_tol_);
-                solver.setParameter(IloCP::RelativeOptimalityTolerance, rel_tol_);
-            }
-            if (math::float_traits<RealT>::definitely_greater(time_lim_, 0))
-            {
-                //solver.setParam(IloCplex::Param::TimeLimit, time_lim_);
-                solver.setParameter(IloCP::TimeLimit, time_lim_);
-            }
-
-            solver.propagate();
-            solution.solved = solver.solve();
-            solution.optimal = false;
-
-            IloAlgorithm::Status status = solver.getStatus();
-            switch (status)
+            if (!this->solve_cp(solver, solution))
             {
-                case IloAlgorithm::Optimal: // The algorithm found an optimal solution.
-                    solution.objective_value = static_cast<RealT>(solver.getObjValue());
-                    solution.optimal = true;
-                    break;
-                case IloAlgorithm::Feasible: // The algorithm found a feasible solution, though it may not necessarily be optimal.
-
-                    solution.objective_value = static_cast<RealT>(solver.getObjValue());
-                    ::dcs::log_warn(DCS_LOGGING_AT, "Optimization problem solved but non-optimal");
-                    break;
-                case IloAlgorithm::Infeasible: // The algorithm proved the model infeasible (i.e., it is not possible to find an assignment of values to variables satisfying all the constraints in the model).
-                case IloAlgorithm::Unbounded: // The algorithm proved the model unbounded.
-                case IloAlgorithm::InfeasibleOrUnbounded: // The model is infeasible or unbounded.
-                case IloAlgorithm::Error: // An error occurred and, on platforms that support exceptions, that an exception has been thrown.
-                case IloAlgorithm::Unknown: // The algorithm has no information about the solution of the model.
-                {
-                    // Possible CP status (obtained with getInfo):
-                    // - IloCP::SearchHasNotFailed: indicates that the search has not failed.
-                    // - IloCP::SearchHasFailedNormally: indicates that the search has failed because it has searched the entire search space.
-                    // - IloCP::SearchStoppedByLimit: indicates that the search was stopped by a limit, such as a time limit (see IloCP::TimeLimit) or a fail limit (see IloCP::FailLimit ).
-                    // - IloCP::SearchStoppedByLabel: indicates that the search was stopped via a fail label which did not exist on any choice point (advanced use).
-                    // - IloCP::SearchStoppedByExit: indicates that the search was exited using IloCP::exitSearch.
-                    // - IloCP::SearchStoppedByAbort: indicates that the search was stopped by calling IloCP::abortSearch.
-                    // - IloCP::UnknownFailureStatus: indicates that the search failed for some other reason.
-                    std::ostringstream oss;
-                    oss << "Optimization was stopped with status = " << status << " (CP status = " << solver.getInfo(IloCP::FailStatus) << ")";
-                    dcs::log_warn(DCS_LOGGING_AT, oss.str());
-                    return solution;
-                }
+                return solution;
             }
 
 #ifdef DCS_DEBUG
@@ -710,6 +995,489 @@ private:
         return solution;
     }
 
+    vm_allocation_t<RealT> by_cached_native_cp(const vm_allocation_problem_t<RealT>& problem, vm_allocation_model_cache_t<RealT>& model_cache) const
+    {
+        vm_allocation_t<RealT> solution;
+
+        auto const& features = problem.features;
+        auto const& fns = problem.fns;
+        auto const& vms = problem.vms;
+        auto const& vm_to_svcs = problem.vm_svcs;
+        auto const& fn_power_states = problem.fn_power_states;
+
+        const std::size_t nfns = fns.size();
+        const std::size_t nvms = vms.size();
+
+        // The environment outlives this call, so the model and the solver must
+        // be ended on every path
+        IloModel model;
+        IloCP solver;
+
+        try
+        {
+            model_cache.bind(problem);
+
+            // The FPs of the problem (the ones of FNs, since every FP has FNs)
+            std::vector<std::size_t> fps;
+            for (auto const fn : fns)
+            {
+                fps.push_back(features.fn_fps[fn]);
+            }
+            std::sort(fps.begin(), fps.end());
+            fps.erase(std::unique(fps.begin(), fps.end()), fps.end());
+
+            auto const& blk = model_cache.block(fps);
+
+            IloEnv& env = model_cache.environment();
+
+            model = IloModel(env);
+
+            model.setName("Min-Cost Optimization");
+
+            // Constraints (see by_native_cp)
+
+            for (auto const fn : fns)
+            {
+                const IloBoolVar& x = model_cache.fn_var(fn);
+
+                model.add(x);
+                model.add(blk.fn_num_vms_exprs.at(fn) <= IloInt(nvms)*x);
+                model.add(blk.fn_cpu_exprs.at(fn) <= x);
+                model.add(blk.fn_ram_exprs.at(fn) <= x);
+            }
+            for (auto const vm : vms)
+            {
+                model.add(blk.vm_num_fns_exprs.at(vm) <= 1);
+            }
+
+            // Objective
+            IloNumExpr obj_expr(env);
+            for (auto const fn : fns)
+            {
+                const IloBoolVar& x = model_cache.fn_var(fn);
+                const int fn_power_state = fn_power_states[fn];
+                const RealT dC = features.fn_max_powers[fn]-features.fn_min_powers[fn];
+                const RealT wcost = features.fn_electricity_costs[fn];
+
+                // Add FN electricity costs
+                obj_expr += (x*features.fn_min_powers[fn]+dC*blk.fn_cpu_exprs.at(fn))*wcost;
+
+                // Add FN switch-on/off costs
+                obj_expr += x*(1-fn_power_state)*features.fn_awake_costs[fn]
+                         +  (1-x)*fn_power_state*features.fn_asleep_costs[fn];
+            }
+
+            // Add SLA violation costs
+            std::map<std::size_t,IloIntExpr> svc_num_vms_exprs;
+            for (auto const vm : vms)
+            {
+                auto const svc = vm_to_svcs[vm];
+
+                auto it = svc_num_vms_exprs.find(svc);
+                if (it == svc_num_vms_exprs.end())
+                {
+                    it = svc_num_vms_exprs.insert(std::make_pair(svc, IloIntExpr(env))).first;
+                }
+                it->second += blk.vm_num_fns_exprs.at(vm);
+            }
+            for (auto const& svc_expr : svc_num_vms_exprs)
+            {
+                auto const svc = svc_expr.first;
+
+                obj_expr += (IloMax(model_cache.svc_delays(svc)[svc_expr.second]/features.svc_max_delays[svc], 1.0) - 1.0)*features.svc_penalties[svc];
+            }
+
+            IloObjective obj = IloMinimize(env, obj_expr);
+            model.add(obj);
+
+            this->add_objective_bounds(model, obj_expr);
+
+            solver = IloCP(model);
+
+            if (!this->solve_cp(solver, solution))
+            {
+                solver.end();
+                model.end();
+                return solution;
+            }
+
+            solution.fn_vm_allocations.resize(nfns);
+            solution.fn_power_states.resize(nfns, 0);
+            for (std::size_t i = 0; i < nfns; ++i)
+            {
+                const std::size_t fn = fns[i];
+
+                solution.fn_power_states[i] = static_cast<bool>(solver.getValue(model_cache.fn_var(fn)));
+                solution.fn_vm_allocations[i].resize(nvms);
+                for (std::size_t j = 0; j < nvms; ++j)
+                {
+                    solution.fn_vm_allocations[i][j] = static_cast<bool>(solver.getValue(model_cache.fn_vm_var(fn, vms[j])));
+                }
+            }
+
+            solver.end();
+            model.end();
+        }
+        catch (const IloException& e)
+        {
+            if (solver.getImpl())
+            {
+                solver.end();
+            }
+            if (model.getImpl())
+            {
+                model.end();
+            }
+
+            std::ostringstream oss;
+            oss << "Got exception from CP Optimizer: " << e.getMessage();
+            DCS_EXCEPTION_THROW(std::runtime_error, oss.str());
+        }
+
+        return solution;
+    }
+
+    /**
+     * Solves the problem with a model whose variables are the power states of
+     * FNs and the number of VMs of every service on every FN.
+     *
+     * Since at most |VM'| FNs host some VM, and FNs of the same class are
+     * interchangeable, only the first min(n,|VM'|) FNs of a class of n FNs are
+     * modeled; every other FN is idle and is powered on or off, whichever is
+     * cheaper.
+     * The modeled FNs of a class are ordered by power state and CPU load, to
+     * break the symmetry among them.
+     */
+    vm_allocation_t<RealT> by_aggregated_native_cp(const vm_allocation_class_problem_t<RealT>& problem, bool with_placement) const
+    {
+        vm_allocation_t<RealT> solution;
+
+        auto const& features = problem.features;
+        auto const& fn_classes = problem.fn_classes;
+        auto const& svc_predicted_delays = problem.svc_predicted_delays;
+
+        // The services with some VM, and the total number of VMs
+        std::vector<std::size_t> svcs;
+        std::size_t nvms = 0;
+        for (auto const svc : problem.svcs)
+        {
+            if (problem.svc_num_vms[svc] > 0)
+            {
+                svcs.push_back(svc);
+                nvms += problem.svc_num_vms[svc];
+            }
+        }
+
+        const std::size_t nsvcs = svcs.size();
+
+        // The class of every modeled FN, and the cost and power state of the
+        // other (idle) FNs
+        std::vector<std::size_t> slot_classes;
+        std::vector<bool> class_idle_power_states(fn_classes.size());
+        RealT idle_cost = 0;
+        for (std::size_t c = 0; c < fn_classes.size(); ++c)
+        {
+            const std::size_t fn = fn_classes[c].fn;
+            const int fn_power_state = fn_classes[c].power_state;
+            const std::size_t nslots = std::min(fn_classes[c].size, nvms);
+
+            slot_classes.insert(slot_classes.end(), nslots, c);
+
+            const RealT on_cost = features.fn_min_powers[fn]*features.fn_electricity_costs[fn]
+                                + (1-fn_power_state)*features.fn_awake_costs[fn];
+            const RealT off_cost = fn_power_state*features.fn_asleep_costs[fn];
+
+            class_idle_power_states[c] = on_cost < off_cost || (on_cost == off_cost && fn_classes[c].power_state);
+            idle_cost += (fn_classes[c].size-nslots)*std::min(on_cost, off_cost);
+        }
+
+        const std::size_t nslots = slot_classes.size();
+
+        try
+        {
+            IloEnv env;
+
+            IloModel model(env);
+
+            model.setName("Min-Cost Optimization (Aggregated)");
+
+            // Decision Variables
+
+            // Variables x_i \in \{0,1\}: 1 if modeled FN i is to be powered on, 0 otherwise.
+            IloBoolVarArray x(env, nslots);
+            for (std::size_t i = 0; i < nslots; ++i)
+            {
+                std::ostringstream oss;
+                oss << "x[" << i << "]";
+                x[i] = IloBoolVar(env, oss.str().c_str());
+                model.add(x[i]);
+            }
+
+            // Variables z_{ik} \in [0,n_k]: number of VMs of service k on modeled FN i.
+            IloArray<IloIntVarArray> z(env, nslots);
+            for (std::size_t i = 0; i < nslots; ++i)
+            {
+                z[i] = IloIntVarArray(env, nsvcs);
+
+                for (std::size_t k = 0; k < nsvcs; ++k)
+                {
+                    std::ostringstream oss;
+                    oss << "z[" << i << "][" << k << "]";
+                    z[i][k] = IloIntVar(env, 0, IloInt(problem.svc_num_vms[svcs[k]]), oss.str().c_str());
+                    model.add(z[i][k]);
+                }
+            }
+
+            // Decision expressions
+
+            // Expression u_i \in [0,1]: total fraction of CPU of modeled FN i allocated to VMs
+            //   u_i = \sum_{k \in S'} z_{ik}*U_{vmcat(k),fncat(i)}
+            IloArray<IloNumExpr> u(env, nslots);
+            for (std::size_t i = 0; i < nslots; ++i)
+            {
+                const std::size_t fn = fn_classes[slot_classes[i]].fn;
+
+                u[i] = IloNumExpr(env);
+
+                for (std::size_t k = 0; k < nsvcs; ++k)
+                {
+                    u[i] += z[i][k]*features.vm_cpu_requirement(svcs[k], fn);
+                }
+
+                std::ostringstream oss;
+                oss << "u[" << i << "]";
+                u[i].setName(oss.str().c_str());
+
+                model.add(u[i]);
+            }
+
+            // Constraints (see by_native_cp)
+
+            for (std::size_t i = 0; i < nslots; ++i)
+            {
+                const std::size_t fn = fn_classes[slot_classes[i]].fn;
+
+                //   \sum_{k \in S'} z_{ik} \le |VM'|*x_{i}
+                model.add(IloSum(z[i]) <= IloInt(nvms)*x[i]);
+
+                //   u_{i} \le x_{i}
+                model.add(u[i] <= x[i]);
+
+                //   \sum_{k \in S'} z_{ik}M_{k,i} \le x_{i}
+                IloNumExpr ram_expr(env);
+                for (std::size_t k = 0; k < nsvcs; ++k)
+                {
+                    ram_expr += z[i][k]*features.vm_ram_requirement(svcs[k], fn);
+                }
+                model.add(ram_expr <= x[i]);
+
+                // Symmetry breaking among the modeled FNs of the same class:
+                //   x_{i} \ge x_{i+1}, u_{i} \ge u_{i+1}
+                if (i+1 < nslots && slot_classes[i] == slot_classes[i+1])
+                {
+                    model.add(x[i] >= x[i+1]);
+                    model.add(u[i] >= u[i+1]);
+                }
+            }
+
+            // The VMs allocated to a service cannot exceed its VMs:
+            //   \forall k \in S': \sum_{i} z_{ik} \le n_k
+            std::vector<IloIntExpr> svc_num_vms_exprs(nsvcs);
+            for (std::size_t k = 0; k < nsvcs; ++k)
+            {
+                svc_num_vms_exprs[k] = IloIntExpr(env);
+                for (std::size_t i = 0; i < nslots; ++i)
+                {
+                    svc_num_vms_exprs[k] += z[i][k];
+                }
+
+                model.add(svc_num_vms_exprs[k] <= IloInt(problem.svc_num_vms[svcs[k]]));
+            }
+
+            // Set objective
+            IloNumExpr obj_expr(env);
+
+            // Add the costs of the idle FNs
+            obj_expr += idle_cost;
+
+            for (std::size_t i = 0; i < nslots; ++i)
+            {
+                const std::size_t fn = fn_classes[slot_classes[i]].fn;
+                const int fn_power_state = fn_classes[slot_classes[i]].power_state;
+                const RealT dC = features.fn_max_powers[fn]-features.fn_min_powers[fn];
+                const RealT wcost = features.fn_electricity_costs[fn];
+
+                // Add FN electricity costs
+                obj_expr += (x[i]*features.fn_min_powers[fn]+dC*u[i])*wcost;
+
+                // Add FN switch-on/off costs
+                obj_expr += x[i]*(1-fn_power_state)*features.fn_awake_costs[fn]
+                         +  (1-x[i])*fn_power_state*features.fn_asleep_costs[fn];
+            }
+
+            // Add SLA violation costs
+            for (std::size_t k = 0; k < nsvcs; ++k)
+            {
+                const std::size_t svc = svcs[k];
+                const std::size_t svc_nvms = svc_predicted_delays[svc].size();
+
+                IloNumArray delays(env, svc_nvms);
+                for (std::size_t j = 0; j < svc_nvms; ++j)
+                {
+                    delays[j] = std::isinf(svc_predicted_delays[svc][j]) ? IloInfinity : svc_predicted_delays[svc][j];
+                }
+
+                obj_expr += (IloMax(delays[svc_num_vms_exprs[k]]/features.svc_max_delays[svc], 1.0) - 1.0)*features.svc_penalties[svc];
+            }
+
+            IloObjective obj = IloMinimize(env, obj_expr);
+            model.add(obj);
+
+            this->add_objective_bounds(model, obj_expr);
+
+            IloCP solver(model);
+
+            if (!this->solve_cp(solver, solution))
+            {
+                env.end();
+                return solution;
+            }
+
+            if (with_placement)
+            {
+                // FNs are expanded class by class, and VMs service by service
+                std::vector<std::size_t> svc_next_vms(nsvcs, 0);
+                for (std::size_t k = 1; k < nsvcs; ++k)
+                {
+                    svc_next_vms[k] = svc_next_vms[k-1]+problem.svc_num_vms[svcs[k-1]];
+                }
+
+                std::size_t i = 0;
+                for (std::size_t c = 0; c < fn_classes.size(); ++c)
+                {
+                    for (std::size_t h = 0; h < fn_classes[c].size; ++h)
+                    {
+                        std::vector<bool> fn_vm_allocations(nvms, false);
+                        bool fn_power_state = class_idle_power_states[c];
+
+                        if (h < nvms)
+                        {
+                            fn_power_state = static_cast<bool>(solver.getValue(x[i]));
+                            for (std::size_t k = 0; k < nsvcs; ++k)
+                            {
+                                const std::size_t n = static_cast<std::size_t>(solver.getValue(z[i][k])+0.5);
+
+                                std::fill_n(fn_vm_allocations.begin()+svc_next_vms[k], n, true);
+                                svc_next_vms[k] += n;
+                            }
+                            ++i;
+                        }
+
+                        solution.fn_power_states.push_back(fn_power_state);
+                        solution.fn_vm_allocations.push_back(fn_vm_allocations);
+                    }
+                }
+            }
+
+            env.end();
+        }
+        catch (const IloException& e)
+        {
+            std::ostringstream oss;
+            oss << "Got exception from CP Optimizer: " << e.getMessage();
+            DCS_EXCEPTION_THROW(std::runtime_error, oss.str());
+        }
+
+        return solution;
+    }
+
+    /// Solves the model extracted by the given solver, setting the status and
+    /// the objective value of the given solution; returns \c false if no
+    /// solution has been found.
+    bool solve_cp(IloCP& solver, vm_allocation_t<RealT>& solution) const
+    {
+#ifndef DCS_DEBUG
+        solver.setOut(solver.getEnv().getNullStream());
+        solver.setWarning(solver.getEnv().getNullStream());
+#endif // DCS_DEBUG
+
+        // Set Relative Optimality Tolerance to (rel_tol_*100)%: CP will stop as soon as it has found a feasible solution proved to be within (rel_tol_*100)% of optimal.
+        if (math::float_traits<RealT>::definitely_greater(rel_tol_, 0))
+        {
+            //solver.setParam(IloCplex::Param::MIP::Tolerances::MIPGap, rel_tol_);
+            solver.setParameter(IloCP::RelativeOptimalityTolerance, rel_tol_);
+        }
+        if (math::float_traits<RealT>::definitely_greater(time_lim_, 0))
+        {
+            //solver.setParam(IloCplex::Param::TimeLimit, time_lim_);
+            solver.setParameter(IloCP::TimeLimit, time_lim_);
+        }
+
+        solver.propagate();
+        solution.solved = solver.solve();
+        solution.optimal = false;
+        solution.infeasible = false;
+
+        IloAlgorithm::Status status = solver.getStatus();
+        switch (status)
+        {
+            case IloAlgorithm::Optimal: // The algorithm found an optimal solution.
+                solution.objective_value = static_cast<RealT>(solver.getObjValue());
+                solution.objective_bound = static_cast<RealT>(solver.getObjBound());
+                solution.optimal = true;
+                break;
+            case IloAlgorithm::Feasible: // The algorithm found a feasible solution, though it may not necessarily be optimal.
+
+                solution.objective_value = static_cast<RealT>(solver.getObjValue());
+                solution.objective_bound = static_cast<RealT>(solver.getObjBound());
+                ::dcs::log_warn(DCS_LOGGING_AT, "Optimization problem solved but non-optimal");
+                break;
+            case IloAlgorithm::Infeasible: // The algorithm proved the model infeasible (i.e., it is not possible to find an assignment of values to variables satisfying all the constraints in the model).
+                // Only a model without objective cuts is proven infeasible
+                solution.infeasible = !this->has_objective_bounds();
+                // fall through
+            case IloAlgorithm::Unbounded: // The algorithm proved the model unbounded.
+            case IloAlgorithm::InfeasibleOrUnbounded: // The model is infeasible or unbounded.
+            case IloAlgorithm::Error: // An error occurred and, on platforms that support exceptions, that an exception has been thrown.
+            case IloAlgorithm::Unknown: // The algorithm has no information about the solution of the model.
+            {
+                // Possible CP status (obtained with getInfo):
+                // - IloCP::SearchHasNotFailed: indicates that the search has not failed.
+                // - IloCP::SearchHasFailedNormally: indicates that the search has failed because it has searched the entire search space.
+                // - IloCP::SearchStoppedByLimit: indicates that the search was stopped by a limit, such as a time limit (see IloCP::TimeLimit) or a fail limit (see IloCP::FailLimit ).
+                // - IloCP::SearchStoppedByLabel: indicates that the search was stopped via a fail label which did not exist on any choice point (advanced use).
+                // - IloCP::SearchStoppedByExit: indicates that the search was exited using IloCP::exitSearch.
+                // - IloCP::SearchStoppedByAbort: indicates that the search was stopped by calling IloCP::abortSearch.
+                // - IloCP::UnknownFailureStatus: indicates that the search failed for some other reason.
+                std::ostringstream oss;
+                oss << "Optimization was stopped with status = " << status << " (CP status = " << solver.getInfo(IloCP::FailStatus) << ")";
+                dcs::log_warn(DCS_LOGGING_AT, oss.str());
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /// Adds the known bounds of the optimal objective value (if any) to the
+    /// given model, slightly relaxed to absorb rounding errors
+    void add_objective_bounds(IloModel& model, const IloNumExpr& obj_expr) const
+    {
+        if (!std::isinf(obj_lb_))
+        {
+            model.add(obj_expr >= static_cast<IloNum>(obj_lb_-bound_slack(obj_lb_)));
+        }
+        if (!std::isinf(obj_ub_))
+        {
+            model.add(obj_expr <= static_cast<IloNum>(obj_ub_+bound_slack(obj_ub_)));
+        }
+    }
+
+    static RealT bound_slack(RealT bound)
+    {
+        return 1e-6*std::max(RealT(1), std::abs(bound));
+    }
+
 #if 0 // BEGIN HACK
     vm_allocation_t<RealT> HACK_by_native_cp(const std::vector<std::size_t>& fns, // Holds the identity of FNs in FN' (i.e., fns[i]=k -> FN k \in FN')
                                         const std::vector<std::size_t>& vms, // Holds the identity of VMs in VM' (i.e., vms[i]=k -> VM k \in VM')
@@ -1367,6 +2135,8 @@ std::abort();
 private:
     RealT rel_tol_; ///< Relative optimality tolerance used to define optimality (a solution is considered optimal if there does not exist a solution with a better objective function with respect to a relative optimality tolerance).
     RealT time_lim_; ///< Time limit (in seconds) used to set the maximum time the optimizare can spend in search for the best solution.
+    RealT obj_lb_; ///< Known lower bound of the optimal objective value (minus infinity, if unknown)
+    RealT obj_ub_; ///< Known upper bound of the optimal objective value (infinity, if unknown)
 }; // optimal_vm_alllocation_solver
 
 }} // Namespace dcs::fgt
@@ -0,0 +1,737 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file dcs/fgt/vm_allocation_store.hpp
+ *
+ * \brief Persistent store of solved VM allocation problems.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_FGT_VM_ALLOCATION_STORE_HPP
+#define DCS_FGT_VM_ALLOCATION_STORE_HPP
+
+
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <dcs/assert.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/fgt/vm_allocation.hpp>
+#include <fcntl.h>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <vector>
+
+
+namespace dcs { namespace fgt {
+
+namespace detail {
+
+/// Incremental 128-bit hash made of two independent 64-bit FNV-1a lanes
+class vm_allocation_hasher_t
+{
+public:
+    vm_allocation_hasher_t()
+    : h1_(0xcbf29ce484222325ULL),
+      h2_(0x84222325cbf29ce4ULL)
+    {
+    }
+
+    void update(const void* p_data, std::size_t n)
+    {
+        const unsigned char* p_bytes = static_cast<const unsigned char*>(p_data);
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            h1_ = (h1_ ^ p_bytes[i])*0x100000001b3ULL;
+            h2_ = (h2_ ^ p_bytes[i])*0x100000001b3ULL;
+            h2_ ^= h2_ >> 29;
+        }
+    }
+
+    void update(std::size_t x)
+    {
+        const std::uint64_t v = x;
+
+        this->update(&v, sizeof(v));
+    }
+
+    void update(double x)
+    {
+        // Canonicalize values whose bit representation is not unique
+        if (std::isnan(x))
+        {
+            x = std::numeric_limits<double>::quiet_NaN();
+        }
+        else if (x == 0)
+        {
+            x = 0;
+        }
+
+        this->update(&x, sizeof(x));
+    }
+
+    template <typename T>
+    void update(const std::vector<T>& v)
+    {
+        this->update(v.size());
+        for (auto const& x : v)
+        {
+            this->update(x);
+        }
+    }
+
+    void update(const std::vector<bool>& v)
+    {
+        this->update(v.size());
+        for (std::size_t i = 0; i < v.size(); ++i)
+        {
+            this->update(static_cast<std::size_t>(v[i]));
+        }
+    }
+
+    std::uint64_t high() const
+    {
+        return mix(h1_);
+    }
+
+    std::uint64_t low() const
+    {
+        return mix(h2_ ^ 0x9e3779b97f4a7c15ULL);
+    }
+
+private:
+    static std::uint64_t mix(std::uint64_t x)
+    {
+        // Finalizer of SplitMix64
+        x = (x ^ (x >> 30))*0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27))*0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+
+    std::uint64_t h1_;
+    std::uint64_t h2_;
+}; // vm_allocation_hasher_t
+
+} // Namespace detail
+
+
+/**
+ * \brief Content-addressed store of solved VM allocation problems.
+ *
+ * Solutions are indexed by a 128-bit hash of the canonicalized inputs of
+ * \c optimal_vm_allocation_solver_t and kept in a memory-mapped file, so
+ * that they survive across runs and are shared by concurrent processes on
+ * the same host (lookups hold a shared lock on the file, while insertions
+ * hold an exclusive lock).
+ *
+ * The file is made of a header, a fixed-capacity open-addressing table of
+ * slots, and an append-only data area holding, for every solution, its
+ * status, objective value, FN power states, and the position of the FN
+ * hosting each VM (i.e., a compact form of the allocation matrix).
+ * Only optimal solutions are stored.
+ */
+template <typename RealT>
+class vm_allocation_store_t
+{
+public:
+    struct key_type
+    {
+        std::uint64_t high;
+        std::uint64_t low;
+    }; // key_type
+
+    static const std::size_t default_capacity = 65536;
+
+
+private:
+    static const std::uint32_t format_version = 1;
+
+    struct header_t
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t reserved;
+        std::uint64_t capacity; ///< Number of slots
+        std::uint64_t size; ///< Number of stored solutions
+        std::uint64_t data_end; ///< Offset of the end of the data area
+    }; // header_t
+
+    struct slot_t
+    {
+        std::uint64_t key_high;
+        std::uint64_t key_low;
+        std::uint64_t offset; ///< Offset of the solution in the data area
+        std::uint64_t length; ///< Length of the solution in the data area
+    }; // slot_t
+
+    /// Holds the lock on the store file for the lifetime of this object
+    class file_lock_t
+    {
+    public:
+        file_lock_t(int fd, int op)
+        : fd_(fd)
+        {
+            while (::flock(fd_, op) != 0)
+            {
+                DCS_ASSERT(errno == EINTR,
+                           DCS_EXCEPTION_THROW(std::runtime_error, "Unable to lock the VM allocation store file"));
+            }
+        }
+
+        ~file_lock_t()
+        {
+            ::flock(fd_, LOCK_UN);
+        }
+
+    private:
+        file_lock_t(const file_lock_t&);
+        file_lock_t& operator=(const file_lock_t&);
+
+        int fd_;
+    }; // file_lock_t
+
+
+public:
+    explicit vm_allocation_store_t(const std::string& path, std::size_t capacity = default_capacity)
+    : path_(path),
+      fd_(-1),
+      p_map_(nullptr),
+      map_size_(0),
+      num_hits_(0),
+      num_misses_(0)
+    {
+        // pre: capacity > 0
+        DCS_ASSERT(capacity > 0,
+                   DCS_EXCEPTION_THROW(std::invalid_argument, "The capacity of the VM allocation store must be positive"));
+
+        fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT, 0644);
+
+        DCS_ASSERT(fd_ >= 0,
+                   DCS_EXCEPTION_THROW(std::runtime_error, "Unable to open the VM allocation store file '" + path_ + "'"));
+
+        try
+        {
+            file_lock_t lock(fd_, LOCK_EX);
+
+            if (file_size() == 0)
+            {
+                // New store
+
+                header_t header;
+                std::memset(&header, 0, sizeof(header));
+                std::memcpy(header.magic, magic(), sizeof(header.magic));
+                header.version = format_version;
+                header.capacity = capacity;
+                header.size = 0;
+                header.data_end = data_offset(capacity);
+
+                resize_file(header.data_end);
+                remap();
+                std::memcpy(p_map_, &header, sizeof(header));
+            }
+            else
+            {
+                remap();
+            }
+
+            DCS_ASSERT(map_size_ >= sizeof(header_t)
+                       && std::memcmp(read_header().magic, magic(), sizeof(header_t::magic)) == 0
+                       && read_header().version == format_version,
+                       DCS_EXCEPTION_THROW(std::runtime_error, "The file '" + path_ + "' is not a valid VM allocation store"));
+        }
+        catch (...)
+        {
+            this->close();
+            throw;
+        }
+    }
+
+    ~vm_allocation_store_t()
+    {
+        this->close();
+    }
+
+    /// Makes the key of the given VM allocation problem.
+    /// Only the attributes of the FNs and VMs in the problem are hashed,
+    /// hence keys do not change when unrelated scenario inputs do.
+    static key_type make_key(RealT relative_tolerance, const vm_allocation_problem_t<RealT>& problem)
+    {
+        auto const& features = problem.features;
+
+        detail::vm_allocation_hasher_t hasher;
+
+        hasher.update(static_cast<double>(relative_tolerance));
+
+        hasher.update(problem.fns.size());
+        for (auto const fn : problem.fns)
+        {
+            hasher.update(features.fn_fps[fn]);
+            hasher.update(features.fn_categories[fn]);
+            hasher.update(static_cast<std::size_t>(problem.fn_power_states[fn]));
+            update_reals(hasher, features.fn_min_powers[fn]);
+            update_reals(hasher, features.fn_max_powers[fn]);
+            update_reals(hasher, features.fn_electricity_costs[fn]);
+            update_reals(hasher, features.fn_asleep_costs[fn]);
+            update_reals(hasher, features.fn_awake_costs[fn]);
+        }
+
+        hasher.update(problem.vms.size());
+        for (auto const vm : problem.vms)
+        {
+            auto const svc = problem.vm_svcs[vm];
+
+            hasher.update(svc);
+            hasher.update(features.svc_fps[svc]);
+            hasher.update(features.svc_categories[svc]);
+            hasher.update(features.svc_vm_categories[svc]);
+            update_reals(hasher, features.svc_max_delays[svc]);
+            update_reals(hasher, features.svc_penalties[svc]);
+            update_reals(hasher, problem.svc_predicted_delays[svc]);
+        }
+
+        update_reals(hasher, features.vm_fn_cat_cpu_requirements);
+        update_reals(hasher, features.vm_fn_cat_ram_requirements);
+
+        key_type key;
+        key.high = hasher.high();
+        key.low = hasher.low();
+        if (key.high == 0 && key.low == 0)
+        {
+            // The null key marks empty slots
+            key.low = 1;
+        }
+
+        return key;
+    }
+
+    /// Makes the key of the given VM allocation problem in aggregated form.
+    /// Keys differ from those made for the same problem at instance level.
+    static key_type make_key(RealT relative_tolerance, const vm_allocation_class_problem_t<RealT>& problem)
+    {
+        auto const& features = problem.features;
+
+        detail::vm_allocation_hasher_t hasher;
+
+        hasher.update(static_cast<double>(relative_tolerance));
+
+        hasher.update(problem.fn_classes.size());
+        for (auto const& fn_class : problem.fn_classes)
+        {
+            auto const fn = fn_class.fn;
+
+            hasher.update(fn_class.size);
+            hasher.update(features.fn_fps[fn]);
+            hasher.update(features.fn_categories[fn]);
+            hasher.update(static_cast<std::size_t>(fn_class.power_state));
+            update_reals(hasher, features.fn_min_powers[fn]);
+            update_reals(hasher, features.fn_max_powers[fn]);
+            update_reals(hasher, features.fn_electricity_costs[fn]);
+            update_reals(hasher, features.fn_asleep_costs[fn]);
+            update_reals(hasher, features.fn_awake_costs[fn]);
+        }
+
+        hasher.update(problem.svcs.size());
+        for (auto const svc : problem.svcs)
+        {
+            hasher.update(svc);
+            hasher.update(problem.svc_num_vms[svc]);
+            hasher.update(features.svc_fps[svc]);
+            hasher.update(features.svc_categories[svc]);
+            hasher.update(features.svc_vm_categories[svc]);
+            update_reals(hasher, features.svc_max_delays[svc]);
+            update_reals(hasher, features.svc_penalties[svc]);
+            update_reals(hasher, problem.svc_predicted_delays[svc]);
+        }
+
+        update_reals(hasher, features.vm_fn_cat_cpu_requirements);
+        update_reals(hasher, features.vm_fn_cat_ram_requirements);
+
+        key_type key;
+        key.high = hasher.high();
+        key.low = hasher.low();
+        if (key.high == 0 && key.low == 0)
+        {
+            // The null key marks empty slots
+            key.low = 1;
+        }
+
+        return key;
+    }
+
+    /// Looks for the solution of the problem with the given key
+    bool find(const key_type& key, vm_allocation_t<RealT>& solution)
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        file_lock_t lock(fd_, LOCK_SH);
+
+        this->remap();
+
+        auto const header = read_header();
+
+        std::size_t slot_idx = 0;
+        if (!find_slot(header, key, slot_idx))
+        {
+            ++num_misses_;
+            return false;
+        }
+
+        auto const slot = read_slot(slot_idx);
+        if (slot.key_high != key.high || slot.key_low != key.low)
+        {
+            ++num_misses_;
+            return false;
+        }
+
+        DCS_ASSERT(slot.offset+slot.length <= map_size_,
+                   DCS_EXCEPTION_THROW(std::runtime_error, "Corrupted VM allocation store"));
+
+        decode(p_map_+slot.offset, slot.length, solution);
+
+        ++num_hits_;
+
+        return true;
+    }
+
+    /// Stores the given solution (if optimal) of the problem with the given
+    /// key, and returns \c true if the solution has been stored
+    bool insert(const key_type& key, const vm_allocation_t<RealT>& solution)
+    {
+        if (!solution.solved || !solution.optimal)
+        {
+            return false;
+        }
+
+        std::vector<char> data = encode(solution);
+
+        std::lock_guard<std::mutex> guard(mutex_);
+        file_lock_t lock(fd_, LOCK_EX);
+
+        this->remap();
+
+        auto header = read_header();
+
+        std::size_t slot_idx = 0;
+        if (!find_slot(header, key, slot_idx))
+        {
+            DCS_DEBUG_TRACE("VM allocation store is full: solution not stored");
+            return false;
+        }
+
+        auto slot = read_slot(slot_idx);
+        if (slot.key_high == key.high && slot.key_low == key.low)
+        {
+            // Already stored (e.g., by a concurrent process)
+            return false;
+        }
+
+        // Append the solution to the data area and only then publish the slot
+
+        slot.key_high = key.high;
+        slot.key_low = key.low;
+        slot.offset = header.data_end;
+        slot.length = data.size();
+
+        resize_file(header.data_end+data.size());
+        this->remap();
+        std::memcpy(p_map_+slot.offset, data.data(), data.size());
+
+        write_slot(slot_idx, slot);
+
+        header.data_end += data.size();
+        header.size += 1;
+        std::memcpy(p_map_, &header, sizeof(header));
+
+        return true;
+    }
+
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+
+        return read_header().size;
+    }
+
+    std::size_t capacity() const
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+
+        return read_header().capacity;
+    }
+
+    std::size_t num_hits() const
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+
+        return num_hits_;
+    }
+
+    std::size_t num_misses() const
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+
+        return num_misses_;
+    }
+
+
+private:
+    vm_allocation_store_t(const vm_allocation_store_t&);
+    vm_allocation_store_t& operator=(const vm_allocation_store_t&);
+
+    static const char* magic()
+    {
+        return "DCSFGTVA";
+    }
+
+    static std::size_t data_offset(std::size_t capacity)
+    {
+        return sizeof(header_t)+capacity*sizeof(slot_t);
+    }
+
+    template <typename T>
+    static void update_reals(detail::vm_allocation_hasher_t& hasher, const std::vector<T>& v)
+    {
+        hasher.update(v.size());
+        for (auto const& x : v)
+        {
+            update_reals(hasher, x);
+        }
+    }
+
+    static void update_reals(detail::vm_allocation_hasher_t& hasher, RealT x)
+    {
+        hasher.update(static_cast<double>(x));
+    }
+
+    static std::vector<char> encode(const vm_allocation_t<RealT>& solution)
+    {
+        const std::uint32_t nfns = solution.fn_power_states.size();
+        const std::uint32_t nvms = (nfns > 0) ? solution.fn_vm_allocations[0].size() : 0;
+
+        const std::uint8_t status = (solution.solved ? 1 : 0) | (solution.optimal ? 2 : 0);
+        const double objective_value = solution.objective_value;
+
+        std::vector<char> data(sizeof(status)+sizeof(objective_value)+sizeof(nfns)+sizeof(nvms)+nfns+nvms*sizeof(std::int32_t));
+
+        char* p = data.data();
+        std::memcpy(p, &status, sizeof(status));
+        p += sizeof(status);
+        std::memcpy(p, &objective_value, sizeof(objective_value));
+        p += sizeof(objective_value);
+        std::memcpy(p, &nfns, sizeof(nfns));
+        p += sizeof(nfns);
+        std::memcpy(p, &nvms, sizeof(nvms));
+        p += sizeof(nvms);
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            *p++ = solution.fn_power_states[i] ? 1 : 0;
+        }
+        for (std::size_t j = 0; j < nvms; ++j)
+        {
+            std::int32_t host = -1;
+            for (std::size_t i = 0; i < nfns && host < 0; ++i)
+            {
+                if (solution.fn_vm_allocations[i][j])
+                {
+                    host = i;
+                }
+            }
+            std::memcpy(p, &host, sizeof(host));
+            p += sizeof(host);
+        }
+
+        return data;
+    }
+
+    static void decode(const char* p, std::size_t length, vm_allocation_t<RealT>& solution)
+    {
+        std::uint8_t status = 0;
+        double objective_value = 0;
+        std::uint32_t nfns = 0;
+        std::uint32_t nvms = 0;
+
+        const std::size_t head_length = sizeof(status)+sizeof(objective_value)+sizeof(nfns)+sizeof(nvms);
+
+        DCS_ASSERT(length >= head_length,
+                   DCS_EXCEPTION_THROW(std::runtime_error, "Corrupted VM allocation store"));
+
+        std::memcpy(&status, p, sizeof(status));
+        p += sizeof(status);
+        std::memcpy(&objective_value, p, sizeof(objective_value));
+        p += sizeof(objective_value);
+        std::memcpy(&nfns, p, sizeof(nfns));
+        p += sizeof(nfns);
+        std::memcpy(&nvms, p, sizeof(nvms));
+        p += sizeof(nvms);
+
+        DCS_ASSERT(length == head_length+nfns+nvms*sizeof(std::int32_t),
+                   DCS_EXCEPTION_THROW(std::runtime_error, "Corrupted VM allocation store"));
+
+        solution = vm_allocation_t<RealT>();
+        solution.solved = (status & 1) != 0;
+        solution.optimal = (status & 2) != 0;
+        solution.objective_value = objective_value;
+        solution.fn_power_states.resize(nfns);
+        solution.fn_vm_allocations.resize(nfns);
+        for (std::size_t i = 0; i < nfns; ++i)
+        {
+            solution.fn_power_states[i] = (*p++ != 0);
+            solution.fn_vm_allocations[i].resize(nvms, false);
+        }
+        for (std::size_t j = 0; j < nvms; ++j)
+        {
+            std::int32_t host = -1;
+            std::memcpy(&host, p, sizeof(host));
+            p += sizeof(host);
+
+            if (host >= 0 && static_cast<std::uint32_t>(host) < nfns)
+            {
+                solution.fn_vm_allocations[host][j] = true;
+            }
+        }
+    }
+
+    /// Finds the slot holding the given key or, if the key is not stored, the
+    /// empty slot where it would be stored (returns \c false if neither
+    /// exists, i.e., the store is full)
+    bool find_slot(const header_t& header, const key_type& key, std::size_t& slot_idx) const
+    {
+        auto const capacity = header.capacity;
+
+        DCS_ASSERT(map_size_ >= data_offset(capacity),
+                   DCS_EXCEPTION_THROW(std::runtime_error, "Corrupted VM allocation store"));
+
+        for (std::size_t k = 0; k < capacity; ++k)
+        {
+            auto const idx = (key.low+k) % capacity;
+            auto const slot = read_slot(idx);
+
+            if ((slot.key_high == key.high && slot.key_low == key.low)
+                || (slot.key_high == 0 && slot.key_low == 0))
+            {
+                slot_idx = idx;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    header_t read_header() const
+    {
+        header_t header;
+        std::memcpy(&header, p_map_, sizeof(header));
+        return header;
+    }
+
+    slot_t read_slot(std::size_t idx) const
+    {
+        slot_t slot;
+        std::memcpy(&slot, p_map_+sizeof(header_t)+idx*sizeof(slot_t), sizeof(slot));
+        return slot;
+    }
+
+    void write_slot(std::size_t idx, const slot_t& slot)
+    {
+        std::memcpy(p_map_+sizeof(header_t)+idx*sizeof(slot_t), &slot, sizeof(slot));
+    }
+
+    std::size_t file_size() const
+    {
+        struct stat st;
+
+        DCS_ASSERT(::fstat(fd_, &st) == 0,
+                   DCS_EXCEPTION_THROW(std::runtime_error, "Unable to get the size of the VM allocation store file"));
+
+        return st.st_size;
+    }
+
+    void resize_file(std::size_t size)
+    {
+        DCS_ASSERT(::ftruncate(fd_, size) == 0,
+                   DCS_EXCEPTION_THROW(std::runtime_error, "Unable to resize the VM allocation store file"));
+    }
+
+    /// Maps the whole file again if it has been grown (possibly by another process)
+    void remap()
+    {
+        auto const size = file_size();
+
+        if (size == map_size_)
+        {
+            return;
+        }
+
+        if (p_map_ != nullptr)
+        {
+            ::munmap(p_map_, map_size_);
+            p_map_ = nullptr;
+            map_size_ = 0;
+        }
+
+        void* p_map = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+
+        DCS_ASSERT(p_map != MAP_FAILED,
+                   DCS_EXCEPTION_THROW(std::runtime_error, "Unable to map the VM allocation store file"));
+
+        p_map_ = static_cast<char*>(p_map);
+        map_size_ = size;
+    }
+
+    void close()
+    {
+        if (p_map_ != nullptr)
+        {
+            ::munmap(p_map_, map_size_);
+            p_map_ = nullptr;
+            map_size_ = 0;
+        }
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+
+    std::string path_;
+    int fd_;
+    char* p_map_;
+    std::size_t map_size_;
+    std::size_t num_hits_;
+    std::size_t num_misses_;
+    mutable std::mutex mutex_; ///< Serializes the threads of this process (file locks do not)
+}; // vm_allocation_store_t
+
+}} // Namespace dcs::fgt
+
+
+#endif // DCS_FGT_VM_ALLOCATION_STORE_HPP
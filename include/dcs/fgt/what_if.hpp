@@ -0,0 +1,323 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file dcs/fgt/what_if.hpp
+ *
+ * \brief Evaluation of a proposed partition of FPs for a workload snapshot.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DCS_FGT_WHAT_IF_HPP
+#define DCS_FGT_WHAT_IF_HPP
+
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/fgt/coalition_formation/commons.hpp>
+#include <dcs/fgt/experiment.hpp>
+#include <dcs/fgt/random.hpp>
+#include <gtpack/cooperative.hpp>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace dcs { namespace fgt {
+
+/// Outcome of the evaluation of a proposed partition of FPs
+template <typename RealT>
+struct what_if_outcome_t
+{
+    std::vector<gtpack::cid_type> coalitions; ///< The coalitions of the partition, by CID
+    std::vector<RealT> coalition_values; ///< The value (i.e., the profit) of each coalition of the partition (-inf for infeasible coalitions)
+    RealT value = 0; ///< The value of the partition (i.e., the sum of the values of its coalitions)
+    std::vector<RealT> fp_payoffs; ///< The Shapley payoff that each FP gets in its coalition (NaN for infeasible coalitions), by FP
+    std::vector<RealT> fp_alone_profits; ///< The profit that each FP gets by running alone (NaN if infeasible), by FP
+    std::vector<gtpack::cid_type> fp_best_deviations; ///< The coalition among the ones the FP can join (or form alone) that gives it the highest payoff (the empty CID if none is feasible), by FP
+    std::vector<RealT> fp_best_deviation_payoffs; ///< The payoff of the FP in its best deviation, by FP
+    bool nash_stable = false; ///< Tells if the partition is Nash-stable
+    std::size_t num_valued_coalitions = 0; ///< The number of coalitions that have been valued
+    RealT elapsed_time = 0; ///< The time (in seconds) taken by the evaluation
+}; // what_if_outcome_t
+
+template <typename CharT, typename CharTraitsT, typename RealT>
+std::basic_ostream<CharT,CharTraitsT>& operator<<(std::basic_ostream<CharT,CharTraitsT>& os, const what_if_outcome_t<RealT>& outcome)
+{
+    auto const num_fps = outcome.fp_payoffs.size();
+
+    os << "- Partition: {";
+    for (std::size_t c = 0; c < outcome.coalitions.size(); ++c)
+    {
+        if (c > 0)
+        {
+            os << ", ";
+        }
+        os << "{";
+        bool first = true;
+        for (std::size_t fp = 0; fp < num_fps; ++fp)
+        {
+            if (outcome.coalitions[c] & gtpack::make_coalition_id(fp))
+            {
+                if (!first)
+                {
+                    os << ",";
+                }
+                os << fp;
+                first = false;
+            }
+        }
+        os << "} (CID=" << outcome.coalitions[c] << ", value: " << outcome.coalition_values[c] << ")";
+    }
+    os << "}" << std::endl;
+    os << "- Partition value: " << outcome.value << std::endl;
+    os << "- Nash-stable: " << (outcome.nash_stable ? "yes" : "no") << std::endl;
+    for (std::size_t fp = 0; fp < num_fps; ++fp)
+    {
+        os << "  * FP " << fp
+           << " - Coalition payoff: " << outcome.fp_payoffs[fp]
+           << ", Alone profit: " << outcome.fp_alone_profits[fp]
+           << ", Best deviation: CID=" << outcome.fp_best_deviations[fp] << " (payoff: " << outcome.fp_best_deviation_payoffs[fp] << ")" << std::endl;
+    }
+    os << "- Valued coalitions: " << outcome.num_valued_coalitions << std::endl;
+    os << "- Elapsed time: " << outcome.elapsed_time << "s";
+
+    return os;
+}
+
+
+/**
+ * Evaluates proposed partitions of the FPs of a scenario for a snapshot of
+ * the workload demand (i.e., the arrival rate of each service).
+ *
+ * Only the coalitions needed to answer the question are valued, namely the
+ * coalitions of the partition, each of them augmented with one other FP
+ * (i.e., the deviations checked by Nash stability) and the singletons, along
+ * with their sub-coalitions, which the Shapley value of a coalition depends
+ * on.
+ * With an FP topology, only the connected ones are valued (the others are
+ * valued as in the simulator, by means of their connected components).
+ *
+ * Coalitions are valued by the same code used by \c experiment_t (i.e., with
+ * the same VM allocation solver and persistent solution store, if any), and
+ * Nash stability is checked by the same selector.
+ * The evaluator can be reused for several partitions and snapshots.
+ */
+template <typename RealT>
+class what_if_evaluator_t
+{
+public:
+    what_if_evaluator_t(const scenario_t<RealT>& scenario, const options_t<RealT>& options)
+    : p_exp_(std::make_shared<experiment_t<RealT>>())
+    {
+        p_exp_->setup(scenario, options, rng_);
+
+        // No FN has been powered off
+        p_exp_->rep_fn_power_states_.assign(p_exp_->num_fns_, true);
+
+        for (auto const& coal_fps : p_exp_->feasible_coal_fps_)
+        {
+            feasible_cids_.insert(gtpack::make_coalition_id(coal_fps.begin(), coal_fps.end()));
+        }
+    }
+
+    /// Returns the number of services, which is also the number of arrival
+    /// rates of a snapshot (services are ordered by FP, and then by service
+    /// category)
+    std::size_t num_services() const
+    {
+        return p_exp_->num_svcs_;
+    }
+
+    /**
+     * Evaluates the given partition for the given arrival rate of each
+     * service, over an interval of the given duration.
+     *
+     * \param svc_arrival_rates The arrival rate of each service.
+     * \param partition The coalitions of the partition, each given as the
+     *  sequence of its FPs; FPs in no coalition run alone.
+     * \param duration The length of the interval coalition values refer to.
+     */
+    what_if_outcome_t<RealT> operator()(const std::vector<RealT>& svc_arrival_rates, const std::vector<std::vector<std::size_t>>& partition, RealT duration = 1)
+    {
+        namespace gt = gtpack;
+
+        auto const start_clock = std::chrono::steady_clock::now();
+
+        auto& exp = *p_exp_;
+        auto const num_fps = exp.scen_.num_fps;
+
+        DCS_ASSERT(svc_arrival_rates.size() == this->num_services(),
+                   DCS_EXCEPTION_THROW(std::invalid_argument, "Got " + stringify(svc_arrival_rates.size()) + " service arrival rates, but the scenario has " + stringify(this->num_services()) + " services"));
+
+        // Complete the partition with singletons and check it
+
+        std::vector<gt::cid_type> part_cids;
+        gt::cid_type covered_cid = gt::empty_cid;
+        for (auto const& coal_fps : partition)
+        {
+            DCS_ASSERT(!coal_fps.empty(),
+                       DCS_EXCEPTION_THROW(std::invalid_argument, "Empty coalition in partition"));
+
+            gt::cid_type cid = gt::empty_cid;
+            for (auto const fp : coal_fps)
+            {
+                DCS_ASSERT(fp < num_fps,
+                           DCS_EXCEPTION_THROW(std::invalid_argument, "Unknown FP " + stringify(fp) + " in partition"));
+                DCS_ASSERT(!(covered_cid & gt::make_coalition_id(fp)),
+                           DCS_EXCEPTION_THROW(std::invalid_argument, "FP " + stringify(fp) + " belongs to more than one coalition in partition"));
+
+                cid |= gt::make_coalition_id(fp);
+                covered_cid |= gt::make_coalition_id(fp);
+            }
+
+            DCS_ASSERT(feasible_cids_.count(cid) > 0,
+                       DCS_EXCEPTION_THROW(std::invalid_argument, "Coalition " + stringify(cid) + " cannot form in the FP topology"));
+
+            part_cids.push_back(cid);
+        }
+        for (std::size_t fp = 0; fp < num_fps; ++fp)
+        {
+            if (!(covered_cid & gt::make_coalition_id(fp)))
+            {
+                part_cids.push_back(gt::make_coalition_id(fp));
+            }
+        }
+        std::sort(part_cids.begin(), part_cids.end());
+
+        // Collect the coalitions to value: the ones of the partition, their
+        // one-FP augmentations and the singletons, and their sub-coalitions
+
+        std::set<gt::cid_type> target_cids(part_cids.begin(), part_cids.end());
+        for (auto const cid : part_cids)
+        {
+            for (std::size_t fp = 0; fp < num_fps; ++fp)
+            {
+                auto const fp_cid = gt::make_coalition_id(fp);
+
+                target_cids.insert(fp_cid);
+                if (!(cid & fp_cid))
+                {
+                    target_cids.insert(cid | fp_cid);
+                }
+            }
+        }
+        std::set<gt::cid_type> needed_cids;
+        for (auto const cid : target_cids)
+        {
+            for (gt::cid_type sub_cid = cid; sub_cid != gt::empty_cid; sub_cid = (sub_cid-1) & cid)
+            {
+                if (feasible_cids_.count(sub_cid) > 0)
+                {
+                    needed_cids.insert(sub_cid);
+                }
+            }
+        }
+        std::vector<std::vector<std::size_t>> needed_coal_fps;
+        for (auto const cid : needed_cids)
+        {
+            std::vector<std::size_t> coal_fps;
+            for (std::size_t fp = 0; fp < num_fps; ++fp)
+            {
+                if (cid & gt::make_coalition_id(fp))
+                {
+                    coal_fps.push_back(fp);
+                }
+            }
+            needed_coal_fps.push_back(coal_fps);
+        }
+
+        // Value the coalitions
+
+        auto const demand = exp.make_demand(svc_arrival_rates);
+
+        gt::cooperative_game<RealT> game(num_fps, boost::make_shared<gt::enumerated_characteristic_function<RealT>>());
+        std::map<gt::cid_type,coalition_info_t<RealT>> visited_coalitions;
+        std::vector<RealT> fp_alone_profits(num_fps, std::numeric_limits<RealT>::quiet_NaN());
+
+        exp.value_coalitions(demand,
+                             duration,
+                             needed_coal_fps,
+                             exp.opts_.optim_time_limit,
+                             false,
+                             false,
+                             game,
+                             visited_coalitions,
+                             fp_alone_profits);
+
+        // Collect the outcome
+
+        what_if_outcome_t<RealT> outcome;
+        outcome.coalitions = part_cids;
+        outcome.fp_payoffs.assign(num_fps, std::numeric_limits<RealT>::quiet_NaN());
+        outcome.fp_alone_profits = fp_alone_profits;
+        outcome.fp_best_deviations.assign(num_fps, gt::empty_cid);
+        outcome.fp_best_deviation_payoffs.assign(num_fps, -std::numeric_limits<RealT>::infinity());
+        for (auto const cid : part_cids)
+        {
+            auto const& coal_info = visited_coalitions.at(cid);
+            auto const coal_value = coal_info.vm_allocation.solved ? coal_info.value : -std::numeric_limits<RealT>::infinity();
+
+            outcome.coalition_values.push_back(coal_value);
+            outcome.value += coal_value;
+            for (auto const& payoff_info : coal_info.payoffs)
+            {
+                outcome.fp_payoffs[payoff_info.first] = payoff_info.second;
+            }
+
+            // Deviations of the FPs of other coalitions to this one
+            for (std::size_t fp = 0; fp < num_fps; ++fp)
+            {
+                auto const fp_cid = gt::make_coalition_id(fp);
+                auto const dev_cid = (cid & fp_cid) ? fp_cid : (cid | fp_cid);
+                auto const dev_it = visited_coalitions.find(dev_cid);
+
+                if (dev_it != visited_coalitions.end()
+                    && dev_it->second.payoffs.count(fp) > 0
+                    && dev_it->second.payoffs.at(fp) > outcome.fp_best_deviation_payoffs[fp])
+                {
+                    outcome.fp_best_deviations[fp] = dev_cid;
+                    outcome.fp_best_deviation_payoffs[fp] = dev_it->second.payoffs.at(fp);
+                }
+            }
+        }
+        outcome.nash_stable = exp.nash_selector_.check_nash_stability(game, visited_coalitions, part_cids.begin(), part_cids.end());
+        outcome.num_valued_coalitions = needed_coal_fps.size();
+        outcome.elapsed_time = std::chrono::duration<RealT>(std::chrono::steady_clock::now()-start_clock).count();
+
+        return outcome;
+    }
+
+private:
+    random_number_engine_t rng_;
+    std::shared_ptr<experiment_t<RealT>> p_exp_; ///< The experiment whose coalition valuation is reused
+    std::set<gtpack::cid_type> feasible_cids_; ///< The coalitions allowed by the FP topology (if any)
+}; // what_if_evaluator_t
+
+}} // Namespace dcs::fgt
+
+
+#endif // DCS_FGT_WHAT_IF_HPP
@@ -34,6 +34,7 @@
 #include <dcs/macro.hpp>
 #include <dcs/exception.hpp>
 #include <initializer_list>
+#include <memory>
 #include <stdexcept>
 #include <tuple>
 #include <vector>
@@ -48,6 +49,21 @@ struct workload_generator_t
     virtual ~workload_generator_t() { }
 
     virtual std::tuple<RealT,RealT> operator()(random_number_engine_t& rng) = 0;
+
+    /// Tells if the generated workload does not depend on the random number engine
+    virtual bool deterministic() const
+    {
+        return false;
+    }
+
+    /// Restarts the generated workload from the beginning
+    virtual void reset()
+    {
+    }
+
+    /// Returns a generator in the same state, which generates the same
+    /// workload independently of this one
+    virtual std::shared_ptr<workload_generator_t> clone() const = 0;
 }; // workload_generator_t
 
 
@@ -89,6 +105,21 @@ public:
         return std::make_tuple(duration, arr_rate);
     }
 
+    bool deterministic() const
+    {
+        return true;
+    }
+
+    void reset()
+    {
+        next_idx_ = 0;
+    }
+
+    std::shared_ptr<workload_generator_t<RealT>> clone() const
+    {
+        return std::make_shared<multistep_workload_generator_t>(*this);
+    }
+
 private:
     std::vector<RealT> durations_;
     std::vector<RealT> arr_rates_;
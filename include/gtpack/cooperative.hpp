@@ -26,6 +26,7 @@
 #define GTPACK_COOPERATIVE_HPP
 
 
+#include <algorithm>
 #include <boost/dynamic_bitset.hpp>
 #include <boost/math/special_functions/factorials.hpp>
 #include <boost/smart_ptr.hpp>
@@ -47,6 +48,7 @@
 #include <set>
 #include <sstream>
 #include <stdexcept>
+#include <vector>
 
 
 namespace gtpack {
@@ -662,6 +664,81 @@ template <typename RealT>
 	return sv_map;
 }
 
+/**
+ * \brief Update the Shapley value of all the players of a given game after
+ *  the value of some coalitions has changed.
+ *
+ * Since the Shapley value is linear in the characteristic function, changing
+ * the value of coalition \f$T \subseteq N\f$ by \f$\Delta_T\f$ changes the
+ * Shapley value \f$\phi_i\f$ of player \f$i\f$ by:
+ * \f[
+ *  \begin{cases}
+ *   \frac{(|T|-1)!\; (|N|-|T|)!}{|N|!}\Delta_T, & i \in T,\\
+ *   -\frac{|T|!\; (|N|-|T|-1)!}{|N|!}\Delta_T, & i \notin T,
+ *  \end{cases}
+ * \f]
+ * that is, by the weighted difference of the marginal contributions in which
+ * \f$T\f$ appears.
+ * Thus, only the changed coalitions are visited, instead of all the
+ * \f$2^{|N|}\f$ coalitions.
+ *
+ * \param game The game, whose characteristic function already holds the new
+ *  values (only its players are used).
+ * \param sv_map The Shapley value of the game before the change, which is
+ *  updated in place.
+ * \param first_delta Iterator to the beginning of the sequence of
+ *  <em>(cid, value difference)</em> pairs of the changed coalitions.
+ * \param last_delta Iterator to the end of the sequence of
+ *  <em>(cid, value difference)</em> pairs of the changed coalitions.
+ */
+template <typename RealT, typename IterT>
+void update_shapley_value(cooperative_game<RealT> const& game, ::std::map<pid_type,RealT>& sv_map, IterT first_delta, IterT last_delta)
+{
+	const ::std::size_t n(game.num_players());
+	const RealT n_fact(::boost::math::factorial<RealT>(n));
+
+	const ::std::vector<pid_type> players(game.players());
+	const cid_type players_cid = players_coalition<RealT>::make_id(players.begin(), players.end());
+
+	while (first_delta != last_delta)
+	{
+		const cid_type t_cid(first_delta->first);
+		const RealT delta(first_delta->second);
+
+		DCS_ASSERT(t_cid != empty_cid && (t_cid & ~players_cid) == empty_cid,
+				   DCS_EXCEPTION_THROW(::std::invalid_argument, "Changed coalition is not a coalition of the game"));
+
+		::std::size_t t(0);
+		for (cid_type c = t_cid; c != empty_cid; c &= c-1)
+		{
+			++t;
+		}
+
+		// Weight of T as the coalition joined by a member, and as the coalition joined by a non-member
+		const RealT in_weight(::boost::math::factorial<RealT>(t-1)*::boost::math::factorial<RealT>(n-t)/n_fact);
+		const RealT out_weight(t < n ? ::boost::math::factorial<RealT>(t)*::boost::math::factorial<RealT>(n-t-1)/n_fact : 0);
+
+		::std::vector<pid_type>::const_iterator players_end_it(players.end());
+		for (::std::vector<pid_type>::const_iterator players_it = players.begin();
+			 players_it != players_end_it;
+			 ++players_it)
+		{
+			const pid_type pid(*players_it);
+
+			if (t_cid & make_coalition_id(pid))
+			{
+				sv_map[pid] += in_weight*delta;
+			}
+			else
+			{
+				sv_map[pid] -= out_weight*delta;
+			}
+		}
+
+		++first_delta;
+	}
+}
+
 /**
  * \brief Compute the Banzhaf value for all the players of a given game.
  *
@@ -1145,6 +1222,165 @@ bool belongs_to_core(cooperative_game<RealT> const& game, IterT first_payoff, It
 	return true;
 }
 
+/// The outcome of the search of a coalition whose core constraint is violated
+template <typename RealT>
+struct core_separation_result
+{
+	core_separation_result()
+	: cid(empty_cid),
+	  excess(0),
+	  num_evaluations(0),
+	  num_prunings(0)
+	{
+	}
+
+
+	cid_type cid; ///< A coalition S such that x(S) < v(S), or \c empty_cid if there is none
+	RealT excess; ///< The excess v(S)-x(S) of \c cid
+	::std::size_t num_evaluations; ///< Number of coalition values evaluated by the search
+	::std::size_t num_prunings; ///< Number of subtrees pruned by the search
+}; // core_separation_result
+
+
+namespace detail {
+
+template <typename RealT, typename ValueT, typename BoundT>
+class core_separator
+{
+	public: core_separator(::std::vector<pid_type> const& players, ::std::map<pid_type,RealT> const& x, ValueT value, BoundT bound)
+	: players_(players),
+	  x_(x),
+	  value_(value),
+	  bound_(bound),
+	  rest_cids_(players.size()+1, empty_cid),
+	  rest_neg_payoffs_(players.size()+1, 0)
+	{
+		// Visit cheaper players first, since they are the most likely to
+		// form violating coalitions
+		::std::stable_sort(players_.begin(),
+						   players_.end(),
+						   [&](pid_type p1, pid_type p2) { return x_.at(p1) < x_.at(p2); });
+
+		for (::std::size_t k = players_.size(); k > 0; --k)
+		{
+			rest_cids_[k-1] = rest_cids_[k] | make_coalition_id(players_[k-1]);
+			rest_neg_payoffs_[k-1] = rest_neg_payoffs_[k] + ::std::min(x_.at(players_[k-1]), RealT(0));
+		}
+		grand_cid_ = rest_cids_[0];
+	}
+
+	public: core_separation_result<RealT> operator()()
+	{
+		res_ = core_separation_result<RealT>();
+
+		this->visit(0, empty_cid, 0, false);
+
+		return res_;
+	}
+
+	/// Visits the coalitions made of the players in \a cid plus any of the
+	/// players from the k-th on, and returns \c true if a violation is found
+	private: bool visit(::std::size_t k, cid_type cid, RealT xs, bool evaluate)
+	{
+		// The max excess of the coalitions in this subtree is at most the max
+		// value minus the min payment
+		const RealT max_excess = bound_(cid, cid | rest_cids_[k]) - xs - rest_neg_payoffs_[k];
+		if (max_excess <= 0)
+		{
+			++res_.num_prunings;
+			return false;
+		}
+
+		if (evaluate && cid != grand_cid_)
+		{
+			const RealT v = value_(cid);
+
+			++res_.num_evaluations;
+
+			if (!::dcs::math::float_traits<RealT>::essentially_greater_equal(xs, v))
+			{
+				res_.cid = cid;
+				res_.excess = v-xs;
+				return true;
+			}
+		}
+
+		if (k == players_.size())
+		{
+			return false;
+		}
+
+		const pid_type p = players_[k];
+
+		return this->visit(k+1, cid | make_coalition_id(p), xs+x_.at(p), true)
+			|| this->visit(k+1, cid, xs, false);
+	}
+
+
+	private: ::std::vector<pid_type> players_;
+	private: ::std::map<pid_type,RealT> const& x_;
+	private: ValueT value_;
+	private: BoundT bound_;
+	private: ::std::vector<cid_type> rest_cids_; ///< The coalition of the players from the k-th on, by k
+	private: ::std::vector<RealT> rest_neg_payoffs_; ///< The sum of the negative payoffs of the players from the k-th on, by k
+	private: cid_type grand_cid_;
+	private: core_separation_result<RealT> res_;
+}; // core_separator
+
+} // Namespace detail
+
+
+/**
+ * \brief Searches a coalition whose core constraint is violated by the given
+ *  payoffs.
+ *
+ * Solves the separation problem of the core for the payoffs \a x, that is
+ * looks for a coalition \f$S \subset N\f$ with a positive excess
+ * \f$e(S)=v(S)-x(S)\f$, without enumerating all the coalitions.
+ * Coalitions are visited by a depth-first branch and bound over the players,
+ * where every node fixes the players L in the coalition and the players U
+ * that may still join it.
+ * The subtree of a node is pruned when \f$\mathrm{bound}(L,U) - x(L) - \sum_{i \in U \setminus L} \min(x_i,0) \le 0\f$,
+ * where \c bound(L,U) is an upper bound of \f$v(S)\f$ for every coalition S
+ * with \f$L \subseteq S \subseteq U\f$ (or infinity, if none is known).
+ * Coalition values are evaluated lazily, by \c value(S), only at the nodes
+ * that are not pruned, and the search stops at the first violation.
+ *
+ * The grand coalition is not checked (see \c belongs_to_core_by_separation).
+ */
+template <typename RealT, typename ValueT, typename BoundT>
+core_separation_result<RealT> separate_core(::std::vector<pid_type> const& players, ::std::map<pid_type,RealT> const& x, ValueT value, BoundT bound)
+{
+	return detail::core_separator<RealT,ValueT,BoundT>(players, x, value, bound)();
+}
+
+/**
+ * \brief Tells if the given payoffs belong to the core of the given game,
+ *  by means of \c separate_core.
+ *
+ * \a bound(L,U) is an upper bound of the value of every coalition between L
+ * and U (see \c separate_core).
+ */
+template <typename RealT, typename IterT, typename BoundT>
+bool belongs_to_core_by_separation(cooperative_game<RealT> const& game, IterT first_payoff, IterT last_payoff, BoundT bound)
+{
+	const ::std::map<pid_type,RealT> x(first_payoff, last_payoff);
+	const ::std::vector<pid_type> players(game.players());
+
+	RealT xn(0);
+	for (pid_type player : players)
+	{
+		xn += x.at(player);
+	}
+	if (!::dcs::math::float_traits<RealT>::essentially_equal(xn, game.value(make_coalition_id(players.begin(), players.end()))))
+	{
+		return false;
+	}
+
+	return separate_core(players, x, [&game](cid_type cid) { return game.value(cid); }, bound).cid == empty_cid;
+}
+
+
 } // Namespace gtpack
 
 
@@ -39,6 +39,7 @@
 #include <exception>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -65,39 +66,85 @@ struct cli_options_t
 {
     cli_options_t()
     : help(false),
+      aggregate_models(false),
+      collapse_deterministic_replications(true),
       coalition_formation(fgt::nash_stable_coalition_formation),
-      coalition_formation_interval(0),
+      coalition_formation_intervals(1, 0),
+      coalition_formation_max_staleness(0),
+      coalition_formation_trigger(fgt::periodic_coalition_formation_trigger),
+      coalition_formation_trigger_vms_threshold(1),
       coalition_value_division(fgt::shapley_coalition_value_division),
+      compare_stability(false),
+      core_check(fgt::exhaustive_core_check),
       find_all_best_partitions(false),
+      frontier_cache(false),
+      incremental_models(false),
+      incremental_payoffs(false),
+      interval_budget(0),
+      interval_memo(false),
+      max_partition_blocks(0),
+      metrics_interval(fgt::metrics_exporter_t::default_interval),
+      num_threads(1),
       optim_relative_tolerance(0),
       optim_time_limit(-1),
+      precompute_values(false),
+      preference_cache_size(16),
+      search_best_partition(false),
       rng_seed(5489),
       service_delay_tolerance(1e-5),
+      solution_store_capacity(fgt::vm_allocation_store_t<double>::default_capacity),
       sim_ci_level(0.95),
       sim_ci_rel_precision(0.04),
       sim_max_num_replications(0),
       sim_max_replication_duration(0),
+      sim_num_logical_processes(0),
+      symmetry_reduction(false),
       verbosity(0)
     {
     }
 
 
     bool help;
+    bool aggregate_models; ///< A \c true value means that the VM allocation problems are modeled by classes of interchangeable FNs and by number of VMs per service
+    bool collapse_deterministic_replications; ///< A \c true value means that a single replication is run when no stochastic component is configured
     fgt::coalition_formation_category coalition_formation; ///< The strategy according which form coalitions
-    double coalition_formation_interval; ///< The time interval at which the coalition formation algorithm activates (in terms of simulated time)
+    std::vector<double> coalition_formation_intervals; ///< The time intervals at which the coalition formation algorithm activates (in terms of simulated time), one for each experiment
+    double coalition_formation_max_staleness; ///< The maximum time the outcome of a coalition formation can be reused (0 means 'unlimited')
+    fgt::coalition_formation_trigger_category coalition_formation_trigger; ///< The policy according which the coalition formation is performed at each activation
+    std::size_t coalition_formation_trigger_vms_threshold; ///< The minimum change in the number of VMs of a service that triggers the coalition formation
     fgt::coalition_value_division_category coalition_value_division;
+    bool compare_stability; ///< A \c true value means that the stable partitions of all stability notions are selected and compared
+    fgt::core_check_category core_check; ///< The way payoffs are checked to belong to the core
     bool find_all_best_partitions; ///< A \c true value means that all possible best partitions are computed
+    bool frontier_cache; ///< A \c true value means that the feasibility frontier of the VM allocation problems of coalitions is recorded and used to skip or bound their solution
+    std::string game_log_file; ///< The path to the game log where coalition values are recorded
+    bool incremental_models; ///< A \c true value means that the VM allocation models of the coalitions of an interval are composed from cached blocks
+    bool incremental_payoffs; ///< A \c true value means that each coalition formation only re-analyzes the coalitions of the FPs whose demand changed
+    double interval_budget; ///< The time budget (in seconds) of every coalition formation (0 means 'no budget')
+    bool interval_memo; ///< A \c true value means that the outcome of the coalition formation is memoized by service arrival rates
+    std::size_t max_partition_blocks; ///< The maximum number of coalitions in the partitions considered by the Nash stable formation (0 means 'no limit')
+    std::string metrics_file; ///< The path to the live metrics file
+    double metrics_interval; ///< The time (in seconds) between two consecutive writes of the metrics file
+    std::size_t num_threads; ///< Number of threads used to evaluate the coalition formation intervals of a replication (0 means 'number of hardware threads')
     double optim_relative_tolerance; ///< The relative tolerance option to set to the optimizer
     double optim_time_limit; ///< The time limit option to set to the optimizer
+    std::string output_quantile_data_file; ///< The path to the output file of the quantiles of interval profits
     std::string output_stats_data_file; ///< The path to the output stats data file
     std::string output_trace_data_file; ///< The path to the output trace data file
+    bool precompute_values; ///< A \c true value means that, with deterministic workloads, coalition values are precomputed for every demand state
+    std::size_t preference_cache_size; ///< Maximum number of preference profiles whose stable partitions are cached (0 disables caching)
+    bool search_best_partition; ///< A \c true value means that only the best Nash-stable partition is searched, by branch and bound, instead of enumerating every partition
     unsigned long rng_seed; ///< The seed used for random number generation
     std::string scenario_file; ///< The path to the input scenario file
     double service_delay_tolerance; ///< The relative tolerance to set in the service performance model
+    std::string solution_store_file; ///< The path to the persistent store of solved VM allocation problems
+    std::size_t solution_store_capacity; ///< Maximum number of solutions held by a newly created solution store
     double sim_ci_level; ///< Level for confidence intervals
     double sim_ci_rel_precision; ///< Relative precision for the half-width of the confidence intervals
     std::size_t sim_max_num_replications; ///< Maximum number of replications (0 means 'unlimited')
     double sim_max_replication_duration; ///< Length of each replication (in terms of simulated time)
+    std::size_t sim_num_logical_processes; ///< Number of logical processes the services are partitioned into (0 means 'sequential simulation')
+    bool symmetry_reduction; ///< A \c true value means that stable partitions are searched up to the symmetry among interchangeable FPs
     int verbosity; ///< The verbosity level: 0 for 'minimum' and 9 for 'maximum' verbosity level
 }; // cli_options_t
 
@@ -115,11 +162,57 @@ cli_options_t parse_cli_options(int argc, char* argv[])
     {
         opt.coalition_formation = fgt::nash_stable_coalition_formation;
     }
+    else if (opt_str == "individual")
+    {
+        opt.coalition_formation = fgt::individually_stable_coalition_formation;
+    }
+    else if (opt_str == "contractual-individual")
+    {
+        opt.coalition_formation = fgt::contractually_individually_stable_coalition_formation;
+    }
+    else if (opt_str == "core")
+    {
+        opt.coalition_formation = fgt::core_stable_coalition_formation;
+    }
     else
     {
         DCS_EXCEPTION_THROW(std::invalid_argument, "Unknown coalition formation category");
     }
-    opt.coalition_formation_interval = cli::simple::get_option<double>(argv, argv+argc, "--formation-interval", 0);
+    opt_str = cli::simple::get_option<std::string>(argv, argv+argc, "--formation-interval", "0");
+    opt.coalition_formation_intervals.clear();
+    {
+        std::istringstream iss(opt_str);
+        std::string item;
+        while (std::getline(iss, item, ','))
+        {
+            std::istringstream item_iss(item);
+            double interval = 0;
+            if (!(item_iss >> interval) || interval < 0)
+            {
+                DCS_EXCEPTION_THROW(std::invalid_argument, "Invalid coalition formation interval '" + item + "'");
+            }
+            opt.coalition_formation_intervals.push_back(interval);
+        }
+    }
+    if (opt.coalition_formation_intervals.empty())
+    {
+        DCS_EXCEPTION_THROW(std::invalid_argument, "Coalition formation interval not specified");
+    }
+    opt.coalition_formation_max_staleness = cli::simple::get_option<double>(argv, argv+argc, "--formation-max-staleness", 0);
+    opt_str = cli::simple::get_option<std::string>(argv, argv+argc, "--formation-trigger", "interval");
+    if (opt_str == "interval")
+    {
+        opt.coalition_formation_trigger = fgt::periodic_coalition_formation_trigger;
+    }
+    else if (opt_str == "demand")
+    {
+        opt.coalition_formation_trigger = fgt::demand_change_coalition_formation_trigger;
+    }
+    else
+    {
+        DCS_EXCEPTION_THROW(std::invalid_argument, "Unknown coalition formation trigger category");
+    }
+    opt.coalition_formation_trigger_vms_threshold = cli::simple::get_option<std::size_t>(argv, argv+argc, "--formation-trigger-vms-threshold", 1);
     opt_str = cli::simple::get_option<std::string>(argv, argv+argc, "--payoff", "shapley");
     if (opt_str == "shapley")
     {
@@ -129,18 +222,52 @@ cli_options_t parse_cli_options(int argc, char* argv[])
     {
         DCS_EXCEPTION_THROW(std::invalid_argument, "Unknown coalition value division category.");
     }
+    opt.compare_stability = cli::simple::get_option(argv, argv+argc, "--compare-stability");
+    opt_str = cli::simple::get_option<std::string>(argv, argv+argc, "--core-check", "exhaustive");
+    if (opt_str == "exhaustive")
+    {
+        opt.core_check = fgt::exhaustive_core_check;
+    }
+    else if (opt_str == "separation")
+    {
+        opt.core_check = fgt::separation_core_check;
+    }
+    else
+    {
+        DCS_EXCEPTION_THROW(std::invalid_argument, "Unknown core check category");
+    }
     opt.find_all_best_partitions = cli::simple::get_option(argv, argv+argc, "--find-all-parts");
+    opt.frontier_cache = cli::simple::get_option(argv, argv+argc, "--frontier-cache");
+    opt.game_log_file = cli::simple::get_option<std::string>(argv, argv+argc, "--game-log");
+    opt.aggregate_models = cli::simple::get_option(argv, argv+argc, "--aggregate-models");
+    opt.incremental_models = cli::simple::get_option(argv, argv+argc, "--incremental-models");
+    opt.incremental_payoffs = cli::simple::get_option(argv, argv+argc, "--incremental-payoffs");
+    opt.interval_budget = cli::simple::get_option<double>(argv, argv+argc, "--interval-budget", 0);
+    opt.interval_memo = cli::simple::get_option(argv, argv+argc, "--interval-memo");
+    opt.max_partition_blocks = cli::simple::get_option<std::size_t>(argv, argv+argc, "--max-partition-blocks", 0);
+    opt.metrics_file = cli::simple::get_option<std::string>(argv, argv+argc, "--metrics-file");
+    opt.metrics_interval = cli::simple::get_option<double>(argv, argv+argc, "--metrics-interval", fgt::metrics_exporter_t::default_interval);
+    opt.collapse_deterministic_replications = !cli::simple::get_option(argv, argv+argc, "--no-rep-collapse");
+    opt.num_threads = cli::simple::get_option<std::size_t>(argv, argv+argc, "--num-threads", 1);
     opt.optim_relative_tolerance = cli::simple::get_option<double>(argv, argv+argc, "--optim-reltol", 0);
     opt.optim_time_limit = cli::simple::get_option<double>(argv, argv+argc, "--optim-tilim", -1);
+    opt.output_quantile_data_file = cli::simple::get_option<std::string>(argv, argv+argc, "--out-quantile-file");
     opt.output_stats_data_file = cli::simple::get_option<std::string>(argv, argv+argc, "--out-stats-file");
     opt.output_trace_data_file = cli::simple::get_option<std::string>(argv, argv+argc, "--out-trace-file");
+    opt.precompute_values = cli::simple::get_option(argv, argv+argc, "--precompute-values");
+    opt.preference_cache_size = cli::simple::get_option<std::size_t>(argv, argv+argc, "--pref-cache-size", 16);
+    opt.search_best_partition = cli::simple::get_option(argv, argv+argc, "--search-best-part");
     opt.rng_seed = cli::simple::get_option<unsigned long>(argv, argv+argc, "--rng-seed", 5489);
     opt.scenario_file = cli::simple::get_option<std::string>(argv, argv+argc, "--scenario");
     opt.service_delay_tolerance = cli::simple::get_option<double>(argv, argv+argc, "--service-delay-tol", 1e-5);
+    opt.solution_store_file = cli::simple::get_option<std::string>(argv, argv+argc, "--solution-store");
+    opt.solution_store_capacity = cli::simple::get_option<std::size_t>(argv, argv+argc, "--solution-store-capacity", fgt::vm_allocation_store_t<double>::default_capacity);
     opt.sim_ci_level = cli::simple::get_option<double>(argv, argv+argc, "--ci-level", 0.95);
     opt.sim_ci_rel_precision = cli::simple::get_option<double>(argv, argv+argc, "--ci-rel-precision", 0.04);
     opt.sim_max_num_replications = cli::simple::get_option<std::size_t>(argv, argv+argc, "--sim-max-num-rep", 0);
     opt.sim_max_replication_duration = cli::simple::get_option<double>(argv, argv+argc, "--sim-max-rep-len", 0);
+    opt.sim_num_logical_processes = cli::simple::get_option<std::size_t>(argv, argv+argc, "--sim-num-lps", 0);
+    opt.symmetry_reduction = cli::simple::get_option(argv, argv+argc, "--sym-reduction");
     opt.verbosity = cli::simple::get_option<short>(argv, argv+argc, "--verbosity", 0);
     if (opt.verbosity < 0)
     {
@@ -152,6 +279,10 @@ cli_options_t parse_cli_options(int argc, char* argv[])
     }
 
     // Check CLI options
+    if (opt.metrics_interval <= 0)
+    {
+        DCS_EXCEPTION_THROW( std::invalid_argument, "Metrics interval must be positive" );
+    }
     if (opt.scenario_file.empty())
     {
         DCS_EXCEPTION_THROW( std::invalid_argument, "Scenario file not specified" );
@@ -164,20 +295,54 @@ template <typename CharT, typename CharTraitsT>
 std::basic_ostream<CharT,CharTraitsT>& operator<<(std::basic_ostream<CharT,CharTraitsT>& os, const cli_options_t& opts)
 {
     os  << "help: " << opts.help
+        << ", aggregate-models: " << opts.aggregate_models
+        << ", collapse-deterministic-replications: " << opts.collapse_deterministic_replications
         << ", coalition-formation: " << opts.coalition_formation
-        << ", coalition-formation-interval: " << opts.coalition_formation_interval
+        << ", coalition-formation-intervals: [";
+    for (std::size_t i = 0; i < opts.coalition_formation_intervals.size(); ++i)
+    {
+        if (i > 0)
+        {
+            os << ", ";
+        }
+        os << opts.coalition_formation_intervals[i];
+    }
+    os  << "]"
+        << ", coalition-formation-max-staleness: " << opts.coalition_formation_max_staleness
+        << ", coalition-formation-trigger: " << opts.coalition_formation_trigger
+        << ", coalition-formation-trigger-vms-threshold: " << opts.coalition_formation_trigger_vms_threshold
         << ", coalition-value-division: " << opts.coalition_value_division
+        << ", compare-stability: " << opts.compare_stability
+        << ", core-check: " << opts.core_check
+        << ", frontier-cache: " << opts.frontier_cache
+        << ", game-log-file: " << opts.game_log_file
+        << ", incremental-models: " << opts.incremental_models
+        << ", incremental-payoffs: " << opts.incremental_payoffs
+        << ", interval-budget: " << opts.interval_budget
+        << ", interval-memo: " << opts.interval_memo
+        << ", max-partition-blocks: " << opts.max_partition_blocks
+        << ", metrics-file: " << opts.metrics_file
+        << ", metrics-interval: " << opts.metrics_interval
+        << ", num-threads: " << opts.num_threads
         << ", optim-relative-tolerance: " << opts.optim_relative_tolerance
         << ", optim-time-limit: " << opts.optim_time_limit
+        << ", output-quantile-data-file: " << opts.output_quantile_data_file
         << ", output-stats-data-file: " << opts.output_stats_data_file
         << ", output-trace-data-file: " << opts.output_trace_data_file
+        << ", precompute-values: " << opts.precompute_values
+        << ", preference-cache-size: " << opts.preference_cache_size
+        << ", search-best-partition: " << opts.search_best_partition
         << ", random-generator-seed: " << opts.rng_seed
         << ", scenario-file: " << opts.scenario_file
         << ", sim-ci-level: " << opts.sim_ci_level
         << ", sim-ci-relative-precision: " << opts.sim_ci_rel_precision
         << ", sim-max-num-replications: " << opts.sim_max_num_replications
         << ", sim-max-replication-duration: " << opts.sim_max_replication_duration
+        << ", sim-num-logical-processes: " << opts.sim_num_logical_processes
         << ", service-delay-tolerance: " << opts.service_delay_tolerance
+        << ", solution-store-file: " << opts.solution_store_file
+        << ", solution-store-capacity: " << opts.solution_store_capacity
+        << ", symmetry-reduction: " << opts.symmetry_reduction
         << ", verbosity: " << opts.verbosity;
 
     return os;
@@ -191,17 +356,60 @@ void usage(char const* progname)
               << "  Show this message." << std::endl
               << "--service-delay-tol <num>" << std::endl
               << "  Real number in [0,1] denoting the relative tolerance for the delay used in the service performance model." << std::endl
+              << "--aggregate-models" << std::endl
+              << "  Model the VM allocation problem of every coalition by classes of interchangeable FNs (same FP, category and power state) and by number of VMs per service, instead of by single FNs and VMs, breaking the symmetry among the FNs of a class. The allocation of single VMs is only expanded when solutions are stored (see --solution-store). Takes precedence over --incremental-models." << std::endl
+              << "--compare-stability" << std::endl
+              << "  At every coalition formation, also select the partitions that are stable according to every other stability notion (in the same enumeration of partitions), and report how many there are by notion. The partitions of the notion given by --formation are the ones that form." << std::endl
+              << "--core-check {'exhaustive'|'separation'}" << std::endl
+              << "  How the payoffs of coalitions are checked to belong to the core, where:" << std::endl
+              << "  * 'exhaustive' computes the core and checks the payoffs against the values of all the sub-coalitions;" << std::endl
+              << "  * 'separation' searches a sub-coalition whose value exceeds the payoffs of its members, pruning the sub-coalitions that cannot exceed them according to the revenues of their FPs (the emptiness of the core is not determined)." << std::endl
               << "--find-all-parts" << std::endl
               << "  For each time interval, find all possible stable partitions." << std::endl
-              << "--formation {'nash'}" << std::endl
+              << "--formation {'nash'|'individual'|'contractual-individual'|'core'}" << std::endl
               << "  Coalition formation category, where:" << std::endl
               << "  * 'nash' refers to the Nash-stable coalition formation;" << std::endl
-              << "--formation-interval <num>" << std::endl
-              << "  Real number >= 0 denoting the activating time interval of the coalition formation algorithm." << std::endl
+              << "  * 'individual' refers to the individually stable coalition formation;" << std::endl
+              << "  * 'contractual-individual' refers to the contractually individually stable coalition formation;" << std::endl
+              << "  * 'core' refers to the core-stable coalition formation (i.e., no coalition is strictly preferred by all its members)." << std::endl
+              << "--frontier-cache" << std::endl
+              << "  For every coalition, record the demands (arrival rates of its services) whose VM allocation problem has been proven infeasible or solved. The problems with a demand higher than an infeasible one are not solved, and the others are solved with the bounds of the optimal cost implied by the recorded demands (and solved again without them if no solution is found within them)." << std::endl
+              << "--formation-interval <num>[,<num>...]" << std::endl
+              << "  Comma-separated list of real numbers >= 0 denoting the activating time interval of the coalition formation algorithm. With several intervals, an experiment is run for each of them on the same workload, and the coalition formations (and precomputed coalition values) are shared by the intervals with the same service arrival rates (i.e., --interval-memo is implied); output, metrics and game log files get the interval as suffix." << std::endl
+              << "--formation-max-staleness <num>" << std::endl
+              << "  Real number >= 0 denoting the maximum time the outcome of a coalition formation can be reused by the 'demand' trigger. Use 0 for no limit." << std::endl
+              << "--formation-trigger {'interval','demand'}" << std::endl
+              << "  Coalition formation trigger policy, where:" << std::endl
+              << "  * 'interval' refers to forming coalitions at every activation;" << std::endl
+              << "  * 'demand' refers to forming coalitions only when the number of VMs needed by some service has changed since the last formation, and to reuse the last formation otherwise." << std::endl
+              << "--formation-trigger-vms-threshold <num>" << std::endl
+              << "  Integer number >= 1 denoting the minimum change in the number of VMs of a service that makes the 'demand' trigger to form coalitions." << std::endl
+              << "--game-log <file>" << std::endl
+              << "  The binary file where the coalition values of every interval are recorded, so that they can be re-analyzed under other payoff and formation rules by fog_game_replay." << std::endl
+              << "--incremental-models" << std::endl
+              << "  Within a coalition formation, build the variables of every FN and FN-VM pair and the constraint terms of every pair of FPs once, and compose the VM allocation model of every coalition from the model of the coalition without its last FP. The model blocks are kept in memory until the coalition formation ends." << std::endl
+              << "--incremental-payoffs" << std::endl
+              << "  Within a replication, update the previous coalition formation: the coalitions whose FPs have the same service demand are not solved again, the Shapley values of the others are updated by the value changes of their sub-coalitions only, and the core is checked again only when some of these values changed. Only used when intervals are evaluated sequentially (i.e., with --num-threads 1)." << std::endl
+              << "--interval-budget <num>" << std::endl
+              << "  Real number >= 0 denoting the time budget (in seconds) of every coalition formation. When positive, the formation strategy (exhaustive or symmetric, the latter only with --sym-reduction) and the valuation strategy (exact or time-limited) predicted to fit the budget are chosen at every formation, from the number of partitions and coalitions and from the solver timings observed so far. Use 0 to always use the configured strategies." << std::endl
+              << "--interval-memo" << std::endl
+              << "  Memoize the outcome of the coalition formation by service arrival rates, and reuse it for the intervals (of any replication) with the same arrival rates." << std::endl
+              << "--max-partition-blocks <num>" << std::endl
+              << "  Integer number >= 0 denoting the maximum number of coalitions in the partitions considered by the Nash stable formation, which are then enumerated by number of coalitions. Use 0 for no limit. Ignored with --compare-stability and with --sym-reduction." << std::endl
+              << "--metrics-file <file>" << std::endl
+              << "  The file where live metrics (simulated time, completed replications, interval and solver call rates, cache hit ratios, confidence interval precisions and estimated time to completion) are periodically written in the Prometheus text format." << std::endl
+              << "--metrics-interval <num>" << std::endl
+              << "  Real number > 0 denoting the time (in seconds) between two consecutive writes of the metrics file." << std::endl
+              << "--no-rep-collapse" << std::endl
+              << "  Replicate the simulation until the wanted precision is reached even when no stochastic component is configured (by default, a single replication is run and exact values are reported)." << std::endl
+              << "--num-threads <num>" << std::endl
+              << "  Integer number >= 0 denoting the number of threads used to evaluate the coalition formation intervals. With a value other than 1, the service demand of every interval is derived while simulating the replication, and all intervals are evaluated in parallel at the end of the replication. Use 0 for the number of hardware threads." << std::endl
               << "--optim-reltol <num>" << std::endl
               << "  Real number in [0,1] denoting the relative tolerance parameter in the optimizer." << std::endl
               << "--optim-tilim <num>" << std::endl
               << "  Real positive number denoting the maximum number of seconds to wait for the termination of the optimizer." << std::endl
+              << "--out-quantile-file <file>" << std::endl
+              << "  The output file where writing, by FP, the 5th, 50th and 95th percentiles of the coalition and alone profits of formation intervals." << std::endl
               << "--output-stats-file <file>" << std::endl
               << "  The output file where writing statistics." << std::endl
               << "--output-trace-file <file>" << std::endl
@@ -209,6 +417,12 @@ void usage(char const* progname)
               << "--payoff {'shapley'}" << std::endl
               << "  Payoff division category, where:" << std::endl
               << "  * 'shapley' refers to the Shapley value." << std::endl
+              << "--precompute-values" << std::endl
+              << "  With deterministic workloads, solve the VM allocation of every coalition before the simulation (in parallel, according to --num-threads) for every combination of the arrival rates in the workload step tables of its services, so that coalition formations only look coalition values up. Combined with --solution-store, the precomputed solutions are reused by later runs." << std::endl
+              << "--pref-cache-size <num>" << std::endl
+              << "  Integer number >= 0 denoting the maximum number of preference profiles whose stable partitions are cached across intervals. Use 0 to disable caching." << std::endl
+              << "--search-best-part" << std::endl
+              << "  With the Nash stable formation, search only the best stable partition by branch and bound over the best partitions of subsets of FPs, instead of enumerating every partition. Ignored together with '--find-all-parts', and with more than 16 FPs." << std::endl
               << "--rng-seed <num>" << std::endl
               << "  Set the seed to use for random number generation." << std::endl
               << "--scenario <file>" << std::endl
@@ -221,22 +435,76 @@ void usage(char const* progname)
               << "  Real number >= 0 denoting the maximum duration of each independent replication." << std::endl
               << "--sim-max-num-rep <num>" << std::endl
               << "  Integer number >= 0 denoting the maximum number of independent replications. Use 0 for an unlimited number of replications." << std::endl
+              << "--sim-num-lps <num>" << std::endl
+              << "  Integer number >= 0 denoting the number of logical processes the services are partitioned into. Each logical process has its own event queue, random number stream and workload generators, and is advanced up to the next coalition formation trigger in parallel with the others (on the threads given by --num-threads). Results depend on the number of logical processes but not on the number of threads. Use 0 to simulate all services sequentially." << std::endl
+              << "--solution-store <file>" << std::endl
+              << "  The memory-mapped file where VM allocation problems solved to optimality are stored, so that later runs (or concurrent runs on the same host) skip them." << std::endl
+              << "--solution-store-capacity <num>" << std::endl
+              << "  Integer number > 0 denoting the maximum number of solutions held by the solution store (only used when the store file is created)." << std::endl
+              << "--sym-reduction" << std::endl
+              << "  Search stable partitions up to the symmetry among interchangeable FPs (i.e., FPs with the same parameters and workload), checking one partition per orbit." << std::endl
               << "--verbosity <num>" << std::endl
               << "  An integer number in [0,9] representing the verbosity level (0 for 'minimum verbosity' and 9 for 'maximum verbosity)." << std::endl
               << std::endl;
 }
 
+/// Returns the given path with the given coalition formation interval
+/// appended to the file name (before the extension, if any)
+std::string interval_file_path(const std::string& path, double interval)
+{
+    if (path.empty())
+    {
+        return path;
+    }
+
+    std::ostringstream oss;
+    oss << "-" << interval;
+
+    auto const dot_pos = path.find_last_of('.');
+    auto const sep_pos = path.find_last_of('/');
+    if (dot_pos == std::string::npos || (sep_pos != std::string::npos && dot_pos < sep_pos))
+    {
+        return path + oss.str();
+    }
+
+    return path.substr(0, dot_pos) + oss.str() + path.substr(dot_pos);
+}
+
 template <typename RealT, typename RNGT>
-void run_experiment(const fgt::scenario_t<RealT>& scen, const fgt::options_t<RealT>& opts, RNGT& rng)
+void run_experiment(const fgt::scenario_t<RealT>& scen, const fgt::options_t<RealT>& opts, const std::vector<RealT>& intervals, RNGT& rng)
 {
     boost::timer timer;
 
     std::cout << "- Scenario: " << scen << std::endl;
-    std::cout << "- Options: " << opts << std::endl;
 
-    fgt::experiment_t<RealT> exp;
-    exp.setup(scen, opts, rng);
-    exp.run();
+    // Experiments with different intervals see the same workload (they all
+    // start from the same state of the random number engine) and share the
+    // coalition formations of the intervals with the same arrival rates
+    const RNGT rng0 = rng;
+    std::shared_ptr<typename fgt::experiment_t<RealT>::formation_cache_t> p_formation_cache;
+    for (auto const interval : intervals)
+    {
+        fgt::options_t<RealT> interval_opts = opts;
+        interval_opts.coalition_formation_interval = interval;
+        if (intervals.size() > 1)
+        {
+            interval_opts.interval_memo = true;
+            interval_opts.game_log_file = interval_file_path(opts.game_log_file, interval);
+            interval_opts.metrics_file = interval_file_path(opts.metrics_file, interval);
+            interval_opts.output_quantile_data_file = interval_file_path(opts.output_quantile_data_file, interval);
+            interval_opts.output_stats_data_file = interval_file_path(opts.output_stats_data_file, interval);
+            interval_opts.output_trace_data_file = interval_file_path(opts.output_trace_data_file, interval);
+        }
+
+        std::cout << "- Options: " << interval_opts << std::endl;
+
+        rng = rng0;
+
+        fgt::experiment_t<RealT> exp;
+        exp.setup(scen, interval_opts, rng, p_formation_cache);
+        p_formation_cache = exp.formation_cache();
+        exp.run();
+    }
 }
 
 }} // Namespace <unnamed>::detail
@@ -266,16 +534,40 @@ int main(int argc, char* argv[])
         options.optim_relative_tolerance = cli_opts.optim_relative_tolerance;
         options.optim_time_limit = cli_opts.optim_time_limit;
         options.coalition_formation = cli_opts.coalition_formation;
-        options.coalition_formation_interval = cli_opts.coalition_formation_interval;
+        options.coalition_formation_max_staleness = cli_opts.coalition_formation_max_staleness;
+        options.coalition_formation_trigger = cli_opts.coalition_formation_trigger;
+        options.coalition_formation_trigger_vms_threshold = cli_opts.coalition_formation_trigger_vms_threshold;
         options.coalition_value_division = cli_opts.coalition_value_division;
+        options.compare_stability = cli_opts.compare_stability;
+        options.core_check = cli_opts.core_check;
         options.find_all_best_partitions = cli_opts.find_all_best_partitions;
+        options.frontier_cache = cli_opts.frontier_cache;
+        options.game_log_file = cli_opts.game_log_file;
+        options.aggregate_models = cli_opts.aggregate_models;
+        options.incremental_models = cli_opts.incremental_models;
+        options.incremental_payoffs = cli_opts.incremental_payoffs;
+        options.interval_budget = cli_opts.interval_budget;
+        options.interval_memo = cli_opts.interval_memo;
+        options.max_partition_blocks = cli_opts.max_partition_blocks;
+        options.metrics_file = cli_opts.metrics_file;
+        options.metrics_interval = cli_opts.metrics_interval;
+        options.collapse_deterministic_replications = cli_opts.collapse_deterministic_replications;
+        options.num_threads = cli_opts.num_threads;
+        options.output_quantile_data_file = cli_opts.output_quantile_data_file;
         options.output_stats_data_file = cli_opts.output_stats_data_file;
         options.output_trace_data_file = cli_opts.output_trace_data_file;
+        options.precompute_values = cli_opts.precompute_values;
+        options.preference_cache_size = cli_opts.preference_cache_size;
+        options.search_best_partition = cli_opts.search_best_partition;
         options.service_delay_tolerance = cli_opts.service_delay_tolerance;
         options.sim_ci_level = cli_opts.sim_ci_level;
         options.sim_ci_rel_precision = cli_opts.sim_ci_rel_precision;
         options.sim_max_num_replications = cli_opts.sim_max_num_replications;
         options.sim_max_replication_duration = cli_opts.sim_max_replication_duration;
+        options.sim_num_logical_processes = cli_opts.sim_num_logical_processes;
+        options.solution_store_file = cli_opts.solution_store_file;
+        options.solution_store_capacity = cli_opts.solution_store_capacity;
+        options.symmetry_reduction = cli_opts.symmetry_reduction;
         options.verbosity = cli_opts.verbosity;
 
         //std::default_random_engine rng(cli_opts.rng_seed);
@@ -285,7 +577,7 @@ int main(int argc, char* argv[])
         DCS_DEBUG_TRACE("Run the experiment...");//XXX
 //FIXME
 //options.coalition_formation_trigger_interval = 4*60; // Coalition formation every 4h
-        detail::run_experiment(scenario, options, rng);
+        detail::run_experiment(scenario, options, cli_opts.coalition_formation_intervals, rng);
     }
     catch (const std::invalid_argument& ia)
     {
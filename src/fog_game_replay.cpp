@@ -0,0 +1,353 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/fog_game_replay.cpp
+ *
+ * \brief Re-analyze the coalition formation of a recorded simulation under
+ *  other payoff and formation rules.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/cli.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/fgt/coalition_formation.hpp>
+#include <dcs/fgt/experiment.hpp>
+#include <dcs/logging.hpp>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+
+namespace cli = dcs::cli;
+namespace fgt = dcs::fgt;
+
+
+namespace /*<unnamed>*/ { namespace detail {
+
+class cli_options_t;
+
+template <typename CharT, typename CharTraitsT>
+std::basic_ostream<CharT,CharTraitsT>& operator<<(std::basic_ostream<CharT,CharTraitsT>& os, const cli_options_t& opts);
+
+void usage(char const* progname);
+
+
+struct cli_options_t
+{
+    cli_options_t()
+    : help(false),
+      collapse_deterministic_replications(true),
+      coalition_formation(fgt::nash_stable_coalition_formation),
+      coalition_value_division(fgt::shapley_coalition_value_division),
+      compare_stability(false),
+      core_check(fgt::exhaustive_core_check),
+      find_all_best_partitions(false),
+      max_partition_blocks(0),
+      metrics_interval(fgt::metrics_exporter_t::default_interval),
+      preference_cache_size(16),
+      search_best_partition(false),
+      sim_ci_level(0.95),
+      sim_ci_rel_precision(0.04),
+      sim_max_num_replications(0),
+      symmetry_reduction(false),
+      verbosity(0)
+    {
+    }
+
+
+    bool help;
+    bool collapse_deterministic_replications; ///< A \c true value means that exact values are reported when no stochastic component is configured
+    fgt::coalition_formation_category coalition_formation; ///< The strategy according which form coalitions
+    fgt::coalition_value_division_category coalition_value_division;
+    bool compare_stability; ///< A \c true value means that the stable partitions of all stability notions are selected and compared
+    fgt::core_check_category core_check; ///< The way payoffs are checked to belong to the core
+    bool find_all_best_partitions; ///< A \c true value means that all possible best partitions are computed
+    std::string game_log_file; ///< The path to the game log to replay
+    std::size_t max_partition_blocks; ///< The maximum number of coalitions in the partitions considered by the Nash stable formation (0 means 'no limit')
+    std::string metrics_file; ///< The path to the live metrics file
+    double metrics_interval; ///< The time (in seconds) between two consecutive writes of the metrics file
+    std::string output_quantile_data_file; ///< The path to the output file of the quantiles of interval profits
+    std::string output_stats_data_file; ///< The path to the output stats data file
+    std::string output_trace_data_file; ///< The path to the output trace data file
+    std::size_t preference_cache_size; ///< Maximum number of preference profiles whose stable partitions are cached (0 disables caching)
+    bool search_best_partition; ///< A \c true value means that only the best Nash-stable partition is searched, by branch and bound, instead of enumerating every partition
+    std::string scenario_file; ///< The path to the input scenario file
+    double sim_ci_level; ///< Level for confidence intervals
+    double sim_ci_rel_precision; ///< Relative precision for the half-width of the confidence intervals
+    std::size_t sim_max_num_replications; ///< Maximum number of replications (0 means 'all the recorded ones')
+    bool symmetry_reduction; ///< A \c true value means that stable partitions are searched up to the symmetry among interchangeable FPs
+    int verbosity; ///< The verbosity level: 0 for 'minimum' and 9 for 'maximum' verbosity level
+}; // cli_options_t
+
+
+cli_options_t parse_cli_options(int argc, char* argv[])
+{
+    std::string opt_str;
+    cli_options_t opt;
+
+    opt.help = cli::simple::get_option(argv, argv+argc, "--help");
+    if (opt.help)
+    {
+        return opt;
+    }
+    opt_str = cli::simple::get_option<std::string>(argv, argv+argc, "--formation", "nash");
+    if (opt_str == "nash")
+    {
+        opt.coalition_formation = fgt::nash_stable_coalition_formation;
+    }
+    else if (opt_str == "individual")
+    {
+        opt.coalition_formation = fgt::individually_stable_coalition_formation;
+    }
+    else if (opt_str == "contractual-individual")
+    {
+        opt.coalition_formation = fgt::contractually_individually_stable_coalition_formation;
+    }
+    else if (opt_str == "core")
+    {
+        opt.coalition_formation = fgt::core_stable_coalition_formation;
+    }
+    else
+    {
+        DCS_EXCEPTION_THROW(std::invalid_argument, "Unknown coalition formation category");
+    }
+    opt_str = cli::simple::get_option<std::string>(argv, argv+argc, "--payoff", "shapley");
+    if (opt_str == "shapley")
+    {
+        opt.coalition_value_division = fgt::shapley_coalition_value_division;
+    }
+    else
+    {
+        DCS_EXCEPTION_THROW(std::invalid_argument, "Unknown coalition value division category.");
+    }
+    opt.compare_stability = cli::simple::get_option(argv, argv+argc, "--compare-stability");
+    opt_str = cli::simple::get_option<std::string>(argv, argv+argc, "--core-check", "exhaustive");
+    if (opt_str == "exhaustive")
+    {
+        opt.core_check = fgt::exhaustive_core_check;
+    }
+    else if (opt_str == "separation")
+    {
+        opt.core_check = fgt::separation_core_check;
+    }
+    else
+    {
+        DCS_EXCEPTION_THROW(std::invalid_argument, "Unknown core check category");
+    }
+    opt.find_all_best_partitions = cli::simple::get_option(argv, argv+argc, "--find-all-parts");
+    opt.game_log_file = cli::simple::get_option<std::string>(argv, argv+argc, "--game-log");
+    opt.max_partition_blocks = cli::simple::get_option<std::size_t>(argv, argv+argc, "--max-partition-blocks", 0);
+    opt.metrics_file = cli::simple::get_option<std::string>(argv, argv+argc, "--metrics-file");
+    opt.metrics_interval = cli::simple::get_option<double>(argv, argv+argc, "--metrics-interval", fgt::metrics_exporter_t::default_interval);
+    opt.collapse_deterministic_replications = !cli::simple::get_option(argv, argv+argc, "--no-rep-collapse");
+    opt.output_quantile_data_file = cli::simple::get_option<std::string>(argv, argv+argc, "--out-quantile-file");
+    opt.output_stats_data_file = cli::simple::get_option<std::string>(argv, argv+argc, "--out-stats-file");
+    opt.output_trace_data_file = cli::simple::get_option<std::string>(argv, argv+argc, "--out-trace-file");
+    opt.preference_cache_size = cli::simple::get_option<std::size_t>(argv, argv+argc, "--pref-cache-size", 16);
+    opt.search_best_partition = cli::simple::get_option(argv, argv+argc, "--search-best-part");
+    opt.scenario_file = cli::simple::get_option<std::string>(argv, argv+argc, "--scenario");
+    opt.sim_ci_level = cli::simple::get_option<double>(argv, argv+argc, "--ci-level", 0.95);
+    opt.sim_ci_rel_precision = cli::simple::get_option<double>(argv, argv+argc, "--ci-rel-precision", 0.04);
+    opt.sim_max_num_replications = cli::simple::get_option<std::size_t>(argv, argv+argc, "--sim-max-num-rep", 0);
+    opt.symmetry_reduction = cli::simple::get_option(argv, argv+argc, "--sym-reduction");
+    opt.verbosity = cli::simple::get_option<short>(argv, argv+argc, "--verbosity", 0);
+    if (opt.verbosity < 0)
+    {
+        opt.verbosity = 0;
+    }
+    else if (opt.verbosity > 9)
+    {
+        opt.verbosity = 9;
+    }
+
+    // Check CLI options
+    if (opt.metrics_interval <= 0)
+    {
+        DCS_EXCEPTION_THROW( std::invalid_argument, "Metrics interval must be positive" );
+    }
+    if (opt.scenario_file.empty())
+    {
+        DCS_EXCEPTION_THROW( std::invalid_argument, "Scenario file not specified" );
+    }
+    if (opt.game_log_file.empty())
+    {
+        DCS_EXCEPTION_THROW( std::invalid_argument, "Game log file not specified" );
+    }
+
+    return opt;
+}
+
+template <typename CharT, typename CharTraitsT>
+std::basic_ostream<CharT,CharTraitsT>& operator<<(std::basic_ostream<CharT,CharTraitsT>& os, const cli_options_t& opts)
+{
+    os  << "help: " << opts.help
+        << ", collapse-deterministic-replications: " << opts.collapse_deterministic_replications
+        << ", coalition-formation: " << opts.coalition_formation
+        << ", coalition-value-division: " << opts.coalition_value_division
+        << ", compare-stability: " << opts.compare_stability
+        << ", core-check: " << opts.core_check
+        << ", find-all-best-partitions: " << opts.find_all_best_partitions
+        << ", game-log-file: " << opts.game_log_file
+        << ", max-partition-blocks: " << opts.max_partition_blocks
+        << ", metrics-file: " << opts.metrics_file
+        << ", metrics-interval: " << opts.metrics_interval
+        << ", output-quantile-data-file: " << opts.output_quantile_data_file
+        << ", output-stats-data-file: " << opts.output_stats_data_file
+        << ", output-trace-data-file: " << opts.output_trace_data_file
+        << ", preference-cache-size: " << opts.preference_cache_size
+        << ", search-best-partition: " << opts.search_best_partition
+        << ", scenario-file: " << opts.scenario_file
+        << ", sim-ci-level: " << opts.sim_ci_level
+        << ", sim-ci-relative-precision: " << opts.sim_ci_rel_precision
+        << ", sim-max-num-replications: " << opts.sim_max_num_replications
+        << ", symmetry-reduction: " << opts.symmetry_reduction
+        << ", verbosity: " << opts.verbosity;
+
+    return os;
+}
+
+void usage(char const* progname)
+{
+    std::cerr << "Usage: " << progname << " [options]" << std::endl
+              << "Options:" << std::endl
+              << "--help" << std::endl
+              << "  Show this message." << std::endl
+              << "--ci-level <num>" << std::endl
+              << "  Level for the confidence intervals (must be a number in [0,1])." << std::endl
+              << "--ci-rel-precision <num>" << std::endl
+              << "  Relative precision for the half-width of the confidence intervals (must be a number in [0,1])." << std::endl
+              << "--compare-stability" << std::endl
+              << "  At every coalition formation, also select the partitions that are stable according to every other stability notion (in the same enumeration of partitions), and report how many there are by notion. The partitions of the notion given by --formation are the ones that form." << std::endl
+              << "--core-check {'exhaustive'|'separation'}" << std::endl
+              << "  How the payoffs of coalitions are checked to belong to the core, where:" << std::endl
+              << "  * 'exhaustive' computes the core and checks the payoffs against the values of all the sub-coalitions;" << std::endl
+              << "  * 'separation' searches a sub-coalition whose value exceeds the payoffs of its members, pruning the sub-coalitions that cannot exceed them according to the revenues of their FPs (the emptiness of the core is not determined)." << std::endl
+              << "--find-all-parts" << std::endl
+              << "  For each time interval, find all possible stable partitions." << std::endl
+              << "--formation {'nash'|'individual'|'contractual-individual'|'core'}" << std::endl
+              << "  Coalition formation category, where:" << std::endl
+              << "  * 'nash' refers to the Nash-stable coalition formation;" << std::endl
+              << "  * 'individual' refers to the individually stable coalition formation;" << std::endl
+              << "  * 'contractual-individual' refers to the contractually individually stable coalition formation;" << std::endl
+              << "  * 'core' refers to the core-stable coalition formation (i.e., no coalition is strictly preferred by all its members)." << std::endl
+              << "--game-log <file>" << std::endl
+              << "  The game log (as recorded by fog_coalform --game-log) whose intervals are replayed." << std::endl
+              << "--max-partition-blocks <num>" << std::endl
+              << "  Integer number >= 0 denoting the maximum number of coalitions in the partitions considered by the Nash stable formation, which are then enumerated by number of coalitions. Use 0 for no limit. Ignored with --compare-stability and with --sym-reduction." << std::endl
+              << "--metrics-file <file>" << std::endl
+              << "  The file where live metrics (simulated time, completed replications, interval and solver call rates, cache hit ratios, confidence interval precisions and estimated time to completion) are periodically written in the Prometheus text format." << std::endl
+              << "--metrics-interval <num>" << std::endl
+              << "  Real number > 0 denoting the time (in seconds) between two consecutive writes of the metrics file." << std::endl
+              << "--no-rep-collapse" << std::endl
+              << "  Estimate confidence intervals even when no stochastic component is configured (by default, exact values are reported)." << std::endl
+              << "--out-quantile-file <file>" << std::endl
+              << "  The output file where writing, by FP, the 5th, 50th and 95th percentiles of the coalition and alone profits of formation intervals." << std::endl
+              << "--out-stats-file <file>" << std::endl
+              << "  The output file where writing statistics." << std::endl
+              << "--out-trace-file <file>" << std::endl
+              << "  The output file where writing run-trace information." << std::endl
+              << "--payoff {'shapley'}" << std::endl
+              << "  Payoff division category, where:" << std::endl
+              << "  * 'shapley' refers to the Shapley value." << std::endl
+              << "--pref-cache-size <num>" << std::endl
+              << "  Integer number >= 0 denoting the maximum number of preference profiles whose stable partitions are cached across intervals. Use 0 to disable caching." << std::endl
+              << "--search-best-part" << std::endl
+              << "  With the Nash stable formation, search only the best stable partition by branch and bound over the best partitions of subsets of FPs, instead of enumerating every partition. Ignored together with '--find-all-parts', and with more than 16 FPs." << std::endl
+              << "--scenario <file>" << std::endl
+              << "  The path to the file describing the scenario the game log has been recorded for." << std::endl
+              << "--sim-max-num-rep <num>" << std::endl
+              << "  Integer number >= 0 denoting the maximum number of recorded replications to replay. Use 0 to replay them until the wanted precision is reached or the log ends." << std::endl
+              << "--sym-reduction" << std::endl
+              << "  Search stable partitions up to the symmetry among interchangeable FPs (i.e., FPs with the same parameters and workload), checking one partition per orbit." << std::endl
+              << "--verbosity <num>" << std::endl
+              << "  An integer number in [0,9] representing the verbosity level (0 for 'minimum verbosity' and 9 for 'maximum verbosity)." << std::endl
+              << std::endl;
+}
+
+}} // Namespace <unnamed>::detail
+
+
+
+int main(int argc, char* argv[])
+{
+    typedef double real_t;
+
+    try
+    {
+        detail::cli_options_t cli_opts;
+        cli_opts = detail::parse_cli_options(argc, argv);
+        if (cli_opts.help)
+        {
+            detail::usage(argv[0]);
+            return 0;
+        }
+
+        fgt::scenario_t<real_t> scenario;
+        scenario = fgt::make_scenario<real_t>(cli_opts.scenario_file);
+        DCS_DEBUG_TRACE("Scenario: " << scenario);
+        fgt::options_t<real_t> options;
+        options.coalition_formation = cli_opts.coalition_formation;
+        options.coalition_value_division = cli_opts.coalition_value_division;
+        options.compare_stability = cli_opts.compare_stability;
+        options.core_check = cli_opts.core_check;
+        options.collapse_deterministic_replications = cli_opts.collapse_deterministic_replications;
+        options.find_all_best_partitions = cli_opts.find_all_best_partitions;
+        options.game_replay_file = cli_opts.game_log_file;
+        options.max_partition_blocks = cli_opts.max_partition_blocks;
+        options.metrics_file = cli_opts.metrics_file;
+        options.metrics_interval = cli_opts.metrics_interval;
+        options.output_quantile_data_file = cli_opts.output_quantile_data_file;
+        options.output_stats_data_file = cli_opts.output_stats_data_file;
+        options.output_trace_data_file = cli_opts.output_trace_data_file;
+        options.preference_cache_size = cli_opts.preference_cache_size;
+        options.search_best_partition = cli_opts.search_best_partition;
+        options.sim_ci_level = cli_opts.sim_ci_level;
+        options.sim_ci_rel_precision = cli_opts.sim_ci_rel_precision;
+        options.sim_max_num_replications = cli_opts.sim_max_num_replications;
+        options.symmetry_reduction = cli_opts.symmetry_reduction;
+        options.verbosity = cli_opts.verbosity;
+
+        std::cout << "- Scenario: " << scenario << std::endl;
+        std::cout << "- Options: " << options << std::endl;
+
+        // The workload is not simulated, hence random numbers are never drawn
+        fgt::random_number_engine_t rng;
+
+        fgt::experiment_t<real_t> exp;
+        exp.setup(scenario, options, rng);
+        exp.run();
+    }
+    catch (const std::invalid_argument& ia)
+    {
+        dcs::log_error(DCS_LOGGING_AT, ia.what());
+        detail::usage(argv[0]);
+        return 1;
+    }
+    catch (const std::exception& e)
+    {
+        dcs::log_error(DCS_LOGGING_AT, e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,285 @@
+/* vim: set tabstop=4 expandtab shiftwidth=4 softtabstop=4: */
+
+/**
+ * \file src/fog_whatif.cpp
+ *
+ * \brief Evaluate a proposed partition of fog providers for a workload snapshot.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * <hr/>
+ *
+ * Copyright 2017 Marco Guazzone (marco.guazzone@gmail.com)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/cli.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/exception.hpp>
+#include <dcs/fgt/experiment.hpp>
+#include <dcs/fgt/what_if.hpp>
+#include <dcs/logging.hpp>
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace cli = dcs::cli;
+namespace fgt = dcs::fgt;
+
+
+namespace /*<unnamed>*/ { namespace detail {
+
+class cli_options_t;
+
+template <typename CharT, typename CharTraitsT>
+std::basic_ostream<CharT,CharTraitsT>& operator<<(std::basic_ostream<CharT,CharTraitsT>& os, const cli_options_t& opts);
+
+void usage(char const* progname);
+
+
+struct cli_options_t
+{
+    cli_options_t()
+    : help(false),
+      duration(1),
+      optim_relative_tolerance(0),
+      optim_time_limit(-1),
+      service_delay_tolerance(1e-5),
+      solution_store_capacity(fgt::vm_allocation_store_t<double>::default_capacity),
+      verbosity(0)
+    {
+    }
+
+
+    bool help;
+    std::vector<std::vector<std::size_t>> coalitions; ///< The coalitions of the proposed partition, each given as its FPs
+    double duration; ///< The length of the interval coalition values refer to
+    double optim_relative_tolerance; ///< The relative tolerance option to set to the optimizer
+    double optim_time_limit; ///< The time limit option to set to the optimizer
+    std::string scenario_file; ///< The path to the input scenario file
+    double service_delay_tolerance; ///< The relative tolerance to set in the service performance model
+    std::string solution_store_file; ///< The path to the persistent store of solved VM allocation problems
+    std::size_t solution_store_capacity; ///< Maximum number of solutions held by a newly created solution store
+    std::vector<double> svc_arrival_rates; ///< The arrival rate of each service
+    int verbosity; ///< The verbosity level: 0 for 'minimum' and 9 for 'maximum' verbosity level
+}; // cli_options_t
+
+
+/// Parses a comma-separated list of FPs
+std::vector<std::size_t> parse_coalition(const std::string& str)
+{
+    std::vector<std::size_t> fps;
+
+    std::istringstream iss(str);
+    for (std::string tok; std::getline(iss, tok, ','); )
+    {
+        std::istringstream tok_iss(tok);
+        std::size_t fp = 0;
+
+        tok_iss >> fp;
+        DCS_ASSERT(!tok_iss.fail(),
+                   DCS_EXCEPTION_THROW(std::invalid_argument, "Malformed coalition '" + str + "'"));
+
+        fps.push_back(fp);
+    }
+
+    return fps;
+}
+
+cli_options_t parse_cli_options(int argc, char* argv[])
+{
+    cli_options_t opt;
+
+    opt.help = cli::simple::get_option(argv, argv+argc, "--help");
+    if (opt.help)
+    {
+        return opt;
+    }
+    if (cli::simple::get_option(argv, argv+argc, "--coalition"))
+    {
+        for (auto const& str : cli::simple::get_options<std::string>(argv, argv+argc, "--coalition"))
+        {
+            opt.coalitions.push_back(parse_coalition(str));
+        }
+    }
+    opt.duration = cli::simple::get_option<double>(argv, argv+argc, "--duration", 1);
+    opt.optim_relative_tolerance = cli::simple::get_option<double>(argv, argv+argc, "--optim-reltol", 0);
+    opt.optim_time_limit = cli::simple::get_option<double>(argv, argv+argc, "--optim-tilim", -1);
+    if (cli::simple::get_option(argv, argv+argc, "--rate"))
+    {
+        opt.svc_arrival_rates = cli::simple::get_options<double>(argv, argv+argc, "--rate");
+    }
+    opt.scenario_file = cli::simple::get_option<std::string>(argv, argv+argc, "--scenario");
+    opt.service_delay_tolerance = cli::simple::get_option<double>(argv, argv+argc, "--service-delay-tol", 1e-5);
+    opt.solution_store_file = cli::simple::get_option<std::string>(argv, argv+argc, "--solution-store");
+    opt.solution_store_capacity = cli::simple::get_option<std::size_t>(argv, argv+argc, "--solution-store-capacity", fgt::vm_allocation_store_t<double>::default_capacity);
+    opt.verbosity = cli::simple::get_option<short>(argv, argv+argc, "--verbosity", 0);
+    if (opt.verbosity < 0)
+    {
+        opt.verbosity = 0;
+    }
+    else if (opt.verbosity > 9)
+    {
+        opt.verbosity = 9;
+    }
+
+    // Check CLI options
+    if (opt.scenario_file.empty())
+    {
+        DCS_EXCEPTION_THROW( std::invalid_argument, "Scenario file not specified" );
+    }
+    if (opt.duration <= 0)
+    {
+        DCS_EXCEPTION_THROW( std::invalid_argument, "Duration must be positive" );
+    }
+
+    return opt;
+}
+
+template <typename CharT, typename CharTraitsT>
+std::basic_ostream<CharT,CharTraitsT>& operator<<(std::basic_ostream<CharT,CharTraitsT>& os, const cli_options_t& opts)
+{
+    os  << "help: " << opts.help
+        << ", coalitions: [";
+    for (std::size_t c = 0; c < opts.coalitions.size(); ++c)
+    {
+        if (c > 0)
+        {
+            os << ", ";
+        }
+        os << "[";
+        for (std::size_t i = 0; i < opts.coalitions[c].size(); ++i)
+        {
+            if (i > 0)
+            {
+                os << ", ";
+            }
+            os << opts.coalitions[c][i];
+        }
+        os << "]";
+    }
+    os  << "]"
+        << ", duration: " << opts.duration
+        << ", optim-relative-tolerance: " << opts.optim_relative_tolerance
+        << ", optim-time-limit: " << opts.optim_time_limit
+        << ", scenario-file: " << opts.scenario_file
+        << ", service-delay-tolerance: " << opts.service_delay_tolerance
+        << ", solution-store-file: " << opts.solution_store_file
+        << ", solution-store-capacity: " << opts.solution_store_capacity
+        << ", service-arrival-rates: [";
+    for (std::size_t i = 0; i < opts.svc_arrival_rates.size(); ++i)
+    {
+        if (i > 0)
+        {
+            os << ", ";
+        }
+        os << opts.svc_arrival_rates[i];
+    }
+    os  << "]"
+        << ", verbosity: " << opts.verbosity;
+
+    return os;
+}
+
+void usage(char const* progname)
+{
+    std::cerr << "Usage: " << progname << " [options]" << std::endl
+              << "Options:" << std::endl
+              << "--help" << std::endl
+              << "  Show this message." << std::endl
+              << "--coalition <fp>[,<fp>...]" << std::endl
+              << "  A coalition of the proposed partition, given as the comma-separated list of its FPs (numbered from 0). Repeat the option for every coalition; the FPs not in any coalition run alone." << std::endl
+              << "--duration <num>" << std::endl
+              << "  Real number > 0 denoting the length of the interval coalition values refer to." << std::endl
+              << "--optim-reltol <num>" << std::endl
+              << "  Real number in [0,1] denoting the relative tolerance parameter in the optimizer." << std::endl
+              << "--optim-tilim <num>" << std::endl
+              << "  Real positive number denoting the maximum number of seconds to wait for the termination of the optimizer." << std::endl
+              << "--rate <num>" << std::endl
+              << "  Real number >= 0 denoting the arrival rate of a service. Repeat the option for every service, ordered by FP and then by service category (as in the scenario file). A rate must be given for every service." << std::endl
+              << "--scenario <file>" << std::endl
+              << "  The path to the file describing the scenario." << std::endl
+              << "--service-delay-tol <num>" << std::endl
+              << "  Real number in [0,1] denoting the relative tolerance for the delay used in the service performance model." << std::endl
+              << "--solution-store <file>" << std::endl
+              << "  The memory-mapped file where VM allocation problems solved to optimality are stored, so that later evaluations (and simulations) skip them." << std::endl
+              << "--solution-store-capacity <num>" << std::endl
+              << "  Integer number > 0 denoting the maximum number of solutions held by the solution store (only used when the store file is created)." << std::endl
+              << "--verbosity <num>" << std::endl
+              << "  An integer number in [0,9] representing the verbosity level (0 for 'minimum verbosity' and 9 for 'maximum verbosity)." << std::endl
+              << std::endl;
+}
+
+}} // Namespace <unnamed>::detail
+
+
+
+int main(int argc, char* argv[])
+{
+    typedef double real_t;
+
+    try
+    {
+        detail::cli_options_t cli_opts;
+        cli_opts = detail::parse_cli_options(argc, argv);
+        if (cli_opts.help)
+        {
+            detail::usage(argv[0]);
+            return 0;
+        }
+
+        fgt::scenario_t<real_t> scenario;
+        scenario = fgt::make_scenario<real_t>(cli_opts.scenario_file);
+        DCS_DEBUG_TRACE("Scenario: " << scenario);
+        fgt::options_t<real_t> options;
+        options.optim_relative_tolerance = cli_opts.optim_relative_tolerance;
+        options.optim_time_limit = cli_opts.optim_time_limit;
+        options.service_delay_tolerance = cli_opts.service_delay_tolerance;
+        options.solution_store_file = cli_opts.solution_store_file;
+        options.solution_store_capacity = cli_opts.solution_store_capacity;
+        options.verbosity = cli_opts.verbosity;
+
+        if (cli_opts.verbosity > 0)
+        {
+            std::cout << "- Options: " << cli_opts << std::endl;
+        }
+
+        fgt::what_if_evaluator_t<real_t> what_if(scenario, options);
+
+        if (cli_opts.svc_arrival_rates.size() != what_if.num_services())
+        {
+            DCS_EXCEPTION_THROW(std::invalid_argument, "Got " + fgt::stringify(cli_opts.svc_arrival_rates.size()) + " service arrival rates, but the scenario has " + fgt::stringify(what_if.num_services()) + " services");
+        }
+
+        std::cout << what_if(cli_opts.svc_arrival_rates, cli_opts.coalitions, cli_opts.duration) << std::endl;
+    }
+    catch (const std::invalid_argument& ia)
+    {
+        dcs::log_error(DCS_LOGGING_AT, ia.what());
+        detail::usage(argv[0]);
+        return 1;
+    }
+    catch (const std::exception& e)
+    {
+        dcs::log_error(DCS_LOGGING_AT, e.what());
+        return 1;
+    }
+}